@@ -196,6 +196,44 @@ enum class eKeepAliveOption
     on
 };
 
+/*! \brief Enumeration to control how a connection reads data from its socket. */
+enum class eReadMode
+{
+    /*! \brief headerThenBody - Read minAmountToRead bytes then the rest of the message, so
+     *         each message costs at least two reads. */
+    headerThenBody,
+    /*! \brief streaming - Read whatever is available into a large buffer and dispatch every
+     *         complete message it holds before reading again. */
+    streaming,
+    /*! \brief directToBody - Read minAmountToRead bytes then read the rest of the message
+     *         straight into the buffer supplied by the prepare body receive callback. Falls back
+     *         to headerThenBody if no such callback is provided, and for any message whose
+     *         callback declines to supply a buffer. */
+    directToBody
+};
+
+/*! \brief Enumeration to control how a server spreads accepted connections over I/O contexts. */
+enum class eConnectionDistribution
+{
+    /*! \brief roundRobin - Give each new connection the next I/O context in turn. */
+    roundRobin,
+    /*! \brief leastLoaded - Give each new connection the I/O context with the fewest open
+     *         connections from this server. */
+    leastLoaded
+};
+
+/*! \brief Enumeration to control when a connection allocates its buffers. */
+enum class eBufferMode
+{
+    /*! \brief preallocated - Allocate receive and send pool buffers up front and keep them for
+     *         the lifetime of the connection. */
+    preallocated,
+    /*! \brief onDemand - Take buffers from the process wide BufferPool on first use and give
+     *         them back whenever the connection goes idle, so idle connections cost next to no
+     *         buffer memory. */
+    onDemand
+};
+
 /*! \brief Maximum time to wait for TCP socket to connect in milliseconds. */
 enum eDefTcpConnectTimeout : uint32_t
 {
@@ -222,6 +260,17 @@ struct CORE_LIBRARY_DLL_SHARED_API TcpConnSettings
     size_t recvBufferSize{0};
     /*! \brief Keep alive option. */
     eKeepAliveOption keepAliveOption{eKeepAliveOption::off};
+    /*! \brief Socket read mode. */
+    eReadMode readMode{eReadMode::headerThenBody};
+    /*! \brief Maximum number of bytes of queued async messages to gather into a single socket
+     *         write. 0 - implies one write per message. */
+    size_t maxGatherWriteBytes{0};
+    /*! \brief When receive and send pool buffers are allocated. */
+    eBufferMode bufferMode{eBufferMode::preallocated};
+    /*! \brief Largest message body, in bytes, that MessageHandler::PrepareBodyReceive will size
+     *         a buffer for up front in directToBody mode. Larger bodies are read in chunks as
+     *         in headerThenBody mode, so a header cannot make us allocate more than this. */
+    size_t maxDirectBodySize{DEFAULT_LARGE_RESERVED_SIZE};
 
     TcpConnSettings()
     {
@@ -231,7 +280,11 @@ struct CORE_LIBRARY_DLL_SHARED_API TcpConnSettings
                     size_t maxAllowedUnsentAsyncMessages_, size_t sendPoolMsgSize_,
                     uint32_t maxTcpConnectTimeout_, size_t sendBufferSize_ = 0,
                     size_t           recvBufferSize_  = 0,
-                    eKeepAliveOption keepAliveOption_ = eKeepAliveOption::off)
+                    eKeepAliveOption keepAliveOption_ = eKeepAliveOption::off,
+                    eReadMode        readMode_        = eReadMode::headerThenBody,
+                    size_t           maxGatherWriteBytes_ = 0,
+                    eBufferMode      bufferMode_          = eBufferMode::preallocated,
+                    size_t           maxDirectBodySize_   = DEFAULT_LARGE_RESERVED_SIZE)
         : minAmountToRead(minAmountToRead_)
         , sendOption(sendOption_)
         , maxAllowedUnsentAsyncMessages(maxAllowedUnsentAsyncMessages_)
@@ -240,6 +293,10 @@ struct CORE_LIBRARY_DLL_SHARED_API TcpConnSettings
         , sendBufferSize(sendBufferSize_)
         , recvBufferSize(recvBufferSize_)
         , keepAliveOption(keepAliveOption_)
+        , readMode(readMode_)
+        , maxGatherWriteBytes(maxGatherWriteBytes_)
+        , bufferMode(bufferMode_)
+        , maxDirectBodySize(maxDirectBodySize_)
     {
     }
 
@@ -263,6 +320,10 @@ struct CORE_LIBRARY_DLL_SHARED_API TcpConnSettings
         std::swap(sendBufferSize, settings.sendBufferSize);
         std::swap(recvBufferSize, settings.recvBufferSize);
         std::swap(keepAliveOption, settings.keepAliveOption);
+        std::swap(readMode, settings.readMode);
+        std::swap(maxGatherWriteBytes, settings.maxGatherWriteBytes);
+        std::swap(bufferMode, settings.bufferMode);
+        std::swap(maxDirectBodySize, settings.maxDirectBodySize);
         return *this;
     }
 // If noexcept is supported as a functiont type, not a dynamic exception specification since C++17.
@@ -275,6 +336,19 @@ struct CORE_LIBRARY_DLL_SHARED_API TcpConnSettings
 #endif
 };
 
+/*! \brief Async send pool usage counters for a connection. */
+struct SendPoolStatistics
+{
+    /*! \brief Number of async messages copied into a send pool block. */
+    uint64_t hits{0};
+    /*! \brief Number of async messages small enough for a send pool block that fell back to a
+     *         dynamic allocation because no block was free. */
+    uint64_t misses{0};
+    /*! \brief Number of async messages that fell back to a dynamic allocation because
+     *         allocating a block from the shared BufferPool failed, onDemand mode only. */
+    uint64_t allocationFailures{0};
+};
+
 /*! \brief Simple TCP client/server settings structure. */
 struct CORE_LIBRARY_DLL_SHARED_API SimpleTcpSettings
 {
@@ -296,10 +370,12 @@ struct CORE_LIBRARY_DLL_SHARED_API SimpleTcpSettings
                       uint32_t maxTcpConnectTimeout_, size_t memPoolMsgCount_,
                       size_t recvPoolMsgSize_, size_t sendBufferSize_ = 0,
                       size_t           recvBufferSize_  = 0,
-                      eKeepAliveOption keepAliveOption_ = eKeepAliveOption::off)
+                      eKeepAliveOption keepAliveOption_ = eKeepAliveOption::off,
+                      eReadMode        readMode_        = eReadMode::headerThenBody,
+                      size_t           maxGatherWriteBytes_ = 0)
         : connSettings(minAmountToRead_, sendOption_, maxAllowedUnsentAsyncMessages_,
                        sendPoolMsgSize_, maxTcpConnectTimeout_, sendBufferSize_, recvBufferSize_,
-                       keepAliveOption_)
+                       keepAliveOption_, readMode_, maxGatherWriteBytes_)
         , memPoolMsgCount(memPoolMsgCount_)
         , recvPoolMsgSize(recvPoolMsgSize_)
     {
@@ -487,6 +563,10 @@ namespace defs
 using connection_t = std::pair<std::string, uint16_t>;
 /*! \brief Constant defining a null network connection as ("0.0.0.0", 0). */
 extern const connection_t NULL_CONNECTION;
+/*! \brief Typedef to compact integer identifying a TCP connection, cheap to use as a map key. */
+using connection_id_t = uint64_t;
+/*! \brief Constant defining a null connection ID, never assigned to a connection. */
+extern const connection_id_t NULL_CONNECTION_ID;
 /*! \brief Typedef describing shared_ptr to a TcpConnection object. */
 using tcp_conn_ptr_t = std::shared_ptr<tcp::TcpConnection>;
 
@@ -499,6 +579,9 @@ using char_buf_span_t = std::span<char>;
 /*! \brief Typedef to char buffer span - const */
 using char_buf_cspan_t = std::span<const char>;
 
+/*! \brief Typedef to shared immutable char buffer, can be queued on many connections at once. */
+using shared_char_buffer_t = std::shared_ptr<const char_buffer_t>;
+
 /*! \brief Template class to act as a generic wrapper around a received message for a given header
  * type. */
 template <typename Header> struct ReceivedMessage
@@ -560,14 +643,36 @@ using check_bytes_left_to_read_t = std::function<size_t(char_buf_cspan_t)>;
            std::numeric_limits<size_t>::max().*/
 using check_bytes_left_to_read_ex_t =
     std::function<size_t(char_buf_cspan_t, std::string_view, uint16_t)>;
+/*! \brief Typedef to bytes left to reading checking utility function object, extended to take
+           the endpoint details and TCP connection ID. If there is a problem with the message
+           size this should return std::numeric_limits<size_t>::max().*/
+using check_bytes_left_to_read_id_t =
+    std::function<size_t(char_buf_cspan_t, std::string_view, uint16_t, connection_id_t)>;
 /*! \brief Typedef to message received handler function object. */
 using message_received_handler_t = std::function<void(char_buf_cspan_t)>;
 /*! \brief Typedef to extended message received handler function object. */
 using message_received_handler_ex_t =
     std::function<void(char_buf_cspan_t, std::string_view, uint16_t)>;
+/*! \brief Typedef to message received handler function object, extended to take the endpoint
+           details and TCP connection ID. */
+using message_received_handler_id_t =
+    std::function<void(char_buf_cspan_t, std::string_view, uint16_t, connection_id_t)>;
 /*! \brief Typedef for a TCP connection OnClose callback. */
 using on_close_t = std::function<void(const connection_t&)>;
 
+/*! \brief Structure describing where a message body should be read directly from a socket. */
+struct BodyReceiveTarget
+{
+    /*! \brief Buffer the message body is read into, empty for header only messages. */
+    char_buf_span_t body;
+    /*! \brief Callback invoked once body has been completely filled. */
+    std::function<void()> onComplete;
+};
+
+/*! \brief Typedef to function object that, given a complete message header, fills in the target
+           the message body should be read into. Returns false if the header is invalid. */
+using prepare_body_receive_t = std::function<bool(char_buf_cspan_t, BodyReceiveTarget&)>;
+
 } // namespace defs
 
 } // namespace asio
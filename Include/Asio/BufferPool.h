@@ -0,0 +1,194 @@
+// This file is part of CoreLibrary containing useful reusable utility
+// classes.
+//
+// Copyright (C) 2014 to present, Duncan Crutchley
+// Contact <15799155+dac1976@users.noreply.github.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License and GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License
+// and GNU Lesser General Public License along with this program. If
+// not, see <http://www.gnu.org/licenses/>.
+
+/*!
+ * \file BufferPool.h
+ * \brief File containing buffer pool class declaration.
+ */
+
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include "../CoreLibraryDllGlobal.h"
+#include "Platform/PlatformDefines.h"
+
+/*! \brief The core_lib namespace. */
+namespace core_lib
+{
+/*! \brief The asio namespace. */
+namespace asio
+{
+
+/*!
+ * \brief Slab style pool of byte buffers shared between connections.
+ *
+ * Blocks are handed out in power of two size classes from MIN_BLOCK_SIZE up to
+ * MAX_BLOCK_SIZE. Released blocks are kept on a free list per size class so they
+ * can be reused by any connection, up to a limit on the total number of cached
+ * bytes beyond which they are freed. Requests larger than MAX_BLOCK_SIZE are
+ * allocated exactly and freed on release.
+ */
+class CORE_LIBRARY_DLL_SHARED_API BufferPool final
+{
+public:
+    /*! \brief Smallest block size handed out in bytes. */
+    static constexpr size_t MIN_BLOCK_SIZE = 64;
+    /*! \brief Number of cached size classes. */
+    static constexpr size_t NUM_SIZE_CLASSES = 15;
+    /*! \brief Largest cached block size in bytes. */
+    static constexpr size_t MAX_BLOCK_SIZE = MIN_BLOCK_SIZE << (NUM_SIZE_CLASSES - 1);
+    /*! \brief Default limit on bytes held in the free lists. */
+    static constexpr size_t DEFAULT_MAX_CACHED_BYTES = 64 * 1024 * 1024;
+
+    /*! \brief Move-only handle to a block, returns it to its pool on destruction. */
+    class CORE_LIBRARY_DLL_SHARED_API Block final
+    {
+    public:
+        /*! \brief Default constructor, creates an empty handle. */
+        Block() = default;
+        /*! \brief Destructor, returns the block to its pool. */
+        ~Block();
+        /*! \brief Copy constructor deleted. */
+        Block(const Block&) = delete;
+        /*! \brief Copy assignment operator deleted. */
+        Block& operator=(const Block&) = delete;
+        /*! \brief Move constructor. */
+        Block(Block&& block) NO_EXCEPT_;
+        /*! \brief Move assignment operator, returns any block already held. */
+        Block& operator=(Block&& block) NO_EXCEPT_;
+        /*!
+         * \brief Access the block's memory.
+         * \return Pointer to first byte, nullptr if empty.
+         */
+        char* Data() const NO_EXCEPT_;
+        /*!
+         * \brief Usable size of the block.
+         * \return Size in bytes, at least the size requested, 0 if empty.
+         */
+        size_t Size() const NO_EXCEPT_;
+        /*!
+         * \brief Does this handle hold a block.
+         * \return True if empty, false otherwise.
+         */
+        bool Empty() const NO_EXCEPT_;
+        /*! \brief Return the block to its pool leaving this handle empty. */
+        void Reset() NO_EXCEPT_;
+
+    private:
+        friend class BufferPool;
+        /*!
+         * \brief Initialisation constructor.
+         * \param[in] pool - Owning pool.
+         * \param[in] data - Block memory.
+         * \param[in] size - Block size.
+         */
+        Block(BufferPool* pool, char* data, size_t size) NO_EXCEPT_;
+
+    private:
+        /*! \brief Owning pool. */
+        BufferPool* m_pool{nullptr};
+        /*! \brief Block memory. */
+        char* m_data{nullptr};
+        /*! \brief Block size. */
+        size_t m_size{0};
+    };
+
+    /*!
+     * \brief Initialisation constructor.
+     * \param[in] maxCachedBytes - Limit on bytes held in the free lists.
+     */
+    explicit BufferPool(size_t maxCachedBytes = DEFAULT_MAX_CACHED_BYTES);
+    /*! \brief Destructor, frees cached blocks. Blocks must not outlive their pool. */
+    ~BufferPool();
+    /*! \brief Copy constructor deleted.*/
+    BufferPool(const BufferPool&) = delete;
+    /*! \brief Copy assignment operator deleted.*/
+    BufferPool& operator=(const BufferPool&) = delete;
+    /*! \brief Move constructor deleted.*/
+    BufferPool(BufferPool&&) = delete;
+    /*! \brief Move assignment operator deleted.*/
+    BufferPool& operator=(BufferPool&&) = delete;
+    /*!
+     * \brief Process wide pool used by TCP connections, never destroyed.
+     * \return Reference to shared pool.
+     */
+    static BufferPool& Default();
+    /*!
+     * \brief Get a block of at least a given size.
+     * \param[in] size - Minimum size in bytes.
+     * \return Block handle, throws std::bad_alloc on allocation failure.
+     */
+    Block Acquire(size_t size);
+    /*!
+     * \brief Number of bytes held in the free lists.
+     * \return Cached bytes.
+     */
+    size_t CachedBytes() const NO_EXCEPT_;
+    /*!
+     * \brief Number of bytes in blocks currently handed out.
+     * \return Bytes in use.
+     */
+    size_t BytesInUse() const NO_EXCEPT_;
+    /*! \brief Free all cached blocks. */
+    void Trim();
+
+private:
+    /*!
+     * \brief Return a block to the pool.
+     * \param[in] data - Block memory.
+     * \param[in] size - Block size.
+     */
+    void Release(char* data, size_t size) NO_EXCEPT_;
+    /*!
+     * \brief Size class a block size belongs to.
+     * \param[in] size - Block size.
+     * \return Class index, NUM_SIZE_CLASSES if too large to cache.
+     */
+    static size_t SizeClass(size_t size) NO_EXCEPT_;
+
+private:
+    /*! \brief Free list for one size class. */
+    struct FreeList
+    {
+        /*! \brief Access mutex. */
+        std::mutex mutex;
+        /*! \brief Cached blocks (LIFO). */
+        std::vector<char*> blocks;
+    };
+    /*! \brief Limit on bytes held in the free lists. */
+    const size_t m_maxCachedBytes;
+    /*! \brief Bytes held in the free lists. */
+    std::atomic<size_t> m_cachedBytes{0};
+    /*! \brief Bytes in blocks currently handed out. */
+    std::atomic<size_t> m_bytesInUse{0};
+    /*! \brief Free list per size class. */
+    std::array<FreeList, NUM_SIZE_CLASSES> m_freeLists;
+};
+
+} // namespace asio
+} // namespace core_lib
+
+#endif // BUFFERPOOL_H
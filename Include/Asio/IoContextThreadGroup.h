@@ -29,6 +29,15 @@
 
 #include "AsioDefines.h"
 #include "Threads/ThreadGroup.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+#include <boost/throw_exception.hpp>
 
 /*! \brief The core_lib namespace. */
 namespace core_lib
@@ -37,6 +46,58 @@ namespace core_lib
 namespace asio
 {
 
+/*! \brief The I/O context implementation namespace. */
+namespace io_context_impl
+{
+
+class TimerTask;
+
+} // namespace io_context_impl
+
+/*! \brief Enumeration defining how an IoContextThreadGroup shares I/O contexts between threads. */
+enum class eIoContextMode
+{
+    /*! \brief shared - All threads run a single I/O context. */
+    shared,
+    /*! \brief perThread - Each thread runs its own I/O context, so work posted to a context
+     *         always runs on the same thread. */
+    perThread
+};
+
+/*!
+ * \brief Handle to a function scheduled on an IoContextThreadGroup.
+ *
+ * Handles are cheap to copy and may outlive both the scheduled function
+ * and the thread group, in which case they do nothing.
+ */
+class CORE_LIBRARY_DLL_SHARED_API TimerHandle final
+{
+public:
+    /*! \brief Default constructor, creates a handle to nothing. */
+    TimerHandle() = default;
+    /*!
+     * \brief Initialisation constructor.
+     * \param[in] task - Scheduled task.
+     */
+    explicit TimerHandle(std::weak_ptr<io_context_impl::TimerTask> task);
+    /*!
+     * \brief Cancel the scheduled function.
+     *
+     * The function will not be called again, though a call already in
+     * progress on another thread is allowed to finish.
+     */
+    void Cancel();
+    /*!
+     * \brief Is the function still scheduled.
+     * \return True if it has yet to run or is periodic and not cancelled, false otherwise.
+     */
+    bool IsPending() const;
+
+private:
+    /*! \brief Scheduled task. */
+    std::weak_ptr<io_context_impl::TimerTask> m_task;
+};
+
 /*!
  * \brief I/O Context Thread group class.
  *
@@ -44,6 +105,16 @@ namespace asio
  * the I/O context to spread its work load across multiple threads. This class also calls run on the
  * I/O context from each registered thread and also calls stop and joins all threads in its
  * destructor.
+ *
+ * In eIoContextMode::perThread mode each thread instead runs an I/O context of its own. Objects
+ * created on one of these contexts, such as a connection and its strand, then have all their
+ * handlers run on the one thread, avoiding both hand-offs between cores and contention on a
+ * shared reactor. NextIoService hands out the contexts in turn to spread objects across threads.
+ *
+ * Functions can also be scheduled to run after a delay, at a point in time or periodically
+ * using steady_timers on the same I/O context, optionally through a strand, so delayed and
+ * periodic work does not need threads of its own. Functions scheduled this way are run on one
+ * of our threads and should not block.
  */
 class CORE_LIBRARY_DLL_SHARED_API IoContextThreadGroup final
 {
@@ -51,8 +122,12 @@ public:
     /*!
      * \brief Initialising constuctor.
      * \param[in] numThreads - Number of threads to create.
+     * \param[in] mode - Whether threads share one I/O context or run one each.
+     * \param[in] pinThreads - Pin thread N to logical CPU N modulo the number of CPUs.
      */
-    explicit IoContextThreadGroup(unsigned int numThreads = std::thread::hardware_concurrency());
+    explicit IoContextThreadGroup(unsigned int   numThreads = std::thread::hardware_concurrency(),
+                                  eIoContextMode mode       = eIoContextMode::shared,
+                                  bool           pinThreads = false);
     /*! \brief Copy constructor deleted.*/
     IoContextThreadGroup(const IoContextThreadGroup&) = delete;
     /*! \brief Copy assignment operator deleted.*/
@@ -65,29 +140,201 @@ public:
     ~IoContextThreadGroup();
     /*!
      * \brief Get the I/O service.
-     * \return A reference to the I/O service.
+     * \return A reference to the I/O service, the first one in perThread mode.
      */
     asio_compat::io_service_t& IoService();
+    /*!
+     * \brief Get one of the I/O services.
+     * \param[in] index - Index of the service, must be less than NumIoServices().
+     * \return A reference to the I/O service.
+     */
+    asio_compat::io_service_t& IoService(size_t index);
+    /*!
+     * \brief Get the next I/O service in turn.
+     * \return A reference to the I/O service.
+     *
+     * In shared mode this is always the single I/O service.
+     */
+    asio_compat::io_service_t& NextIoService();
+    /*!
+     * \brief Get the number of I/O services.
+     * \return 1 in shared mode, else the number of threads.
+     */
+    size_t NumIoServices() const;
+    /*!
+     * \brief Get the I/O context mode.
+     * \return The mode.
+     */
+    eIoContextMode Mode() const;
     /*!
      * \brief Post a function object to be run by one of our threads.
      * \param[in] function - Function to be run by one of our threads.
      */
     template <typename F> void Post(F&& function)
     {
-        asio_compat::post(m_ioService, std::forward<F>(function));
+        asio_compat::post(NextIoService(), std::forward<F>(function));
+    }
+    /*!
+     * \brief Post a function object to be run by one of our threads after a delay.
+     * \param[in] delay - Time to wait before running the function.
+     * \param[in] function - Function to be run by one of our threads.
+     * \return Handle that can be used to cancel the function.
+     */
+    template <typename Rep, typename Period, typename F>
+    TimerHandle PostAfter(std::chrono::duration<Rep, Period> const& delay, F&& function)
+    {
+        return ScheduleTimer(std::chrono::steady_clock::now() + ToSteadyDuration(delay),
+                             std::chrono::steady_clock::duration::zero(),
+                             std::forward<F>(function),
+                             nullptr);
+    }
+    /*!
+     * \brief Post a function object to be run through a strand after a delay.
+     * \param[in] strand - Strand to run the function through, must outlive the timer.
+     * \param[in] delay - Time to wait before running the function.
+     * \param[in] function - Function to be run by one of our threads.
+     * \return Handle that can be used to cancel the function.
+     */
+    template <typename Rep, typename Period, typename F>
+    TimerHandle PostAfter(asio_compat::strand_t& strand, std::chrono::duration<Rep, Period> const& delay,
+                          F&& function)
+    {
+        return ScheduleTimer(std::chrono::steady_clock::now() + ToSteadyDuration(delay),
+                             std::chrono::steady_clock::duration::zero(),
+                             std::forward<F>(function),
+                             &strand);
+    }
+    /*!
+     * \brief Post a function object to be run by one of our threads at a point in time.
+     * \param[in] when - Time at which to run the function.
+     * \param[in] function - Function to be run by one of our threads.
+     * \return Handle that can be used to cancel the function.
+     */
+    template <typename F> TimerHandle PostAt(std::chrono::steady_clock::time_point when, F&& function)
+    {
+        return ScheduleTimer(
+            when, std::chrono::steady_clock::duration::zero(), std::forward<F>(function), nullptr);
+    }
+    /*!
+     * \brief Post a function object to be run through a strand at a point in time.
+     * \param[in] strand - Strand to run the function through, must outlive the timer.
+     * \param[in] when - Time at which to run the function.
+     * \param[in] function - Function to be run by one of our threads.
+     * \return Handle that can be used to cancel the function.
+     */
+    template <typename F>
+    TimerHandle PostAt(asio_compat::strand_t& strand, std::chrono::steady_clock::time_point when,
+                       F&& function)
+    {
+        return ScheduleTimer(
+            when, std::chrono::steady_clock::duration::zero(), std::forward<F>(function), &strand);
+    }
+    /*!
+     * \brief Post a function object to be run by one of our threads periodically.
+     * \param[in] period - Time between calls, the first call is one period from now.
+     * \param[in] function - Function to be run by one of our threads.
+     * \return Handle that can be used to cancel the function.
+     *
+     * Calls are made at a fixed rate. If a call overruns, the calls it
+     * missed are skipped rather than made back to back. Throws
+     * std::invalid_argument if the period is not positive.
+     */
+    template <typename Rep, typename Period, typename F>
+    TimerHandle PostEvery(std::chrono::duration<Rep, Period> const& period, F&& function)
+    {
+        const auto steadyPeriod = ToSteadyDuration(period);
+
+        if (steadyPeriod <= std::chrono::steady_clock::duration::zero())
+        {
+            BOOST_THROW_EXCEPTION(std::invalid_argument("incorrect timer period"));
+        }
+
+        return ScheduleTimer(std::chrono::steady_clock::now() + steadyPeriod,
+                             steadyPeriod,
+                             std::forward<F>(function),
+                             nullptr);
     }
+    /*!
+     * \brief Post a function object to be run through a strand periodically.
+     * \param[in] strand - Strand to run the function through, must outlive the timer.
+     * \param[in] period - Time between calls, the first call is one period from now.
+     * \param[in] function - Function to be run by one of our threads.
+     * \return Handle that can be used to cancel the function.
+     *
+     * As PostEvery without a strand.
+     */
+    template <typename Rep, typename Period, typename F>
+    TimerHandle PostEvery(asio_compat::strand_t& strand, std::chrono::duration<Rep, Period> const& period,
+                          F&& function)
+    {
+        const auto steadyPeriod = ToSteadyDuration(period);
+
+        if (steadyPeriod <= std::chrono::steady_clock::duration::zero())
+        {
+            BOOST_THROW_EXCEPTION(std::invalid_argument("incorrect timer period"));
+        }
+
+        return ScheduleTimer(std::chrono::steady_clock::now() + steadyPeriod,
+                             steadyPeriod,
+                             std::forward<F>(function),
+                             &strand);
+    }
+    /*!
+     * \brief Number of scheduled functions yet to complete.
+     * \return Number of pending one-shot and periodic functions.
+     */
+    size_t PendingTimers() const;
     /*!
      * \brief Stop function optional to call, as called in destructor anyway.
      */
     void Stop();
 
 private:
-    /*! \brief Boost ASIO I/O service.*/
-    asio_compat::io_service_t m_ioService;
-    /*! \brief Boost ASIO I/O service work object.*/
-    asio_compat::work_guard_t m_ioWork;
+    friend class io_context_impl::TimerTask;
+
+    /*!
+     * \brief Convert a duration to the steady clock's duration, rounding up.
+     * \param[in] duration - Duration to convert.
+     * \return Converted duration.
+     */
+    template <typename Rep, typename Period>
+    static std::chrono::steady_clock::duration
+    ToSteadyDuration(std::chrono::duration<Rep, Period> const& duration)
+    {
+        return std::chrono::ceil<std::chrono::steady_clock::duration>(duration);
+    }
+    /*!
+     * \brief Create and start a timer.
+     * \param[in] when - Time of first call.
+     * \param[in] period - Time between calls, zero for a one-shot timer.
+     * \param[in] function - Function to call.
+     * \param[in] strand - Optional strand to call the function through.
+     * \return Handle to the timer.
+     */
+    TimerHandle ScheduleTimer(std::chrono::steady_clock::time_point when,
+                              std::chrono::steady_clock::duration period,
+                              std::function<void()> function, asio_compat::strand_t* strand);
+    /*!
+     * \brief Release a timer that has finished or been cancelled.
+     * \param[in] task - Timer to release.
+     */
+    void RemoveTimer(std::shared_ptr<io_context_impl::TimerTask> const& task);
+
+private:
+    /*! \brief I/O context mode.*/
+    eIoContextMode m_mode;
+    /*! \brief Boost ASIO I/O services, one per thread in perThread mode.*/
+    std::vector<std::unique_ptr<asio_compat::io_service_t>> m_ioServices;
+    /*! \brief Boost ASIO I/O service work objects.*/
+    std::vector<asio_compat::work_guard_t> m_ioWorks;
+    /*! \brief Round robin counter for NextIoService.*/
+    std::atomic<size_t> m_nextIoService{0};
     /*! \brief Our thread group.*/
     threads::ThreadGroup m_threadGroup;
+    /*! \brief Mutex protecting the set of timers.*/
+    mutable std::mutex m_timersMutex;
+    /*! \brief Scheduled timers, declared last so they are destroyed before the I/O service.*/
+    std::unordered_set<std::shared_ptr<io_context_impl::TimerTask>> m_timers;
 };
 
 } // namespace asio
@@ -33,6 +33,7 @@
 #include <cstring>
 #include <cassert>
 #include <type_traits>
+#include <mutex>
 #include "AsioDefines.h"
 #include "Serialization/SerializeToVector.h"
 #include "Threads/MutexHelpers.hpp"
@@ -251,6 +252,8 @@ public:
      * \param[in] magicString - Magic string used to identify the start of valid messages.
      * \param[in] memPoolMsgCount - (Optional) Pool size as number of messages.
      * \param[in] defaultMsgSize - (Optional) Initial size of a message in the pool.
+     * \param[in] maxDirectBodySize - (Optional) Largest body PrepareBodyReceive sizes a buffer
+     * for up front.
      *
      * NOTE: We deliberately pass string by value and use std::move to make the copy.
      *       In C++11 onwards this is more efficient.
@@ -263,7 +266,8 @@ public:
     MessageHandler(const defs::default_message_dispatcher_t& messageDispatcher,
                  std::string_view magicString,
 				 size_t memPoolMsgCount = 0,
-                 size_t defaultMsgSize = defs::RECV_POOL_DEFAULT_MSG_SIZE);
+                 size_t defaultMsgSize = defs::RECV_POOL_DEFAULT_MSG_SIZE,
+                 size_t maxDirectBodySize = tcp::DEFAULT_LARGE_RESERVED_SIZE);
     /*! \brief Default destructor. */
     ~MessageHandler() = default;
     /*! \brief Deleted copy constructor. */
@@ -282,6 +286,19 @@ public:
      * \param[in] message - A received message buffer.
      */
     void MessageReceivedHandler(defs::char_buf_cspan_t message) const;
+    /*!
+     * \brief Prepare body receive method.
+     * \param[in] header - A received message header.
+     * \param[out] target - Target the message body should be read directly into.
+     * \return True if the header is valid and its body no larger than maxDirectBodySize, false
+     * otherwise.
+     *
+     * Acquires the pool message up front so the connection can read the body straight into
+     * it, the message is dispatched once target.onComplete is called. Larger bodies are left
+     * for the connection to read in chunks, so a peer cannot make us allocate memory just by
+     * claiming a huge message length.
+     */
+    bool PrepareBodyReceive(defs::char_buf_cspan_t header, defs::BodyReceiveTarget& target) const;
 
 private:
     /*!
@@ -303,6 +320,8 @@ private:
 #endif
 	/*! \brief The message pool. */
     std::shared_ptr<msg_pool_t> m_msgPool;
+    /*! \brief Largest body PrepareBodyReceive sizes a buffer for up front. */
+    size_t m_maxDirectBodySize{tcp::DEFAULT_LARGE_RESERVED_SIZE};
 };
 
 /*!
@@ -452,11 +471,23 @@ template <> struct ArchiveTypeToEnum<serialize::archives::out_msgpack_t>
     }
 };
 
+/*! \brief Enumeration controlling where a MessageBuilder keeps its working buffers. */
+enum class eBuilderMode
+{
+    /*! \brief Buffers belong to the builder, calls to Build must be serialised by the caller. */
+    builderBuffers,
+    /*! \brief Buffers belong to the calling thread, Build may be called concurrently. */
+    perThreadBuffers
+};
+
 /*!
  * \brief Default message builder class.
  *
  * This is used in the case of the simple network classes: SimpleTcpClient, SimpleTcpServer etc. It
  * is used to build messages to be sent that require a MessageHeader followed by a message body.
+ *
+ * In eBuilderMode::perThreadBuffers mode the returned buffer is owned by the calling thread and
+ * stays valid until that thread next calls Build on any builder in this mode.
  */
 class CORE_LIBRARY_DLL_SHARED_API MessageBuilder final
 {
@@ -473,6 +504,12 @@ public:
      * \param[in] magicString - Magic stirng used to identify start of valid message.
      */
     explicit MessageBuilder(std::string_view magicString);
+    /*!
+     * \brief Initialisatn constructor.
+     * \param[in] magicString - Magic stirng used to identify start of valid message.
+     * \param[in] mode - Where the builder keeps its working buffers.
+     */
+    MessageBuilder(std::string_view magicString, eBuilderMode mode);
     /*! \brief Default destructor. */
     ~MessageBuilder() = default;
     /*! \brief Default copy constructor. */
@@ -532,34 +569,44 @@ public:
     defs::char_buf_cspan_t Build(const T& message, int32_t messageId,
                                  const defs::connection_t& responseAddress) const
     {
-        // Serialise message.
-        serialize::ToCharVector<T, A>(message, m_serialisationBuffer);
+        auto& messageBuffer = MessageBuffer();
+
+        // Reserve space for the header and serialise the message straight in after it.
+        messageBuffer.resize(sizeof(defs::MessageHeader));
+        serialize::AppendToCharVector<T, A>(message, messageBuffer);
 
-        if (m_serialisationBuffer.empty())
+        const auto messageLength = messageBuffer.size() - sizeof(defs::MessageHeader);
+
+        if (messageLength == 0)
         {
             BOOST_THROW_EXCEPTION(std::runtime_error("cannot serialize message"));
         }
 
-        // Resize message buffer.
-        auto totalLength = sizeof(defs::MessageHeader) + m_serialisationBuffer.size();
-        m_messageBuffer.resize(totalLength);
-
-        // Fill header.
+        // Fill header now the body length is known.
         const defs::eArchiveType archiveType = ArchiveTypeToEnum<A>().Enumerate();
         defs::MessageHeader*     header =
-            reinterpret_cast<defs::MessageHeader*>(m_messageBuffer.data());
+            reinterpret_cast<defs::MessageHeader*>(messageBuffer.data());
         FillHeader(m_magicString,
                    archiveType,
                    messageId,
                    responseAddress,
-                   static_cast<uint32_t>(m_serialisationBuffer.size()),
+                   static_cast<uint32_t>(messageLength),
                    *header);
 
-        auto writePosIter = std::next(m_messageBuffer.begin(), sizeof(defs::MessageHeader));
-        std::copy(m_serialisationBuffer.begin(), m_serialisationBuffer.end(), writePosIter);
-
-        return m_messageBuffer;
+        return messageBuffer;
     }
+    /*!
+     * \brief Can Build be called concurrently from multiple threads?
+     * \return True if in eBuilderMode::perThreadBuffers mode, false otherwise.
+     */
+    bool ThreadSafe() const;
+
+private:
+    /*!
+     * \brief Get the buffer the message is built in.
+     * \return Reference to message buffer for this builder or calling thread.
+     */
+    defs::char_buffer_t& MessageBuffer() const;
 
 private:
 #ifdef USE_DEFAULT_CONSTRUCTOR_
@@ -569,10 +616,64 @@ private:
     /*! \brief Magic string. */
     std::string m_magicString{static_cast<char const*>(defs::DEFAULT_MAGIC_STRING)};
 #endif
+    /*! \brief Where the working buffers are kept. */
+    eBuilderMode m_mode{eBuilderMode::builderBuffers};
+    /*! \brief Message buffer, unused in per thread mode. */
     mutable defs::char_buffer_t m_messageBuffer;
-    mutable defs::char_buffer_t m_serialisationBuffer;
 };
 
+/*! \brief Detects whether a message builder type provides a ThreadSafe() query. */
+template <typename MsgBldr, typename = void> struct HasThreadSafeQuery : std::false_type
+{
+};
+
+/*! \brief Specialisation for message builder types that do provide a ThreadSafe() query. */
+template <typename MsgBldr>
+struct HasThreadSafeQuery<MsgBldr, std::void_t<decltype(std::declval<MsgBldr const&>().ThreadSafe())>>
+    : std::true_type
+{
+};
+
+/*!
+ * \brief Can a message builder's Build methods be called concurrently?
+ * \param[in] messageBuilder - A message builder object of type MsgBldr.
+ * \return True if the builder reports itself thread safe, false otherwise.
+ *
+ * Builder types without a ThreadSafe() method are assumed not to be thread safe.
+ */
+template <typename MsgBldr> bool IsThreadSafeBuilder(const MsgBldr& messageBuilder)
+{
+    if constexpr (HasThreadSafeQuery<MsgBldr>::value)
+    {
+        return messageBuilder.ThreadSafe();
+    }
+    else
+    {
+        return false;
+    }
+}
+
+/*!
+ * \brief Lock a typed sender's send mutex for an async send, unless its builder is thread safe.
+ * \param[in] messageBuilder - A message builder object of type MsgBldr.
+ * \param[in] sendMutex - The typed sender's send mutex.
+ * \return Lock owning sendMutex, or a deferred lock for a thread safe builder.
+ *
+ * Used by TcpTypedClient and TcpTypedServer. Async sends copy the built message before returning
+ * so with a thread safe builder they can run concurrently. Sync sends always take the lock as
+ * they write to the socket directly.
+ */
+template <typename MsgBldr>
+std::unique_lock<std::mutex> AsyncSendLock(const MsgBldr& messageBuilder, std::mutex& sendMutex)
+{
+    if (IsThreadSafeBuilder(messageBuilder))
+    {
+        return std::unique_lock<std::mutex>(sendMutex, std::defer_lock);
+    }
+
+    return std::unique_lock<std::mutex>(sendMutex);
+}
+
 /*!
  * \brief Message builder wrapper function for header only messages.
  * \param[in] messageId - Unique message ID to insert into message header.
@@ -369,8 +369,10 @@ public:
     bool IsConnected(const defs::connection_t& client) const;
 
 private:
-    /*! \brief Default message builder object of type asio::messages::MessageBuilder. */
-    messages::MessageBuilder m_messageBuilder{};
+    /*! \brief Default message builder object of type asio::messages::MessageBuilder, using per
+     *         thread buffers so async sends from many threads do not serialise. */
+    messages::MessageBuilder m_messageBuilder{static_cast<char const*>(defs::DEFAULT_MAGIC_STRING),
+                                              messages::eBuilderMode::perThreadBuffers};
     /*! \brief Default message handler object of type asio::messages::MessageHandler. */
     messages::MessageHandler m_messageHandler;
     /*! \brief Our actual typed TCP server object. */
@@ -83,6 +83,8 @@ public:
      * \param[in] checkBytesLeftToReadEx - Function object capable of decoding the message and
      * computing how many bytes are left until a complete message. Extended to take endpoint
      * details.
+     * \param[in] prepareBodyReceive - Function object supplying the buffer a message body is read
+     * directly into, only used when settings.readMode is eReadMode::directToBody.
      *
      * Typically use this constructor when managing a bool of threads using an instance of
      * IoContextThreadGroup in your application to manage a pool of std::threads.
@@ -95,7 +97,8 @@ public:
             defs::message_received_handler_t const& messageReceivedHandler,
             TcpConnSettings const& settings = {},
             defs::message_received_handler_ex_t const& messageReceivedHandlerEx = {},
-            defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx = {});
+            defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx = {},
+            defs::prepare_body_receive_t const&        prepareBodyReceive     = {});
     /*!
      * \brief Initialisation constructor.
      * \param[in] server - Connection object describing target server's address and port.
@@ -116,6 +119,8 @@ public:
      * \param[in] checkBytesLeftToReadEx - Function object capable of decoding the message and
      * computing how many bytes are left until a complete message. Extended to take endpoint
      * details.
+     * \param[in] prepareBodyReceive - Function object supplying the buffer a message body is read
+     * directly into, only used when settings.readMode is eReadMode::directToBody.
      *
      * This constructor does not require an external IO service to run instead it creates
      * its own IO service object along with its own thread. For very simple cases this
@@ -127,7 +132,8 @@ public:
             defs::message_received_handler_t const& messageReceivedHandler,
             TcpConnSettings const& settings = {},
             defs::message_received_handler_ex_t const& messageReceivedHandlerEx = {},
-            defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx = {});
+            defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx = {},
+            defs::prepare_body_receive_t const&        prepareBodyReceive     = {});
     /*! \brief Default destructor. */
     ~TcpClient();
     /*!
@@ -184,6 +190,11 @@ public:
      * \return Number of nsent messages
      */
     size_t NumberOfUnsentAsyncMessages() const;
+    /*!
+     * \brief Get async send pool usage counters.
+     * \return Send pool hits and misses, zero if not connected.
+     */
+    SendPoolStatistics SendPoolStats() const;
 
 private:
     /*! \brief Create conenction to server. */
@@ -204,6 +215,8 @@ private:
     defs::message_received_handler_t m_messageReceivedHandler;
     /*! \brief Message received handler extended callback. */
     defs::message_received_handler_ex_t m_messageReceivedHandlerEx;
+    /*! \brief Prepare body receive callback. */
+    defs::prepare_body_receive_t m_prepareBodyReceive;
     /*! \brief Structure holding socket connection options and behavioural settings. */
     TcpConnSettings m_settings;
     /*! \brief TCP connections object. */
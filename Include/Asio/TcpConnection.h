@@ -28,13 +28,14 @@
 #define TCPCONNECTION
 
 #include "AsioDefines.h"
+#include "BufferPool.h"
 #include "Threads/SyncEvent.h"
 #include <mutex>
 #include <memory>
 #include <deque>
 #include <utility>
 #include <atomic>
-#include <array>
+#include <vector>
 
 /*! \brief The core_lib namespace. */
 namespace core_lib
@@ -57,7 +58,7 @@ class TcpConnections;
 class CORE_LIBRARY_DLL_SHARED_API TcpConnection final
     : public std::enable_shared_from_this<TcpConnection>
 {
-    using msg_ptr_t  = std::shared_ptr<defs::char_buffer_t>; // dynamic-only
+    using msg_ptr_t  = defs::shared_char_buffer_t;          // dynamic or shared broadcast
     using msg_pool_t = std::vector<defs::char_buffer_t>;     // pool blocks (fixed-size)
 
     struct PendingWrite
@@ -65,13 +66,15 @@ class CORE_LIBRARY_DLL_SHARED_API TcpConnection final
         enum class eKind : uint8_t
         {
             pool,
-            dynamic
+            dynamic,
+            block
         };
 
-        eKind     kind{eKind::dynamic};
-        size_t    len{0};
-        size_t    poolIndex{0};
-        msg_ptr_t dyn; // valid only when kind==dynamic
+        eKind             kind{eKind::dynamic};
+        size_t            len{0};
+        size_t            poolIndex{0};
+        msg_ptr_t         dyn;   // valid only when kind==dynamic
+        BufferPool::Block block; // valid only when kind==block
     };
 
     struct EnqueuePreparedSendHandler
@@ -115,6 +118,12 @@ public:
      * \param[in] checkBytesLeftToReadEx - Function object capable of decoding the message and
      * computing how many bytes are left until a complete message. Extended to take endpoint
      * details.
+     * \param[in] prepareBodyReceive - Function object supplying the buffer a message body is read
+     * directly into, only used when settings.readMode is eReadMode::directToBody.
+     * \param[in] messageReceivedHandlerId - Message received handler also passed the connection's
+     * ID, takes precedence over messageReceivedHandlerEx and messageReceivedHandler.
+     * \param[in] checkBytesLeftToReadId - Check bytes left to read callback also passed the
+     * connection's ID, takes precedence over checkBytesLeftToReadEx and checkBytesLeftToRead.
      */
     TcpConnection(asio_compat::io_service_t&                 ioService,
                 std::shared_ptr<TcpConnections> const&     connections,
@@ -122,7 +131,10 @@ public:
                 defs::message_received_handler_t const&    messageReceivedHandler,
                 TcpConnSettings const&                     settings                 = {},
                 defs::message_received_handler_ex_t const& messageReceivedHandlerEx = {},
-                defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx   = {});
+                defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx   = {},
+                defs::prepare_body_receive_t const&        prepareBodyReceive       = {},
+                defs::message_received_handler_id_t const& messageReceivedHandlerId = {},
+                defs::check_bytes_left_to_read_id_t const& checkBytesLeftToReadId   = {});
     /*! \brief Default virtual destructor. */
     ~TcpConnection() = default;
     /*!
@@ -154,6 +166,16 @@ public:
      * messages and return false.
      */
     bool SendMessageAsync(defs::char_buf_cspan_t message);
+    /*!
+     * \brief Send an asynchronous message sharing ownership of an immutable buffer.
+     * \param[in] message - Shared message buffer to send.
+     * \return Returns true if posted async message, retruns false if failed to post message.
+     *
+     * No copy of the message is made so the same buffer can be queued on many connections,
+     * it is released once the last connection has finished writing it. The buffer must not
+     * be modified after calling this method.
+     */
+    bool SendMessageAsync(defs::shared_char_buffer_t const& message);
     /*!
      * \brief Send a synchronous message.
      * \param[in] message - Message buffer to send.
@@ -165,6 +187,21 @@ public:
      * \return Number of unsent messages
      */
     size_t NumberOfUnsentAsyncMessages() const;
+    /*!
+     * \brief Get async send pool usage counters.
+     * \return Send pool hits, misses and allocation failures since the connection was created.
+     */
+    SendPoolStatistics SendPoolStats() const;
+    /*!
+     * \brief Get this connection's unique ID.
+     * \return Connection ID, unique for the lifetime of the process.
+     */
+    defs::connection_id_t Id() const NO_EXCEPT_;
+    /*!
+     * \brief Get the remote end's connection details.
+     * \return Remote end point, captured once when the connection was established.
+     */
+    defs::connection_t RemoteEndPoint() const;
 
 private:
     /*!
@@ -191,6 +228,65 @@ private:
      */
     void ReadComplete(const boost_sys::error_code& error, size_t bytesReceived,
                       size_t bytesExpected);
+    /*! \brief Asynchronously read whatever is available into the streaming buffer. */
+    void AsyncReadSomeFromSocket();
+    /*!
+     * \brief Streaming read completion handler.
+     * \param[in] error - Error flag if fault occurred.
+     * \param[in] bytesReceived - Number of bytes received.
+     */
+    void ReadSomeComplete(const boost_sys::error_code& error, size_t bytesReceived);
+    /*! \brief Dispatch every complete message currently held in the streaming buffer. */
+    void DispatchBufferedMessages();
+    /*! \brief Asynchronously read a message header in direct to body read mode. */
+    void AsyncReadHeaderFromSocket();
+    /*!
+     * \brief Header read completion handler in direct to body read mode.
+     * \param[in] error - Error flag if fault occurred.
+     * \param[in] bytesReceived - Number of bytes received.
+     */
+    void HeaderReadComplete(const boost_sys::error_code& error, size_t bytesReceived);
+    /*! \brief Asynchronously read a message body straight into its target buffer. */
+    void AsyncReadBodyFromSocket();
+    /*!
+     * \brief Body read completion handler in direct to body read mode.
+     * \param[in] error - Error flag if fault occurred.
+     * \param[in] bytesReceived - Number of bytes received.
+     */
+    void BodyReadComplete(const boost_sys::error_code& error, size_t bytesReceived);
+    /*! \brief Complete the current body receive target and start reading the next header. */
+    void CompleteBodyReceive();
+    /*!
+     * \brief Call whichever bytes left to read callback is defined.
+     * \param[in] message - Message bytes received so far.
+     * \return Number of bytes left to read.
+     */
+    size_t CheckBytesLeftToRead(defs::char_buf_cspan_t message);
+    /*!
+     * \brief Call whichever message received handler is defined.
+     * \param[in] message - Complete message.
+     */
+    void MessageReceived(defs::char_buf_cspan_t message);
+    /*!
+     * \brief Get the receive buffer, taking a larger block from the buffer pool if needed.
+     * \param[in] size - Minimum size required in bytes.
+     * \return Pointer to receive buffer, throws std::bad_alloc on allocation failure.
+     */
+    char* ReceiveBuffer(size_t size);
+    /*!
+     * \brief Is there no more data waiting to be read from the socket.
+     * \return True if idle, false otherwise.
+     */
+    bool SocketIdle();
+    /*! \brief Give back receive buffers not needed while waiting for the next message. */
+    void ReleaseIdleBuffers();
+    /*! \brief Wait for the socket to become readable before taking a streaming read buffer. */
+    void AsyncWaitReadable();
+    /*!
+     * \brief Socket readable callback.
+     * \param[in] error - Error state code.
+     */
+    void ReadableComplete(const boost_sys::error_code& error);
     /*! \brief Decrement unsent async message counter (strand-only). */
     void DecrementUnsentAsyncCounterOnStrand();
     /*! \brief Initialise message pool. */
@@ -200,7 +296,7 @@ private:
      * We intentionally prepare pool/dynamic buffers *before* posting to the strand
      * (to avoid per-send allocations when the pool is enabled). That means the pool
      * free-list can be accessed from arbitrary caller threads as well as the strand,
-     * so it must be protected with a mutex.
+     * so it is a lock-free stack whose head carries an ABA tag.
      */
     /*!
      * \brief Enqueue a prepared send on the strand.
@@ -219,6 +315,19 @@ private:
      * \param[in] w - The pending write object.
      */
     void DoAsyncWriteOnStrand(PendingWrite const& w);
+    /*!
+     * \brief Do a single gathered async write of queued pending writes on strand.
+     *
+     * Covers as many queued pending writes as fit in settings.maxGatherWriteBytes, the first
+     * pending write is always included even if it is larger.
+     */
+    void DoAsyncGatherWriteOnStrand();
+    /*!
+     * \brief Get pending write's data buffer.
+     * \param[in] w - The pending write object.
+     * \return Buffer pointing at the pending write's data.
+     */
+    boost_asio::const_buffer PendingWriteBuffer(PendingWrite const& w) const;
     /*!
      * \brief Write completion handler.
      * \param[in] error - Error state code.
@@ -253,11 +362,22 @@ private:
      * return Current connection ID value.
      */
     size_t CurrentConnectionId() const NO_EXCEPT_;
+    /*!
+     * \brief Reserve space for one more unsent async message (thread-safe).
+     * \return True if reserved, false if at the unsent async message limit.
+     */
+    bool ReserveUnsentAsyncMessage();
     /*!
      * \brief Acquire the next pending write object for async send
      * \param[in] message - Message to send.
      */
     bool AcquirePendingWrite(defs::char_buf_cspan_t message, PendingWrite& w);
+    /*!
+     * \brief Post a prepared pending write to the strand.
+     * \param[in] w - Prepared pending write.
+     * \return True if posted, false otherwise.
+     */
+    bool PostPreparedSend(PendingWrite&& w);
 
 private:
     /*! \brief Access mutex for thread safety. */
@@ -280,30 +400,56 @@ private:
     defs::message_received_handler_t m_messageReceivedHandler;
     /*! \brief Message received handler extended callback. */
     defs::message_received_handler_ex_t m_messageReceivedHandlerEx;
+    /*! \brief Check bytes left to read callback taking the connection ID. */
+    defs::check_bytes_left_to_read_id_t m_checkBytesLeftToReadId;
+    /*! \brief Message received handler callback taking the connection ID. */
+    defs::message_received_handler_id_t m_messageReceivedHandlerId;
+    /*! \brief Prepare body receive callback. */
+    defs::prepare_body_receive_t m_prepareBodyReceive;
+    /*! \brief Target for the message body currently being read (strand-only). */
+    defs::BodyReceiveTarget m_bodyTarget;
     /*! \brief Structure holding socket connection options and behavioural settings. */
     TcpConnSettings m_settings;
-    /*! \brief Socket receive buffer. */
-    std::array<char, DEFAULT_SMALL_RESERVED_SIZE> m_receiveBuffer;
-    /*! \brief Message buffer. */
+    /*! \brief Socket receive buffer, taken from the process wide buffer pool. */
+    BufferPool::Block m_receiveBuffer;
+    /*! \brief Message buffer, also used as the read buffer in streaming read mode. */
     defs::char_buffer_t m_messageBuffer;
+    /*! \brief Offset of first unprocessed byte in streaming read mode (strand-only). */
+    size_t m_streamReadPos{0};
+    /*! \brief Offset one past the last received byte in streaming read mode (strand-only). */
+    size_t m_streamWritePos{0};
     /*! \brief Unsent async message reservation counter (thread-safe). */
     std::atomic_size_t m_numUnsentAsyncMessages{0};
-    /*! \brief Positions in message pool (LIFO). Protected by m_poolMutex. */
-    std::vector<size_t> m_availablePoolIndices;
-    /*! \brief Mutex protecting pool free-list (m_availablePoolIndices). */
-    mutable std::mutex m_poolMutex;
+    /*! \brief Next free pool index after each free pool index (lock-free free-list links). */
+    std::unique_ptr<std::atomic<uint32_t>[]> m_poolNextFree;
+    /*! \brief Free-list head, ABA tag in the upper 32 bits and pool index in the lower 32. */
+    std::atomic<uint64_t> m_poolFreeHead{UINT32_MAX};
+    /*! \brief Number of async messages copied into a send pool block. */
+    std::atomic<uint64_t> m_poolHits{0};
+    /*! \brief Number of pool sized async messages that found no free send pool block. */
+    std::atomic<uint64_t> m_poolMisses{0};
+    /*! \brief Number of async messages whose shared BufferPool block allocation failed. */
+    std::atomic<uint64_t> m_poolAllocFailures{0};
     /*! \brief Async message pool blocks (fixed-size, size==sendPoolMsgSize). */
     msg_pool_t m_msgPool;
     /*! \brief Pending async writes (strand-only). */
     std::deque<PendingWrite> m_pendingWrites;
     /*! \brief True if an async_write is currently in flight (strand-only). */
     bool m_writeInProgress{false};
+    /*! \brief Number of pending writes covered by the in flight async_write (strand-only). */
+    size_t m_numWritesInFlight{0};
+    /*! \brief Reusable buffer sequence for gathered writes (strand-only). */
+    std::vector<boost_asio::const_buffer> m_gatherBuffers;
     /*! \brief Next Connection counter. */
     size_t m_nextConnectionId{0};
     /*! \brief Current  Connection counter */
     size_t m_currentConnectionId{0};
     /*! \brief Connection end point details. */
     defs::connection_t m_endPoint;
+    /*! \brief Cached remote end point details passed to extended callbacks. */
+    defs::connection_t m_remoteEndPoint;
+    /*! \brief Unique connection ID. */
+    const defs::connection_id_t m_id;
     /*! \brief Atomic flag to make sure we only remove ourselves once. */
     std::atomic_bool m_removed{false};
     /*! \brief TCP socket. */
@@ -28,8 +28,11 @@
 #define TCPCONNECTIONS
 
 #include "AsioDefines.h"
-#include <map>
+#include <array>
+#include <unordered_map>
+#include <vector>
 #include <mutex>
+#include <shared_mutex>
 
 /*! \brief The core_lib namespace. */
 namespace core_lib
@@ -48,6 +51,11 @@ class TcpConnection;
  * \brief TCP connections class to manage the TcpConnection objects.
  *
  * This class is the one of the fundamental building blocks for the other TCP networking classes.
+ *
+ * Connections are held in a number of shards, each a hash map guarded by its own shared mutex,
+ * so concurrent lookups when sending do not serialise on a single lock. Adding and removing
+ * connections is comparatively rare and is serialised by a separate mutex that also guards an
+ * index from connection object to its endpoint.
  */
 class CORE_LIBRARY_DLL_SHARED_API TcpConnections final
 {
@@ -111,8 +119,18 @@ public:
     /*!
      * \brief Send an asynchronous message to all connections.
      * \param[in] message - Message buffer to send.
+     *
+     * When there is more than one connection the message is copied once into a shared buffer
+     * that every connection then writes from.
      */
     void SendMessageToAll(defs::char_buf_cspan_t message) const;
+    /*!
+     * \brief Send an asynchronous message to all connections without copying it.
+     * \param[in] message - Shared message buffer to send.
+     *
+     * The buffer is released once the last connection has finished writing it.
+     */
+    void SendMessageToAll(defs::shared_char_buffer_t const& message) const;
     /*!
      * \brief Get the connection details for one of the remote connections.
      * \param[in] remoteEnd - Remote end's connection details.
@@ -127,6 +145,12 @@ public:
      * \return Number of unsent messages
      */
     size_t NumberOfUnsentAsyncMessages(const defs::connection_t& target) const;
+    /*!
+     * \brief Get async send pool usage counters.
+     * \param[in] target - Target connection details.
+     * \return Send pool hits and misses, zero if not connected.
+     */
+    SendPoolStatistics SendPoolStats(const defs::connection_t& target) const;
 
     /*!
      * \brief Tells if a given client is currently connected ot the server
@@ -134,14 +158,82 @@ public:
      * \return true if connected, false if not
      */
     bool IsConnected(const defs::connection_t& client) const;
+    /*!
+     * \brief Get the unique ID of a connection.
+     * \param[in] target - Target connection details.
+     * \return Connection ID, or NULL_CONNECTION_ID if no such connection.
+     */
+    defs::connection_id_t ConnectionId(const defs::connection_t& target) const;
+    /*!
+     * \brief Pack a connection into an integer key.
+     * \param[in] endpoint - Connection details.
+     * \return For IPv4 addresses the address and port packed into 48 bits, otherwise a hash.
+     */
+    static uint64_t PackedKey(defs::connection_t const& endpoint);
+    /*!
+     * \brief Take a snapshot of the current connections.
+     * \return Vector of connection pointers.
+     */
+    std::vector<defs::tcp_conn_ptr_t> Connections() const;
+
+private:
+    /*! \brief A registered connection and the endpoint it was added under. */
+    struct Entry
+    {
+        /*! \brief Endpoint, used to tell apart non-IPv4 endpoints whose keys collide. */
+        defs::connection_t endpoint;
+        /*! \brief The connection object. */
+        defs::tcp_conn_ptr_t connection;
+    };
+    /*! \brief Typedef to our connection map type, keyed by PackedKey. */
+    using tcp_conn_map = std::unordered_multimap<uint64_t, Entry>;
+    /*! \brief A single shard of the connection registry. */
+    struct Shard
+    {
+        /*! \brief Shared mutex, exclusive for add/remove, shared for lookups. */
+        mutable std::shared_mutex mutex;
+        /*! \brief The connections map for this shard. */
+        tcp_conn_map connections;
+    };
+    /*! \brief Index entry recording where a connection object is registered. */
+    struct IndexEntry
+    {
+        /*! \brief Packed key of the endpoint. */
+        uint64_t key{0};
+        /*! \brief Endpoint the connection was added under. */
+        defs::connection_t endpoint;
+    };
+    /*! \brief Number of shards, must be a power of 2. */
+    static constexpr size_t NUM_SHARDS = 16;
+    /*!
+     * \brief Get the shard for a packed key.
+     * \param[in] key - Packed key of the connection.
+     * \return Shard the connection belongs in.
+     */
+    Shard& ShardFor(uint64_t key) const;
+    /*!
+     * \brief Find an entry within a shard.
+     * \param[in] shard - Shard to search, caller must hold its mutex.
+     * \param[in] key - Packed key of the connection.
+     * \param[in] endpoint - Connection details.
+     * \return Iterator to the entry, or the shard's end iterator if not found.
+     */
+    static tcp_conn_map::iterator FindIn(Shard& shard, uint64_t key,
+                                         defs::connection_t const& endpoint);
+    /*!
+     * \brief Find a connection.
+     * \param[in] endpoint - Connection details.
+     * \return Connection pointer, null if not found.
+     */
+    defs::tcp_conn_ptr_t Find(defs::connection_t const& endpoint) const;
 
 private:
-    /*! \brief Access mutex for thread safety. */
+    /*! \brief Access mutex serialising add/remove and guarding m_index and m_onClose. */
     mutable std::mutex m_mutex;
-    /*! \brief Typedef to our connection map type. */
-    using tcp_conn_map = std::map<defs::connection_t, defs::tcp_conn_ptr_t>;
-    /*! \brief The connections map. */
-    tcp_conn_map m_connections;
+    /*! \brief The connection shards. */
+    mutable std::array<Shard, NUM_SHARDS> m_shards;
+    /*! \brief Index from connection object to its endpoint and key. */
+    std::unordered_map<TcpConnection const*, IndexEntry> m_index;
     /*! \brief On close callback. */
     defs::on_close_t m_onClose;
 };
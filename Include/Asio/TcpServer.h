@@ -79,6 +79,12 @@ public:
      * \param[in] checkBytesLeftToReadEx - Function object capable of decoding the message and
      * computing how many bytes are left until a complete message. Extended to take endpoint
      * details.
+     * \param[in] prepareBodyReceive - Function object supplying the buffer a message body is read
+     * directly into, only used when settings.readMode is eReadMode::directToBody.
+     * \param[in] messageReceivedHandlerId - Message received handler also passed the connection's
+     * ID, takes precedence over messageReceivedHandlerEx and messageReceivedHandler.
+     * \param[in] checkBytesLeftToReadId - Check bytes left to read callback also passed the
+     * connection's ID, takes precedence over checkBytesLeftToReadEx and checkBytesLeftToRead.
      *
      * Typically use this constructor when managing a bool of threads using an instance of
      * IoContextThreadGroup in your application to manage a pool of std::threads.
@@ -91,7 +97,51 @@ public:
             defs::message_received_handler_t const& messageReceivedHandler,
             TcpConnSettings const& settings = {},
             defs::message_received_handler_ex_t const& messageReceivedHandlerEx = {},
-            defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx   = {});
+            defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx   = {},
+            defs::prepare_body_receive_t const&        prepareBodyReceive       = {},
+            defs::message_received_handler_id_t const& messageReceivedHandlerId = {},
+            defs::check_bytes_left_to_read_id_t const& checkBytesLeftToReadId   = {});
+    /*!
+     * \brief Initialisation constructor.
+     * \param[in] ioThreadGroup - External I/O thread group to manage ASIO.
+     * \param[in] listenPort - Our listen port for all detected networks.
+     * \param[in] checkBytesLeftToRead - Function object capable of decoding the message and
+     *            computing how many bytes are left until a complete message.
+     * \param[in] messageReceivedHandler - Function object capable of handling a received message
+     * and dispatching it accordingly.
+     * \param[in] settings - structure containing connection options
+     * and behavioural settings.
+     * \param[in] distribution - How accepted connections are spread over the group's I/O
+     * contexts.
+     * \param[in] messageReceivedHandlerEx - Special callback for when
+     * socket is used for special use cases where the message handler needs the endpoint details
+     * passed to it. If this is defined then you ideally would set messageReceivedHandler = {}.
+     * \param[in] checkBytesLeftToReadEx - Function object capable of decoding the message and
+     * computing how many bytes are left until a complete message. Extended to take endpoint
+     * details.
+     * \param[in] prepareBodyReceive - Function object supplying the buffer a message body is read
+     * directly into, only used when settings.readMode is eReadMode::directToBody.
+     * \param[in] messageReceivedHandlerId - Message received handler also passed the connection's
+     * ID, takes precedence over messageReceivedHandlerEx and messageReceivedHandler.
+     * \param[in] checkBytesLeftToReadId - Check bytes left to read callback also passed the
+     * connection's ID, takes precedence over checkBytesLeftToReadEx and checkBytesLeftToRead.
+     *
+     * Use this constructor with an IoContextThreadGroup created in eIoContextMode::perThread
+     * mode. The acceptor runs on the group's first I/O context and each accepted connection is
+     * given one of the group's contexts, so all of that connection's handlers run on a single
+     * thread. With a shared mode group this behaves as the external IO service constructor.
+     */
+    TcpServer(IoContextThreadGroup&                      ioThreadGroup,
+              uint16_t                                   listenPort,
+              defs::check_bytes_left_to_read_t const&    checkBytesLeftToRead,
+              defs::message_received_handler_t const&    messageReceivedHandler,
+              TcpConnSettings const&                     settings     = {},
+              eConnectionDistribution                    distribution = eConnectionDistribution::roundRobin,
+              defs::message_received_handler_ex_t const& messageReceivedHandlerEx = {},
+              defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx   = {},
+              defs::prepare_body_receive_t const&        prepareBodyReceive       = {},
+            defs::message_received_handler_id_t const& messageReceivedHandlerId = {},
+            defs::check_bytes_left_to_read_id_t const& checkBytesLeftToReadId   = {});
     /*!
      * \brief Initialisation constructor.
      * \param[in] listenPort - Our listen port for all detected networks.
@@ -112,6 +162,12 @@ public:
      * \param[in] checkBytesLeftToReadEx - Function object capable of decoding the message and
      * computing how many bytes are left until a complete message. Extended to take endpoint
      * details.
+     * \param[in] prepareBodyReceive - Function object supplying the buffer a message body is read
+     * directly into, only used when settings.readMode is eReadMode::directToBody.
+     * \param[in] messageReceivedHandlerId - Message received handler also passed the connection's
+     * ID, takes precedence over messageReceivedHandlerEx and messageReceivedHandler.
+     * \param[in] checkBytesLeftToReadId - Check bytes left to read callback also passed the
+     * connection's ID, takes precedence over checkBytesLeftToReadEx and checkBytesLeftToRead.
      *
      * This constructor does not require an external IO service to run instead it creates
      * its own IO service object along with its own 2 threads. For simple cases this
@@ -123,7 +179,10 @@ public:
             defs::message_received_handler_t const& messageReceivedHandler,
             TcpConnSettings const& settings = {},
             defs::message_received_handler_ex_t const& messageReceivedHandlerEx = {},
-            defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx = {});
+            defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx = {},
+            defs::prepare_body_receive_t const&        prepareBodyReceive     = {},
+            defs::message_received_handler_id_t const& messageReceivedHandlerId = {},
+            defs::check_bytes_left_to_read_id_t const& checkBytesLeftToReadId   = {});
     /*! \brief Default destructor. */
     ~TcpServer();
     /*!
@@ -186,12 +245,25 @@ public:
      * method gives best performance when sending.
      */
     void SendMessageToAllClients(defs::char_buf_cspan_t message) const;
+    /*!
+     * \brief Send a shared message buffer to all clients asynchronously without copying it.
+     * \param[in] message - Shared message buffer, must not be modified after this call.
+     *
+     * The buffer is released once the last client connection has finished writing it.
+     */
+    void SendMessageToAllClients(defs::shared_char_buffer_t const& message) const;
     /*!
      * \brief Get number of unsent async messages.
      * \param[in] client - Target connection details.
      * \return Number of unsent messages
      */
     size_t NumberOfUnsentAsyncMessages(const defs::connection_t& client) const;
+    /*!
+     * \brief Get async send pool usage counters.
+     * \param[in] client - Target connection details.
+     * \return Send pool hits and misses, zero if not connected.
+     */
+    SendPoolStatistics SendPoolStats(const defs::connection_t& client) const;
 
     /*!
      * \brief Tells if a given client is currently connected to the server
@@ -199,6 +271,12 @@ public:
      * \return true if connected, false if not
      */
     bool IsConnected(const defs::connection_t& client) const;
+    /*!
+     * \brief Get the unique ID of a client's connection.
+     * \param[in] client - Target connection details.
+     * \return Connection ID, or NULL_CONNECTION_ID if client is not connected.
+     */
+    defs::connection_id_t GetClientConnectionId(const defs::connection_t& client) const;
 
 private:
     /*! \brief Accept a connection. */
@@ -211,6 +289,11 @@ private:
     void AcceptHandler(const defs::tcp_conn_ptr_t& connection, const boost_sys::error_code& error);
     /*! \brief Process closing the acceptor. */
     void ProcessCloseAcceptor();
+    /*!
+     * \brief Choose the I/O context for the next accepted connection.
+     * \return Index of the context within the connection thread group.
+     */
+    size_t NextConnectionContext();
 
 private:
     /*! \brief I/O service thread group. */
@@ -231,10 +314,24 @@ private:
     defs::message_received_handler_t m_messageReceivedHandler;
     /*! \brief Message received handler extended callback. */
     defs::message_received_handler_ex_t m_messageReceivedHandlerEx;
+    /*! \brief Check bytes left to read callback taking the connection ID. */
+    defs::check_bytes_left_to_read_id_t m_checkBytesLeftToReadId;
+    /*! \brief Message received handler callback taking the connection ID. */
+    defs::message_received_handler_id_t m_messageReceivedHandlerId;
+    /*! \brief Prepare body receive callback. */
+    defs::prepare_body_receive_t m_prepareBodyReceive;
     /*! \brief Structure holding socket connection options and behavioural settings. */
     TcpConnSettings m_settings;
     /*! \brief TCP connections object. */
     std::shared_ptr<TcpConnections> m_clientConnections;
+    /*! \brief Thread group whose I/O contexts accepted connections are spread over. */
+    IoContextThreadGroup* m_connectionThreadGroup{nullptr};
+    /*! \brief How accepted connections are spread over I/O contexts. */
+    eConnectionDistribution m_distribution{eConnectionDistribution::roundRobin};
+    /*! \brief Round robin counter for connection I/O contexts (strand-only). */
+    size_t m_nextConnectionContext{0};
+    /*! \brief Connections created on each I/O context, used when least loaded (strand-only). */
+    std::vector<std::vector<std::weak_ptr<TcpConnection>>> m_contextConnections;
     /*! \brief Close event. */
     threads::SyncEvent m_closedEvent;
 };
@@ -86,6 +86,8 @@ public:
      * \param[in] checkBytesLeftToReadEx - Function object capable of decoding the message and
      * computing how many bytes are left until a complete message. Extended to take endpoint
      * details.
+     * \param[in] prepareBodyReceive - Function object supplying the buffer a message body is read
+     * directly into, only used when settings.readMode is eReadMode::directToBody.
      *
      * Typically use this constructor when managing a bool of threads using an instance of
      * IoContextThreadGroup in your application to manage a pool of std::threads.
@@ -99,7 +101,8 @@ public:
                 const MsgBldr& messageBuilder,
 				TcpConnSettings const& settings = {},
                 defs::message_received_handler_ex_t const& messageReceivedHandlerEx = {},
-                defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx   = {})
+                defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx   = {},
+                defs::prepare_body_receive_t const&        prepareBodyReceive       = {})
         : m_messageBuilder{messageBuilder}
         , m_tcpClient{ioService,
                       server,
@@ -107,7 +110,8 @@ public:
                       messageReceivedHandler,
                       settings,
                       messageReceivedHandlerEx,
-                      checkBytesLeftToReadEx}
+                      checkBytesLeftToReadEx,
+                      prepareBodyReceive}
     {
     }
     /*!
@@ -128,6 +132,8 @@ public:
      * \param[in] checkBytesLeftToReadEx - Function object capable of decoding the message and
      * computing how many bytes are left until a complete message. Extended to take endpoint
      * details.
+     * \param[in] prepareBodyReceive - Function object supplying the buffer a message body is read
+     * directly into, only used when settings.readMode is eReadMode::directToBody.
      *
      * This constructor does not require an external IO service to run instead it creates
      * its own IO service object along with its own thread. For very simple cases this
@@ -140,14 +146,16 @@ public:
                 const MsgBldr& messageBuilder,
 				TcpConnSettings const& settings = {},
                 defs::message_received_handler_ex_t const& messageReceivedHandlerEx = {},
-                defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx   = {})
+                defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx   = {},
+                defs::prepare_body_receive_t const&        prepareBodyReceive       = {})
         : m_messageBuilder{messageBuilder}
         , m_tcpClient{server,
                       checkBytesLeftToRead,
                       messageReceivedHandler,
                       settings,
                       messageReceivedHandlerEx,
-                      checkBytesLeftToReadEx}
+                      checkBytesLeftToReadEx,
+                      prepareBodyReceive}
     {
     }
     /*! \brief Default destructor. */
@@ -215,7 +223,7 @@ public:
     bool SendMessageToServerAsync(int32_t messageId,
                              const defs::connection_t& responseAddress = defs::NULL_CONNECTION)
     {
-        std::lock_guard<std::mutex> lock(m_sendMutex);
+        auto lock = AsyncSendLock();
 
         try
         {
@@ -275,7 +283,7 @@ public:
                             const defs::connection_t& responseAddress = defs::NULL_CONNECTION,
                             defs::eArchiveType        archiveType = defs::eArchiveType::raw)
     {
-        std::lock_guard<std::mutex> lock(m_sendMutex);
+        auto lock = AsyncSendLock();
 
         try
         {
@@ -338,7 +346,7 @@ public:
 	                        int32_t messageId,
                             const defs::connection_t& responseAddress = defs::NULL_CONNECTION)
     {
-        std::lock_guard<std::mutex> lock(m_sendMutex);
+        auto lock = AsyncSendLock();
 
         try
         {
@@ -424,6 +432,21 @@ public:
     {
         return m_tcpClient.NumberOfUnsentAsyncMessages();
     }
+    /*!
+     * \brief Get async send pool usage counters.
+     * \return Send pool hits and misses, zero if not connected.
+     */
+    SendPoolStatistics SendPoolStats() const
+    {
+        return m_tcpClient.SendPoolStats();
+    }
+
+private:
+    /*! \brief Lock the send mutex for an async send, see messages::AsyncSendLock. */
+    std::unique_lock<std::mutex> AsyncSendLock() const
+    {
+        return messages::AsyncSendLock(m_messageBuilder, m_sendMutex);
+    }
 
 private:
     /*! \brief Send message mutex. */
@@ -84,6 +84,12 @@ public:
      * \param[in] checkBytesLeftToReadEx - Function object capable of decoding the message and
      * computing how many bytes are left until a complete message. Extended to take endpoint
      * details.
+     * \param[in] prepareBodyReceive - Function object supplying the buffer a message body is read
+     * directly into, only used when settings.readMode is eReadMode::directToBody.
+     * \param[in] messageReceivedHandlerId - Message received handler also passed the connection's
+     * ID, takes precedence over messageReceivedHandlerEx and messageReceivedHandler.
+     * \param[in] checkBytesLeftToReadId - Check bytes left to read callback also passed the
+     * connection's ID, takes precedence over checkBytesLeftToReadEx and checkBytesLeftToRead.
      *
      * Typically use this constructor when managing a bool of threads using an instance of
      * IoContextThreadGroup in your application to manage a pool of std::threads.
@@ -96,7 +102,10 @@ public:
                 const defs::message_received_handler_t& messageReceivedHandler,
                 const MsgBldr& messageBuilder, TcpConnSettings const& settings = {},
                 defs::message_received_handler_ex_t const& messageReceivedHandlerEx = {},
-                defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx   = {})
+                defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx   = {},
+                defs::prepare_body_receive_t const&        prepareBodyReceive       = {},
+                defs::message_received_handler_id_t const& messageReceivedHandlerId = {},
+                defs::check_bytes_left_to_read_id_t const& checkBytesLeftToReadId   = {})
         : m_messageBuilder{messageBuilder}
         , m_tcpServer{ioService,
                     listenPort,
@@ -104,7 +113,10 @@ public:
                     messageReceivedHandler,
                     settings,
                     messageReceivedHandlerEx,
-                    checkBytesLeftToReadEx}
+                    checkBytesLeftToReadEx,
+                    prepareBodyReceive,
+                    messageReceivedHandlerId,
+                    checkBytesLeftToReadId}
     {
     }
     /*!
@@ -124,6 +136,12 @@ public:
      * \param[in] checkBytesLeftToReadEx - Function object capable of decoding the message and
      * computing how many bytes are left until a complete message. Extended to take endpoint
      * details.
+     * \param[in] prepareBodyReceive - Function object supplying the buffer a message body is read
+     * directly into, only used when settings.readMode is eReadMode::directToBody.
+     * \param[in] messageReceivedHandlerId - Message received handler also passed the connection's
+     * ID, takes precedence over messageReceivedHandlerEx and messageReceivedHandler.
+     * \param[in] checkBytesLeftToReadId - Check bytes left to read callback also passed the
+     * connection's ID, takes precedence over checkBytesLeftToReadEx and checkBytesLeftToRead.
      *
      * This constructor does not require an external IO service to run instead it creates
      * its own IO service object along with its own thread. For very simple cases this
@@ -136,14 +154,20 @@ public:
                 const MsgBldr& messageBuilder,
 				TcpConnSettings const& settings = {},
                 defs::message_received_handler_ex_t const& messageReceivedHandlerEx = {},
-                defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx   = {})
+                defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx   = {},
+                defs::prepare_body_receive_t const&        prepareBodyReceive       = {},
+                defs::message_received_handler_id_t const& messageReceivedHandlerId = {},
+                defs::check_bytes_left_to_read_id_t const& checkBytesLeftToReadId   = {})
         : m_messageBuilder{messageBuilder}
         , m_tcpServer{listenPort,
                     checkBytesLeftToRead,
                     messageReceivedHandler,
                     settings,
                      messageReceivedHandlerEx,
-                    checkBytesLeftToReadEx}
+                    checkBytesLeftToReadEx,
+                    prepareBodyReceive,
+                    messageReceivedHandlerId,
+                    checkBytesLeftToReadId}
     {
     }
     /*! \brief Default destructor. */
@@ -218,7 +242,7 @@ public:
 		int32_t messageId,
         const defs::connection_t& responseAddress = defs::NULL_CONNECTION) const
     {
-        std::lock_guard<std::mutex> lock(m_sendMutex);
+        auto lock = AsyncSendLock();
         try
         {
             auto messageBuffer = messages::BuildMessage(
@@ -270,7 +294,7 @@ public:
     SendMessageToAllClients(int32_t messageId,
                             const defs::connection_t& responseAddress = defs::NULL_CONNECTION) const
     {
-        std::lock_guard<std::mutex> lock(m_sendMutex);
+        auto lock = AsyncSendLock();
 
         try
         {
@@ -313,7 +337,7 @@ public:
         const defs::connection_t& responseAddress = defs::NULL_CONNECTION,
         defs::eArchiveType        archiveType = defs::eArchiveType::raw) const
     {
-        std::lock_guard<std::mutex> lock(m_sendMutex);
+        auto lock = AsyncSendLock();
         try
         {
             auto messageBuffer = messages::BuildMessage(message,
@@ -383,7 +407,7 @@ public:
                        const defs::connection_t& responseAddress = defs::NULL_CONNECTION,
                        defs::eArchiveType        archiveType = defs::eArchiveType::raw) const
     {
-        std::lock_guard<std::mutex> lock(m_sendMutex);
+        auto lock = AsyncSendLock();
 
         try
         {
@@ -425,7 +449,7 @@ public:
 		int32_t messageId,
         const defs::connection_t& responseAddress = defs::NULL_CONNECTION) const
     {
-        std::lock_guard<std::mutex> lock(m_sendMutex);
+        auto lock = AsyncSendLock();
         try
         {
             auto messageBuffer =
@@ -492,7 +516,7 @@ public:
 	                    int32_t messageId,
                         const defs::connection_t& responseAddress = defs::NULL_CONNECTION) const
     {
-        std::lock_guard<std::mutex> lock(m_sendMutex);
+        auto lock = AsyncSendLock();
 
         try
         {
@@ -576,6 +600,26 @@ public:
             return false;
         }
     }
+    /*!
+     * \brief Send a shared message buffer to all clients asynchronously without copying it.
+     * \param[in] message - Shared message buffer, must not be modified after this call.
+     * \return Returns true if posted async message, retruns false if failed to post message.
+     *
+     * The buffer is released once the last client connection has finished writing it.
+     */
+    bool SendMessageToAllClients(defs::shared_char_buffer_t const& message) const
+    {
+        try
+        {
+            // Do not need mutex here as we're not using the m_messageBuilder.
+            m_tcpServer.SendMessageToAllClients(message);
+            return true;
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
     /*!
      * \brief Get number of unsent async messages.
      * \param[in] client - Target connection details.
@@ -585,6 +629,15 @@ public:
     {
         return m_tcpServer.NumberOfUnsentAsyncMessages(client);
     }
+    /*!
+     * \brief Get async send pool usage counters.
+     * \param[in] client - Target connection details.
+     * \return Send pool hits and misses, zero if not connected.
+     */
+    SendPoolStatistics SendPoolStats(const defs::connection_t& client) const
+    {
+        return m_tcpServer.SendPoolStats(client);
+    }
 
     /*!
      * \brief Tells if a given client is currently connected to the server
@@ -595,6 +648,22 @@ public:
     {
         return m_tcpServer.IsConnected(client);
     }
+    /*!
+     * \brief Get the unique ID of a client's connection.
+     * \param[in] client - Target connection details.
+     * \return Connection ID, or NULL_CONNECTION_ID if client is not connected.
+     */
+    defs::connection_id_t GetClientConnectionId(const defs::connection_t& client) const
+    {
+        return m_tcpServer.GetClientConnectionId(client);
+    }
+
+private:
+    /*! \brief Lock the send mutex for an async send, see messages::AsyncSendLock. */
+    std::unique_lock<std::mutex> AsyncSendLock() const
+    {
+        return messages::AsyncSendLock(m_messageBuilder, m_sendMutex);
+    }
 
 private:
     /*! \brief Send message mutex. */
@@ -27,13 +27,15 @@
 #ifndef DEBUGLOG
 #define DEBUGLOG
 
+#include <atomic>
+#include <cstdint>
 #include <ctime>
 #include <chrono>
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <sstream>
 #include <iostream>
-#include <set>
 #include <tuple>
 #include <unordered_map>
 #include <stdexcept>
@@ -41,11 +43,13 @@
 #include <memory>
 #include <functional>
 #include <type_traits>
+#include <vector>
 #include <boost/throw_exception.hpp>
 #include "CoreLibraryDllGlobal.h"
 #include "Platform/PlatformDefines.h"          
 #include "FileUtils/SelectFileSystemLibrary.hpp" 
 #include "Threads/MessageQueueThread.h"
+#include "DeferredLogRing.h"
 
 /*! \brief The core_lib namespace. */
 namespace core_lib
@@ -57,6 +61,8 @@ namespace log
 /*! \brief Enumeration containing log message level options. */
 enum class eLogMessageLevel
 {
+    /*! \brief Special value to use when formatting deferred messages. */
+    process_deferred = -3,
     /*! \brief Special value to use when copying mirror log to buffer. */
     copy_mirror_log_to_buf = -2,
     /*! \brief Special value to use when copying log to buffer. */
@@ -83,6 +89,59 @@ enum class eMsgTarget
     both
 };
 
+/*! \brief Control the precision of the time stamps written to the log.*/
+enum class eTimeStampPrecision
+{
+    /*! \brief Whole seconds, e.g. 12:34:56. */
+    seconds,
+    /*! \brief Milliseconds, e.g. 12:34:56.789. */
+    milliseconds,
+    /*! \brief Microseconds, e.g. 12:34:56.789012. */
+    microseconds
+};
+
+/*! \brief Typedef for log message time stamps, the epoch means no time stamp.*/
+using log_time_point_t = std::chrono::system_clock::time_point;
+
+/*!
+ * \brief Static description of a log call site.
+ *
+ * Used by the DEBUG_LOG_*_EX macros so the file and function names are
+ * queued by pointer rather than copied, both must have static storage
+ * duration, e.g. __FILE__ and BOOST_CURRENT_FUNCTION.
+ */
+struct LogCallSite
+{
+    /*! \brief Source file, e.g. __FILE__. */
+    const char* file;
+    /*! \brief Function, e.g. BOOST_CURRENT_FUNCTION. */
+    const char* function;
+    /*! \brief Line number, e.g. __LINE__. */
+    int lineNo;
+};
+
+/*!
+ * \brief Static description of a deferred log call site.
+ *
+ * Created once per call site by the DEBUG_LOG_DEFERRED macros so only the
+ * message's arguments need to be copied each time it is logged.
+ */
+struct DeferredLogDescriptor
+{
+    /*! \brief Source file, e.g. __FILE__. */
+    const char* file;
+    /*! \brief Function, e.g. BOOST_CURRENT_FUNCTION. */
+    const char* function;
+    /*! \brief Line number, e.g. __LINE__. */
+    int lineNo;
+    /*! \brief Message level. */
+    eLogMessageLevel level;
+    /*! \brief Message target. */
+    eMsgTarget msgTarget;
+    /*! \brief Format string, each "{}" is replaced by the next argument. */
+    const char* format;
+};
+
 } // namespace log
 } // namespace core_lib
 
@@ -144,10 +203,55 @@ extern const char ANSI_WHITE[];
  * intended for writing to the console, when that mode is active.
  *
  * If different formatting is required then a user can define their own compatible formatter
- * functor, as long as it has a fully compatible interface with DefaultLogFormat.
+ * functor, as long as it has a fully compatible interface with DefaultLogFormat. DebugLog uses
+ * the log_time_point_t overloads when the formatter provides them, otherwise the std::time_t
+ * overloads, which only have whole second time stamps.
+ *
+ * The date and time are only formatted once per minute and cached, so the time stamp of
+ * each message only needs its seconds and fraction written. Because of this cache an
+ * instance must not be used by more than one thread at a time, DebugLog only uses its
+ * formatter on its logging thread.
  */
-struct CORE_LIBRARY_DLL_SHARED_API DefaultLogFormat FINAL_
+class CORE_LIBRARY_DLL_SHARED_API DefaultLogFormat FINAL_
 {
+public:
+    /*!
+     * \brief Function operator to perform the line formatting, suitable for std::ofstream.
+     * \param[out] os - Output stream to write formatted line to.
+     * \param[in] timeStamp -The timestamp, no time stamp is written if it is the epoch.
+     * \param[in] message - The actual message.
+     * \param[in] logMsgLevel - Log message level.
+     * \param[in] file - File where log message was generated.
+     * \param[in] function - Function where log message was generated.
+     * \param[in] lineNo - Line number where log message was generated.
+     * \param[in] threadID - Thread ID fo where log message was generated.
+     * \param[in] utcTimeStamps - Enable use of UTC timestamps instead of local time.
+     * \param[in] tzOffset - Include timezone offset, e.g. +hhmm ... +0100.
+     * \param[in] precision - Time stamp precision.
+     */
+    void operator()(std::ostream& os, const log_time_point_t& timeStamp,
+                    const std::string& message, const std::string& logMsgLevel,
+                    std::string_view file, std::string_view function, int lineNo,
+                    const std::thread::id& threadID, bool utcTimeStamps, bool tzOffset,
+                    eTimeStampPrecision precision) const;
+
+    /*!
+     * \brief Function operator to perform the line formatting, suitable for std::cout.
+     * \param[out] os - Output stream to write formatted line to.
+     * \param[in] timeStamp -The timestamp, no time stamp is written if it is the epoch.
+     * \param[in] message - The actual message.
+     * \param[in] logMsgLevel - Log message level.
+     * \param[in] utcTimeStamps - Enable use of UTC timestamps instead of local time.
+     * \param[in] tzOffset - Include timezone offset, e.g. +hhmm ... +0100.
+     * \param[in] precision - Time stamp precision.
+     * \param[in] colourCode - If set to true then ASCII colour codes are applied to the stream;
+     * only use for console output, passed as one of the constants: ANSI_* from above.
+     */
+    void operator()(std::ostream& os, const log_time_point_t& timeStamp,
+                    const std::string& message, const std::string& logMsgLevel,
+                    bool utcTimeStamps, bool tzOffset, eTimeStampPrecision precision,
+                    const char* colourCode = nullptr) const;
+
     /*!
      * \brief Function operator to perform the line formatting, suitable for std::ofstream.
      * \param[out] os - Output stream to write formatted line to.
@@ -162,8 +266,8 @@ struct CORE_LIBRARY_DLL_SHARED_API DefaultLogFormat FINAL_
      * \param[in] tzOffset - Include timezone offset, e.g. +hhmm ... +0100.
      */
     void operator()(std::ostream& os, std::time_t timeStamp, const std::string& message,
-                    const std::string& logMsgLevel, const std::string& file,
-                    const std::string& function, int lineNo, const std::thread::id& threadID,
+                    const std::string& logMsgLevel, std::string_view file,
+                    std::string_view function, int lineNo, const std::thread::id& threadID,
                     bool utcTimeStamps, bool tzOffset) const;
 
     /*!
@@ -180,6 +284,32 @@ struct CORE_LIBRARY_DLL_SHARED_API DefaultLogFormat FINAL_
     void operator()(std::ostream& os, std::time_t timeStamp, const std::string& message,
                     const std::string& logMsgLevel, bool utcTimeStamps, bool tzOffset,
                     const char* colourCode = nullptr) const;
+
+private:
+    /*!
+     * \brief Write the time stamp and divider, if the time stamp is not the epoch.
+     * \param[out] os - Output stream to write time stamp to.
+     * \param[in] timeStamp -The timestamp.
+     * \param[in] utcTimeStamps - Enable use of UTC timestamps instead of local time.
+     * \param[in] tzOffset - Include timezone offset, e.g. +hhmm ... +0100.
+     * \param[in] precision - Time stamp precision.
+     */
+    void WriteTimeStamp(std::ostream& os, const log_time_point_t& timeStamp, bool utcTimeStamps,
+                        bool tzOffset, eTimeStampPrecision precision) const;
+
+private:
+    /*! \brief Typedef for a time stamp truncated to the minute.*/
+    using minute_point_t = std::chrono::time_point<std::chrono::system_clock, std::chrono::minutes>;
+    /*! \brief Minute the cached date and time were formatted for.*/
+    mutable minute_point_t m_cachedMinute;
+    /*! \brief Whether the cached date and time are UTC.*/
+    mutable bool m_cachedUtcTimeStamps{false};
+    /*! \brief Whether the cached date and time include the timezone offset.*/
+    mutable bool m_cachedTzOffset{false};
+    /*! \brief Cached date and time up to the seconds, e.g. "2024 Jan 02 12:34:".*/
+    mutable std::string m_cachedDateTime;
+    /*! \brief Cached timezone offset, e.g. "+0100", empty if not used.*/
+    mutable std::string m_cachedTzOffsetText;
 };
 
 /*! \brief Static constant defining number of bytes in a mebibyte. */
@@ -188,6 +318,53 @@ enum eDebugLogSize : size_t
     BYTES_IN_MEBIBYTE = 1024 * 1024
 };
 
+/*!
+ * \brief Controls when DebugLog flushes its log files.
+ *
+ * Messages are written into a buffer and the log files are flushed when any
+ * of the limits below is reached, and always once all the messages queued so
+ * far have been written, so a burst of messages costs a single write. The
+ * default flushes after every message.
+ */
+struct LogFlushPolicy
+{
+    /*! \brief Flush once this many messages are unflushed, 0 for no limit. */
+    size_t maxMessages{1};
+    /*! \brief Flush once the oldest unflushed message is this old, 0 for no limit. */
+    std::chrono::milliseconds maxDelay{0};
+    /*! \brief Flush straight after writing error and fatal messages. */
+    bool flushOnError{true};
+};
+
+/*!
+ * \brief Typedef for a function compressing an old log file.
+ *
+ * Passed the old log's path and the path to write the compressed file to,
+ * returns true on success, after which the old log is removed.
+ */
+using log_file_compressor_t =
+    std::function<bool(const std::string& filePath, const std::string& compressedFilePath)>;
+
+/*!
+ * \brief Controls how DebugLog rotates its log files.
+ *
+ * When the log would grow past its maximum size, or optionally once it reaches
+ * a maximum age, it is closed and renamed to "<name>_old<ext>", older logs are
+ * renamed to "<name>_old_2<ext>", "<name>_old_3<ext>" and so on, and a new log
+ * is started. The default keeps a single old log.
+ */
+struct LogRotationPolicy
+{
+    /*! \brief Number of old log files to keep, at least 1. */
+    size_t generations{1};
+    /*! \brief Also rotate once the log has been open this long, 0 to only rotate on size. */
+    std::chrono::seconds maxAge{0};
+    /*! \brief Optional function run on a background thread to compress each old log. */
+    log_file_compressor_t compressor;
+    /*! \brief Extension appended to the names of compressed old logs, defaults to ".gz". */
+    std::string compressedExt;
+};
+
 namespace dl_private
 {
 
@@ -219,8 +396,26 @@ public:
      * \param[in] errorLevel - Message level.
      * \param[in] msgTarget - Message target, e.g. file, console or both.
      */
-    LogQueueMessage(std::string const& message, time_t timeStamp, std::string const& file,
-                    std::string const& function, int lineNo, const std::thread::id& threadID,
+    LogQueueMessage(std::string const& message, const log_time_point_t& timeStamp,
+                    std::string const& file, std::string const& function, int lineNo,
+                    const std::thread::id& threadID, eLogMessageLevel errorLevel,
+                    eMsgTarget msgTarget = eMsgTarget::file);
+    /*!
+     * \brief Initialising constructor taking file and function as string literals.
+     * \param[in] message - Message to add to log, moved into this object.
+     * \param[in] timeStamp - Date/Time stamp for message.
+     * \param[in] file - Source file in which message AddLogMessage was called, e.g. __FILE__,
+     * must have static storage duration as only the pointer is kept.
+     * \param[in] function - Function in source file in which message AddLogMessage was called,
+     * e.g. BOOST_CURRENT_FUNCTION, must have static storage duration as only the pointer is kept.
+     * \param[in] lineNo - Line number in the source file where AddLogMessage was called, e.g.
+     * __LINE__.
+     * \param[in] threadID - Thread ID where message was added from.
+     * \param[in] errorLevel - Message level.
+     * \param[in] msgTarget - Message target, e.g. file, console or both.
+     */
+    LogQueueMessage(std::string&& message, const log_time_point_t& timeStamp, const char* file,
+                    const char* function, int lineNo, const std::thread::id& threadID,
                     eLogMessageLevel errorLevel, eMsgTarget msgTarget = eMsgTarget::file);
     /*! \brief Copy constructor. */
     LogQueueMessage(const LogQueueMessage&) = default;
@@ -248,17 +443,17 @@ public:
      * \brief Get time stamp.
      * \return Time stamp.
      */
-    time_t TimeStamp() const;
+    const log_time_point_t& TimeStamp() const;
     /*!
      * \brief Get source file name string.
      * \return File name string.
      */
-    const std::string& File() const;
+    const char* File() const;
     /*!
      * \brief Get function name string.
-     * \return File name string.
+     * \return Function name string.
      */
-    const std::string& Function() const;
+    const char* Function() const;
     /*!
      * \brief Get source file line number.
      * \return Line number.
@@ -284,11 +479,15 @@ private:
     /*! \brief Message string.*/
     std::string m_message;
     /*! \brief Time stamp.*/
-    time_t m_timeStamp{0};
-    /*! \brief Source file name.*/
-    std::string m_file;
-    /*! \brief Function name.*/
-    std::string m_function;
+    log_time_point_t m_timeStamp;
+    /*! \brief Source file name literal, nullptr if held in m_fileStorage.*/
+    const char* m_file{nullptr};
+    /*! \brief Function name literal, nullptr if held in m_functionStorage.*/
+    const char* m_function{nullptr};
+    /*! \brief Source file name when not given as a literal.*/
+    std::string m_fileStorage;
+    /*! \brief Function name when not given as a literal.*/
+    std::string m_functionStorage;
     /*! \brief Line number in source file.*/
     int m_lineNo{0};
     /*! \brief Thread ID where message originated.*/
@@ -312,9 +511,9 @@ private:
  * prototype as DefaultLogFormat::operator()().
  *
  * The second arg is optional and controls the size at which
- * the log will close and switch to a new file. Only 2 files
- * ever exist the "log".txt and "log"_old.txt. The default log
- * size is 5MiB.
+ * the log will close and switch to a new file. By default only 2
+ * files ever exist the "log".txt and "log"_old.txt, more old logs
+ * can be kept using SetRotationPolicy. The default log size is 5MiB.
  */
 template <class Formatter> class DebugLog FINAL_
 {
@@ -410,6 +609,8 @@ public:
         m_logMsgQueueThread.reset();
         CloseOfStream(m_ofStream);
         CloseOfStream(m_ofStreamMirror);
+        // Finish compressing any old logs.
+        m_compressionQueueThread.reset();
     }
     /*!
      * \brief Instantiate a previously default constructed DebugLog object.
@@ -487,12 +688,7 @@ public:
      */
     void AddLogMsgLevelFilter(eLogMessageLevel logMessageLevel)
     {
-        std::lock_guard<std::mutex> lock{m_mutex};
-
-        if (!IsLogMsgLevelFilterSetNoMutex(logMessageLevel))
-        {
-            m_logMsgFilterSet.insert(logMessageLevel);
-        }
+        m_logMsgFilterMask.fetch_or(LogMsgLevelBit(logMessageLevel), std::memory_order_relaxed);
     }
     /*!
      * \brief Remove level from filter.
@@ -507,12 +703,7 @@ public:
      */
     void RemoveLogMsgLevelFilter(eLogMessageLevel logMessageLevel)
     {
-        std::lock_guard<std::mutex> lock{m_mutex};
-
-        if (IsLogMsgLevelFilterSetNoMutex(logMessageLevel))
-        {
-            m_logMsgFilterSet.insert(logMessageLevel);
-        }
+        m_logMsgFilterMask.fetch_and(~LogMsgLevelBit(logMessageLevel), std::memory_order_relaxed);
     }
     /*!
      * \brief Clear all message levels from filter.
@@ -522,8 +713,19 @@ public:
      */
     void ClearLogMsgLevelFilters()
     {
-        std::lock_guard<std::mutex> lock{m_mutex};
-        m_logMsgFilterSet.clear();
+        m_logMsgFilterMask.store(0, std::memory_order_relaxed);
+    }
+    /*!
+     * \brief Will messages of a given level be logged.
+     * \param[in] logMessageLevel - Message level.
+     * \return True if the level is not filtered out, false otherwise.
+     *
+     * This is a single relaxed atomic load so callers, such as the
+     * DEBUG_LOG_EX macros, can check it before doing any formatting.
+     */
+    bool IsLogMsgLevelEnabled(eLogMessageLevel logMessageLevel) const NO_EXCEPT_
+    {
+        return !IsLogMsgLevelFilterSet(logMessageLevel);
     }
     /*!
      * \brief Add message to the log file.
@@ -535,13 +737,39 @@ public:
      */
     void AddLogMessage(const std::string& message, eMsgTarget msgTarget = eMsgTarget::file)
     {
-        using std::chrono::system_clock;
-        time_t          messageTime = system_clock::to_time_t(system_clock::now());
+        auto const      messageTime = std::chrono::system_clock::now();
         std::thread::id noThread;
         m_logMsgQueueThread->Push(dl_private::LogQueueMessage(
             message, messageTime, "", "", -1, noThread, eLogMessageLevel::not_defined, msgTarget));
     }
 
+    /*!
+     * \brief Add message to the log file.
+     * \param[in] message - Message to add to log, moved onto the log's queue.
+     * \param[in] site - Static call site, only its file and function pointers are queued.
+     * \param[in] logMsgLevel - Message level.
+     * \param[in] msgTarget - Message target, e.g. file, console or both.
+     *
+     * Add a message to the log with extra properties set, such as
+     * file, line no. etc. without copying the file and function names.
+     */
+    void AddLogMessage(std::string message, const LogCallSite& site, eLogMessageLevel logMsgLevel,
+                       eMsgTarget msgTarget = eMsgTarget::file)
+    {
+        if (!IsLogMsgLevelFilterSet(logMsgLevel))
+        {
+            auto const messageTime = std::chrono::system_clock::now();
+            m_logMsgQueueThread->Push(dl_private::LogQueueMessage(std::move(message),
+                                                                  messageTime,
+                                                                  site.file,
+                                                                  site.function,
+                                                                  site.lineNo,
+                                                                  std::this_thread::get_id(),
+                                                                  logMsgLevel,
+                                                                  msgTarget));
+        }
+    }
+
     /*!
      * \brief Add message to the log file.
      * \param[in] message - Message to add to log.
@@ -563,8 +791,7 @@ public:
     {
         if (!IsLogMsgLevelFilterSet(logMsgLevel))
         {
-            using std::chrono::system_clock;
-            time_t messageTime = system_clock::to_time_t(system_clock::now());
+            auto const messageTime = std::chrono::system_clock::now();
             m_logMsgQueueThread->Push(dl_private::LogQueueMessage(message,
                                                                   messageTime,
                                                                   file,
@@ -576,6 +803,144 @@ public:
         }
     }
 
+    /*!
+     * \brief Add a message to the log file, deferring its formatting.
+     * \param[in] descriptor - Static call site descriptor, must outlive the log.
+     * \param[in] args - Arguments for the descriptor's format string, must be arithmetic, enum or
+     * string types.
+     *
+     * The arguments are copied as raw bytes into a ring owned by the calling
+     * thread and the message is formatted later on the log's thread. If the
+     * ring is full the message is dropped and the number of dropped messages
+     * is written to the log the next time the rings are drained. Messages from
+     * different threads may be written slightly out of order relative to each
+     * other and to messages added with AddLogMessage, their time stamps record
+     * when they were added. Typically used via the DEBUG_LOG_DEFERRED macros.
+     */
+    template <typename... Args>
+    void AddDeferredLogMessage(const DeferredLogDescriptor& descriptor, const Args&... args)
+    {
+        if (IsLogMsgLevelFilterSet(descriptor.level))
+        {
+            return;
+        }
+
+        auto ring = m_deferredRings.ThisThreadRing();
+
+        if (!dl_private::EncodeDeferredLogRecord(*ring, descriptor, args...))
+        {
+            ring->CountDropped();
+        }
+
+        if (m_deferredRings.ScheduleDrain())
+        {
+            std::thread::id noThread;
+            m_logMsgQueueThread->Push(dl_private::LogQueueMessage(
+                "", log_time_point_t{}, "", "", -1, noThread, eLogMessageLevel::process_deferred));
+        }
+    }
+
+    /*!
+     * \brief Set when the log files are flushed.
+     * \param[in] flushPolicy - Flush policy, see LogFlushPolicy.
+     */
+    void SetFlushPolicy(const LogFlushPolicy& flushPolicy)
+    {
+        m_flushMaxMessages.store(flushPolicy.maxMessages, std::memory_order_relaxed);
+        m_flushMaxDelayMs.store(flushPolicy.maxDelay.count(), std::memory_order_relaxed);
+        m_flushOnError.store(flushPolicy.flushOnError, std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Get when the log files are flushed.
+     * \return Flush policy.
+     */
+    LogFlushPolicy FlushPolicy() const
+    {
+        LogFlushPolicy flushPolicy;
+        flushPolicy.maxMessages  = m_flushMaxMessages.load(std::memory_order_relaxed);
+        flushPolicy.maxDelay =
+            std::chrono::milliseconds(m_flushMaxDelayMs.load(std::memory_order_relaxed));
+        flushPolicy.flushOnError = m_flushOnError.load(std::memory_order_relaxed);
+        return flushPolicy;
+    }
+
+    /*!
+     * \brief Set how the log files are rotated.
+     * \param[in] rotationPolicy - Rotation policy, see LogRotationPolicy.
+     *
+     * Rotation happens on the log's thread, if old logs are being compressed
+     * when the log next rotates it waits for the compression to finish.
+     */
+    void SetRotationPolicy(const LogRotationPolicy& rotationPolicy)
+    {
+        std::lock_guard<std::mutex> lock{m_rotationMutex};
+
+        m_rotationPolicy = rotationPolicy;
+
+        if (0 == m_rotationPolicy.generations)
+        {
+            m_rotationPolicy.generations = 1;
+        }
+
+        if (m_rotationPolicy.compressedExt.empty())
+        {
+            m_rotationPolicy.compressedExt = ".gz";
+        }
+
+        m_rotationMaxAgeSecs.store(m_rotationPolicy.maxAge.count(), std::memory_order_relaxed);
+
+        if (m_rotationPolicy.compressor && !m_compressionQueueThread)
+        {
+            m_compressionQueueThread.reset(new compression_queue(
+                [](const std::string&) { return COMPRESS_OLD_LOGS_MESSAGE_ID; },
+                threads::eOnDestroyOptions::processRemainingItems));
+            m_compressionQueueThread->RegisterMessageHandler(
+                COMPRESS_OLD_LOGS_MESSAGE_ID,
+                std::bind(&DebugLog<Formatter>::CompressOldLogs, this, std::placeholders::_1));
+        }
+    }
+
+    /*!
+     * \brief Get how the log files are rotated.
+     * \return Rotation policy.
+     */
+    LogRotationPolicy RotationPolicy() const
+    {
+        std::lock_guard<std::mutex> lock{m_rotationMutex};
+        return m_rotationPolicy;
+    }
+
+    /*!
+     * \brief Set the precision of the time stamps written to the log.
+     * \param[in] precision - Time stamp precision, defaults to whole seconds.
+     *
+     * Only used if the log's formatter has the log_time_point_t overloads
+     * provided by DefaultLogFormat.
+     */
+    void SetTimeStampPrecision(eTimeStampPrecision precision)
+    {
+        m_timeStampPrecision.store(precision, std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Get the precision of the time stamps written to the log.
+     * \return Time stamp precision.
+     */
+    eTimeStampPrecision TimeStampPrecision() const
+    {
+        return m_timeStampPrecision.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Set the size of the ring each thread uses for deferred messages.
+     * \param[in] ringCapacity - Capacity in bytes, applies to rings created after the call.
+     */
+    void SetDeferredRingCapacity(size_t ringCapacity)
+    {
+        m_deferredRings.SetRingCapacity(ringCapacity);
+    }
+
     /*!
      * \brief Retrieve current log file path.
      * \return File path as a string.
@@ -651,7 +1016,7 @@ public:
         std::thread::id noThread;
         m_logMsgQueueThread->Push(
             dl_private::LogQueueMessage("",
-                                        0,
+                                        log_time_point_t{},
                                         "",
                                         "",
                                         -1,
@@ -702,12 +1067,14 @@ private:
     {
         return m_maxLogSize;
     }
-    /*! \brief Register the log queue message ID. */
+    /*! \brief Register the log queue message ID and queue drained handler. */
     void RegisterLogQueueMessageId()
     {
         m_logMsgQueueThread->RegisterMessageHandler(
             dl_private::LogQueueMessage::MESSAGE_ID,
             std::bind(&DebugLog<Formatter>::MessageHandler, this, std::placeholders::_1));
+        m_logMsgQueueThread->RegisterQueueDrainedHandler(
+            std::bind(&DebugLog<Formatter>::QueueDrainedHandler, this));
     }
     /*!
      * \brief Method to decode message ID.
@@ -729,6 +1096,12 @@ private:
      */
     bool MessageHandler(dl_private::LogQueueMessage& message)
     {
+        if (eLogMessageLevel::process_deferred == message.ErrorLevel())
+        {
+            ProcessDeferredMessages();
+            return true;
+        }
+
         // If message target is file or both then write to file.
         if (eMsgTarget::console != message.MsgTarget())
         {
@@ -742,19 +1115,32 @@ private:
             }
             else
             {
-                CheckLogFileSize(static_cast<long>(message.Message().size()),
-                                 m_logFilePath,
-                                 m_oldLogFilePath,
-                                 m_ofStream);
+                if (m_ofStream.is_open() || m_ofStreamMirror.is_open())
+                {
+                    // Format once for both the log and its mirror.
+                    auto const line = FormatMessage(message, m_lineFormatStream);
 
-                CheckLogFileSize(static_cast<long>(message.Message().size()),
-                                 m_mirrorLogFilePath,
-                                 m_oldMirrorLogFilePath,
-                                 m_ofStreamMirror);
+                    CheckLogFileSize(line.size(),
+                                     message.TimeStamp(),
+                                     m_logFilePath,
+                                     m_oldLogFilePath,
+                                     m_ofStream);
 
-                WriteMessageToLog(message, m_ofStream);
+                    CheckLogFileSize(line.size(),
+                                     message.TimeStamp(),
+                                     m_mirrorLogFilePath,
+                                     m_oldMirrorLogFilePath,
+                                     m_ofStreamMirror);
 
-                WriteMessageToLog(message, m_ofStreamMirror);
+                    WriteLineToLog(line, m_ofStream);
+
+                    WriteLineToLog(line, m_ofStreamMirror);
+                }
+
+                if (AddUnflushedMessage(message.ErrorLevel()))
+                {
+                    FlushLogs();
+                }
 
                 // Reduce mutex scope.
                 {
@@ -774,6 +1160,113 @@ private:
 
         return true;
     }
+    /*! \brief Flush the log files once all queued messages have been written. */
+    void QueueDrainedHandler()
+    {
+        if (0 == m_unflushedMessages)
+        {
+            return;
+        }
+
+        FlushLogs();
+
+        std::lock_guard<std::mutex> lock{m_mutex};
+
+        m_logStatus       = m_ofStream.good();
+        m_mirrorLogStatus = m_ofStreamMirror.good();
+    }
+    /*!
+     * \brief Count a message written to the log files and check the flush policy.
+     * \param[in] logMsgLevel - Message level.
+     * \return True if the log files should be flushed now, false otherwise.
+     */
+    bool AddUnflushedMessage(eLogMessageLevel logMsgLevel)
+    {
+        using std::chrono::steady_clock;
+
+        auto const maxDelayMs = m_flushMaxDelayMs.load(std::memory_order_relaxed);
+
+        if ((m_unflushedMessages++ == 0) && (maxDelayMs > 0))
+        {
+            m_firstUnflushedTime = steady_clock::now();
+        }
+
+        if (m_flushOnError.load(std::memory_order_relaxed) &&
+            ((eLogMessageLevel::error == logMsgLevel) || (eLogMessageLevel::fatal == logMsgLevel)))
+        {
+            return true;
+        }
+
+        auto const maxMessages = m_flushMaxMessages.load(std::memory_order_relaxed);
+
+        if ((maxMessages > 0) && (m_unflushedMessages >= maxMessages))
+        {
+            return true;
+        }
+
+        return (maxDelayMs > 0) && (steady_clock::now() - m_firstUnflushedTime >=
+                                    std::chrono::milliseconds(maxDelayMs));
+    }
+    /*! \brief Flush any buffered output to the log files. */
+    void FlushLogs()
+    {
+        if (m_ofStream.is_open())
+        {
+            m_ofStream.flush();
+        }
+
+        if (m_ofStreamMirror.is_open())
+        {
+            m_ofStreamMirror.flush();
+        }
+
+        m_unflushedMessages = 0;
+    }
+    /*! \brief Format and write out all messages waiting in the deferred rings. */
+    void ProcessDeferredMessages()
+    {
+        auto const dropped = m_deferredRings.Drain(
+            [this](const dl_private::DeferredLogRecord& record, const char* args) {
+                try
+                {
+                    m_deferredFormatStream.str("");
+                    m_deferredFormatStream.clear();
+                    record.decoder(m_deferredFormatStream, record.descriptor->format, args);
+
+                    auto const& descriptor = *record.descriptor;
+                    dl_private::LogQueueMessage message(
+                        m_deferredFormatStream.str(),
+                        log_time_point_t(std::chrono::duration_cast<log_time_point_t::duration>(
+                            std::chrono::nanoseconds(record.timeStamp))),
+                        descriptor.file,
+                        descriptor.function,
+                        descriptor.lineNo,
+                        record.threadID,
+                        descriptor.level,
+                        descriptor.msgTarget);
+                    MessageHandler(message);
+                }
+                catch (...)
+                {
+                    // Do nothing.
+                }
+            });
+
+        if (dropped > 0)
+        {
+            auto const      messageTime = std::chrono::system_clock::now();
+            std::thread::id noThread;
+            dl_private::LogQueueMessage message(std::to_string(dropped) +
+                                                    " deferred log messages dropped",
+                                                messageTime,
+                                                "",
+                                                "",
+                                                -1,
+                                                noThread,
+                                                eLogMessageLevel::warning);
+            MessageHandler(message);
+        }
+    }
     /*!
      * \brief Is message level in map.
      * \param[in] logMessageLevel - Message level.
@@ -795,23 +1288,24 @@ private:
                    : m_unknownLogMsgLevel;
     }
     /*!
-     * \brief Is message level in filter set (no mutex).
+     * \brief Bit representing a message level in the filter mask.
      * \param[in] logMessageLevel - Message level.
-     * \return True if message level is found, false otherwise.
+     * \return Mask bit, 0 for the special negative levels which cannot be filtered.
      */
-    bool IsLogMsgLevelFilterSetNoMutex(eLogMessageLevel logMessageLevel) const
+    static uint32_t LogMsgLevelBit(eLogMessageLevel logMessageLevel) NO_EXCEPT_
     {
-        return (m_logMsgFilterSet.find(logMessageLevel) != m_logMsgFilterSet.end());
+        auto const level = static_cast<int>(logMessageLevel);
+        return (level >= 0) && (level < 32) ? (1u << level) : 0u;
     }
     /*!
-     * \brief Is message level in filter set (with mutex).
+     * \brief Is message level in filter mask.
      * \param[in] logMessageLevel - Message level.
      * \return True if message level is found, false otherwise.
      */
-    bool IsLogMsgLevelFilterSet(eLogMessageLevel logMessageLevel) const
+    bool IsLogMsgLevelFilterSet(eLogMessageLevel logMessageLevel) const NO_EXCEPT_
     {
-        std::lock_guard<std::mutex> lock{m_mutex};
-        return IsLogMsgLevelFilterSetNoMutex(logMessageLevel);
+        return (m_logMsgFilterMask.load(std::memory_order_relaxed) &
+                LogMsgLevelBit(logMessageLevel)) != 0;
     }
     /*! \brief Enumeration containing file opening options. */
     enum eFileOpenOptions
@@ -821,6 +1315,14 @@ private:
         /*! \brief Option to append to file when opened. */
         append_file
     };
+    /*! \brief Bookkeeping for an open log file, kept in memory to avoid querying the stream.*/
+    struct LogFileState
+    {
+        /*! \brief Bytes written to the file.*/
+        std::uintmax_t size{0};
+        /*! \brief When the file was opened.*/
+        log_time_point_t openTime;
+    };
     /*!
      * \brief Open file stream.
      * \param[in] filePath - File path.
@@ -838,12 +1340,28 @@ private:
         auto path = filesys::system_complete(filesys::path(filePath));
         filesys::create_directories(path.parent_path());
 
-        ofs.open(path.string(),
-                 fileOptions == eFileOpenOptions::truncate_file ? std::ofstream::trunc
-                                                                : std::ofstream::app);
+        OpenStream(path.string(),
+                   fileOptions == eFileOpenOptions::truncate_file ? std::ofstream::trunc
+                                                                  : std::ofstream::app,
+                   ofs);
+
+        auto& fileState    = FileState(ofs);
+        fileState.size     = 0;
+        fileState.openTime = std::chrono::system_clock::now();
+
+        if (fileOptions == eFileOpenOptions::append_file)
+        {
+            try
+            {
+                fileState.size = filesys::file_size(path);
+            }
+            catch (...)
+            {
+                // Do nothing.
+            }
+        }
 
-        using std::chrono::system_clock;
-        time_t          messageTime = system_clock::to_time_t(system_clock::now());
+        auto const      messageTime = std::chrono::system_clock::now();
         std::thread::id noThread;
         WriteMessageToLog(dl_private::LogQueueMessage("DEBUG LOG STARTED",
                                                       messageTime,
@@ -864,8 +1382,28 @@ private:
                 ofs);
         }
 
+        ofs.flush();
         return ofs.good();
     }
+    /*!
+     * \brief Open a file stream using the log's write buffer for that stream.
+     * \param[in] filePath - File path.
+     * \param[in] mode - Open mode.
+     * \param[in] ofs - File stream to be opened.
+     */
+    void OpenStream(const std::string& filePath, std::ios_base::openmode mode, std::ofstream& ofs)
+    {
+        // Give the stream a larger buffer, it must be set before each open to take effect.
+        auto& buffer = (&ofs == &m_ofStreamMirror) ? m_ofStreamMirrorBuffer : m_ofStreamBuffer;
+
+        if (buffer.empty())
+        {
+            buffer.resize(LOG_STREAM_BUFFER_SIZE);
+        }
+
+        ofs.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        ofs.open(filePath, mode);
+    }
     /*!
      * \brief Close file stream.
      * \param[in] ofs - File stream to be closes.
@@ -877,8 +1415,7 @@ private:
             return;
         }
 
-        using std::chrono::system_clock;
-        time_t          messageTime = system_clock::to_time_t(system_clock::now());
+        auto const      messageTime = std::chrono::system_clock::now();
         std::thread::id noThread;
         WriteMessageToLog(dl_private::LogQueueMessage("DEBUG LOG STOPPED",
                                                       messageTime,
@@ -891,68 +1428,290 @@ private:
         ofs.close();
     }
     /*!
-     * \brief Check size of current log file.
-     * \param[in] requiredSpace - Space required in file to write new message.
+     * \brief Get the bookkeeping for a file stream.
+     * \param[in] ofs - File stream.
+     * \return File state.
+     */
+    LogFileState& FileState(const std::ofstream& ofs)
+    {
+        return (&ofs == &m_ofStreamMirror) ? m_mirrorLogFileState : m_logFileState;
+    }
+    /*!
+     * \brief Rotate the log file if a new line would take it past its size or age limit.
+     * \param[in] requiredSpace - Space required in file to write new line.
+     * \param[in] timeStamp - Time stamp of the new line.
+     * \param[in] logPath - Log file path.
+     * \param[in] oldLogPath - Old log file path.
      * \param[in] ofs - File stream.
      */
-    void CheckLogFileSize(long requiredSpace, std::string const& logPath,
-                          std::string const& oldLogPath, std::ofstream& ofs)
+    void CheckLogFileSize(size_t requiredSpace, const log_time_point_t& timeStamp,
+                          std::string const& logPath, std::string const& oldLogPath,
+                          std::ofstream& ofs)
     {
         if (!ofs.is_open())
         {
             return;
         }
 
-        auto pos = static_cast<long>(ofs.tellp());
+        auto const& fileState = FileState(ofs);
+        auto        rotate =
+            fileState.size + requiredSpace > static_cast<std::uintmax_t>(MaxLogSize());
 
-        if ((MaxLogSize() - pos) < requiredSpace)
+        if (!rotate)
         {
-            CloseOfStream(ofs);
+            auto const maxAgeSecs = m_rotationMaxAgeSecs.load(std::memory_order_relaxed);
 
-#if defined(USE_STD_FILESYSTEM)
-            filesys::copy_file(logPath, oldLogPath, filesys::copy_options::overwrite_existing);
-#else
-#if BOOST_VERSION > 107300
-            filesys::copy_file(logPath, oldLogPath, filesys::copy_options::overwrite_existing);
-#else
-            filesys::copy_file(logPath, oldLogPath, filesys::copy_option::overwrite_if_exists);
-#endif
-#endif
+            rotate = (maxAgeSecs > 0) && (timeStamp != log_time_point_t{}) &&
+                     (timeStamp - fileState.openTime >= std::chrono::seconds(maxAgeSecs));
+        }
 
-            OpenOfStream(logPath, eFileOpenOptions::truncate_file, ofs);
+        if (rotate)
+        {
+            RotateLogFile(logPath, oldLogPath, ofs);
         }
     }
     /*!
-     * \brief Write log message to file stream.
-     * \param[in] logMessage - Log message.
+     * \brief Close the log file, rename it to the old log file and start a new one.
+     * \param[in] logPath - Log file path.
+     * \param[in] oldLogPath - Old log file path.
      * \param[in] ofs - File stream.
      */
-    void WriteMessageToLog(dl_private::LogQueueMessage const& logMessage, std::ofstream& ofs) const
+    void RotateLogFile(std::string const& logPath, std::string const& oldLogPath,
+                       std::ofstream& ofs)
     {
-        if (!ofs.is_open())
+        CloseOfStream(ofs);
+
+        size_t             generations = 1;
+        std::string        compressedExt;
+        compression_queue* compressionQueue = nullptr;
+
         {
-            return;
+            std::lock_guard<std::mutex> lock{m_rotationMutex};
+
+            generations   = m_rotationPolicy.generations;
+            compressedExt = m_rotationPolicy.compressedExt;
+
+            if (m_rotationPolicy.compressor)
+            {
+                compressionQueue = m_compressionQueueThread.get();
+            }
         }
 
+        {
+            // Don't rename old logs while they are being compressed.
+            std::lock_guard<std::mutex> lock{m_compressionMutex};
+
+            // Shift each old log along one generation, dropping the oldest.
+            for (auto generation = generations; generation > 0; --generation)
+            {
+                auto const filePath = OldLogPath(oldLogPath, generation);
+
+                if (generation == generations)
+                {
+                    RemoveFile(filePath);
+                    RemoveFile(filePath + compressedExt);
+                }
+                else
+                {
+                    auto const newFilePath = OldLogPath(oldLogPath, generation + 1);
+                    RenameFile(filePath, newFilePath);
+                    RenameFile(filePath + compressedExt, newFilePath + compressedExt);
+                }
+            }
+
+            RenameFile(logPath, oldLogPath);
+        }
+
+        OpenOfStream(logPath, eFileOpenOptions::truncate_file, ofs);
+
+        if (nullptr != compressionQueue)
+        {
+            compressionQueue->Push(oldLogPath);
+        }
+    }
+    /*!
+     * \brief Compress any uncompressed old logs, called on the compression thread.
+     * \param[in] oldLogPath - Old log file path.
+     * \return True.
+     */
+    bool CompressOldLogs(std::string& oldLogPath)
+    {
+        LogRotationPolicy rotationPolicy;
+
+        {
+            std::lock_guard<std::mutex> lock{m_rotationMutex};
+            rotationPolicy = m_rotationPolicy;
+        }
+
+        if (!rotationPolicy.compressor)
+        {
+            return true;
+        }
+
+        std::lock_guard<std::mutex> lock{m_compressionMutex};
+
+        for (size_t generation = 1; generation <= rotationPolicy.generations; ++generation)
+        {
+            auto const filePath = OldLogPath(oldLogPath, generation);
+
+            try
+            {
+                if (filesys::exists(filePath) &&
+                    rotationPolicy.compressor(filePath, filePath + rotationPolicy.compressedExt))
+                {
+                    filesys::remove(filePath);
+                }
+            }
+            catch (...)
+            {
+                // Do nothing.
+            }
+        }
+
+        return true;
+    }
+    /*!
+     * \brief Build the path of an old log file generation.
+     * \param[in] oldLogPath - Old log file path, e.g. "log_old.txt".
+     * \param[in] generation - Generation, 1 for the most recent.
+     * \return Path, e.g. "log_old.txt" for generation 1 and "log_old_2.txt" for generation 2.
+     */
+    static std::string OldLogPath(std::string const& oldLogPath, size_t generation)
+    {
+        if (generation <= 1)
+        {
+            return oldLogPath;
+        }
+
+        filesys::path p(oldLogPath);
+        auto const    fileName =
+            p.stem().string() + "_" + std::to_string(generation) + p.extension().string();
+        return (p.parent_path() / fileName).string();
+    }
+    /*!
+     * \brief Rename a file if it exists, replacing any existing file.
+     * \param[in] filePath - File path.
+     * \param[in] newFilePath - New file path.
+     */
+    static void RenameFile(std::string const& filePath, std::string const& newFilePath)
+    {
+        try
+        {
+            if (filesys::exists(filePath))
+            {
+                filesys::rename(filePath, newFilePath);
+            }
+        }
+        catch (...)
+        {
+            // Do nothing.
+        }
+    }
+    /*!
+     * \brief Remove a file if it exists.
+     * \param[in] filePath - File path.
+     */
+    static void RemoveFile(std::string const& filePath)
+    {
         try
         {
-            m_logFormatter(ofs,
-                           logMessage.TimeStamp(),
-                           logMessage.Message(),
-                           GetLogMsgLevelAsString(logMessage.ErrorLevel()),
-                           logMessage.File(),
-                           logMessage.Function(),
-                           logMessage.LineNo(),
-                           logMessage.ThreadID(),
-                           m_utcTimeStamps,
-                           m_tzOffset);
-            ofs.flush();
+            filesys::remove(filePath);
         }
         catch (...)
         {
             // Do nothing.
         }
     }
+    /*!
+     * \brief Format a log message for the log file.
+     * \param[in] logMessage - Log message.
+     * \param[in] oss - Stream to format the message in, cleared first.
+     * \return Formatted line, valid until the stream is next modified.
+     */
+    std::string_view FormatMessage(dl_private::LogQueueMessage const& logMessage,
+                                   std::ostringstream& oss) const
+    {
+        oss.str("");
+        oss.clear();
+
+        try
+        {
+            if constexpr (std::is_invocable_v<const Formatter&,
+                                              std::ostream&,
+                                              const log_time_point_t&,
+                                              const std::string&,
+                                              const std::string&,
+                                              const char*,
+                                              const char*,
+                                              int,
+                                              const std::thread::id&,
+                                              bool,
+                                              bool,
+                                              eTimeStampPrecision>)
+            {
+                m_logFormatter(oss,
+                               logMessage.TimeStamp(),
+                               logMessage.Message(),
+                               GetLogMsgLevelAsString(logMessage.ErrorLevel()),
+                               logMessage.File(),
+                               logMessage.Function(),
+                               logMessage.LineNo(),
+                               logMessage.ThreadID(),
+                               m_utcTimeStamps,
+                               m_tzOffset,
+                               TimeStampPrecision());
+            }
+            else
+            {
+                m_logFormatter(oss,
+                               std::chrono::system_clock::to_time_t(logMessage.TimeStamp()),
+                               logMessage.Message(),
+                               GetLogMsgLevelAsString(logMessage.ErrorLevel()),
+                               logMessage.File(),
+                               logMessage.Function(),
+                               logMessage.LineNo(),
+                               logMessage.ThreadID(),
+                               m_utcTimeStamps,
+                               m_tzOffset);
+            }
+        }
+        catch (...)
+        {
+            // Do nothing.
+        }
+
+        return oss.view();
+    }
+    /*!
+     * \brief Write log message to file stream.
+     * \param[in] logMessage - Log message.
+     * \param[in] ofs - File stream.
+     */
+    void WriteMessageToLog(dl_private::LogQueueMessage const& logMessage, std::ofstream& ofs)
+    {
+        if (!ofs.is_open())
+        {
+            return;
+        }
+
+        std::ostringstream oss;
+        WriteLineToLog(FormatMessage(logMessage, oss), ofs);
+    }
+    /*!
+     * \brief Write a formatted line to file stream.
+     * \param[in] line - Formatted line.
+     * \param[in] ofs - File stream.
+     */
+    void WriteLineToLog(std::string_view line, std::ofstream& ofs)
+    {
+        if (!ofs.is_open())
+        {
+            return;
+        }
+
+        ofs.write(line.data(), static_cast<std::streamsize>(line.size()));
+        FileState(ofs).size += line.size();
+    }
 
     void WriteToConsole(dl_private::LogQueueMessage const& logMessage) const
     {
@@ -977,6 +1736,7 @@ private:
             case eLogMessageLevel::fatal:
                 colourCode = ANSI_MAGENTA;
                 break;
+            case eLogMessageLevel::process_deferred:
             case eLogMessageLevel::copy_mirror_log_to_buf:
             case eLogMessageLevel::copy_log_to_buf:
             case eLogMessageLevel::not_defined:
@@ -985,13 +1745,35 @@ private:
                 break;
             }
 
-            m_logFormatter(std::cout,
-                           logMessage.TimeStamp(),
-                           logMessage.Message(),
-                           GetLogMsgLevelAsString(logMessage.ErrorLevel()),
-                           m_utcTimeStamps,
-                           m_tzOffset,
-                           colourCode);
+            if constexpr (std::is_invocable_v<const Formatter&,
+                                              std::ostream&,
+                                              const log_time_point_t&,
+                                              const std::string&,
+                                              const std::string&,
+                                              bool,
+                                              bool,
+                                              eTimeStampPrecision,
+                                              const char*>)
+            {
+                m_logFormatter(std::cout,
+                               logMessage.TimeStamp(),
+                               logMessage.Message(),
+                               GetLogMsgLevelAsString(logMessage.ErrorLevel()),
+                               m_utcTimeStamps,
+                               m_tzOffset,
+                               TimeStampPrecision(),
+                               colourCode);
+            }
+            else
+            {
+                m_logFormatter(std::cout,
+                               std::chrono::system_clock::to_time_t(logMessage.TimeStamp()),
+                               logMessage.Message(),
+                               GetLogMsgLevelAsString(logMessage.ErrorLevel()),
+                               m_utcTimeStamps,
+                               m_tzOffset,
+                               colourCode);
+            }
         }
         catch (...)
         {
@@ -1028,7 +1810,7 @@ private:
 
         if (!m_copyOldLog)
         {
-            ofs.open(logPath, std::ofstream::app);
+            OpenStream(logPath, std::ofstream::app, ofs);
         }
 
         m_logCopyEvent.Signal();
@@ -1060,8 +1842,8 @@ private:
         {eLogMessageLevel::error, "Error"},
         {eLogMessageLevel::fatal, "Fatal"}};
 #endif
-    /*! \brief Message level filter set.*/
-    std::set<eLogMessageLevel> m_logMsgFilterSet;
+    /*! \brief Message level filter mask, one bit per level.*/
+    std::atomic<uint32_t> m_logMsgFilterMask{0};
     /*! \brief Log formatter object.*/
     Formatter m_logFormatter;
     /*! \brief Log file max size.*/
@@ -1072,10 +1854,34 @@ private:
     bool m_utcTimeStamps{false};
     /*! \brief Include TZ offset.*/
     bool m_tzOffset{false};
+    /*! \brief Time stamp precision.*/
+    std::atomic<eTimeStampPrecision> m_timeStampPrecision{eTimeStampPrecision::seconds};
+    /*! \brief Size of each output file stream's write buffer.*/
+    static constexpr size_t LOG_STREAM_BUFFER_SIZE = 64 * 1024;
+    /*! \brief Output file stream write buffer.*/
+    std::vector<char> m_ofStreamBuffer;
+    /*! \brief Output file stream mirror write buffer.*/
+    std::vector<char> m_ofStreamMirrorBuffer;
     /*! \brief Output file stream.*/
     std::ofstream m_ofStream;
     /*! \brief Output file stream mirror.*/
     std::ofstream m_ofStreamMirror;
+    /*! \brief Output file stream state.*/
+    LogFileState m_logFileState;
+    /*! \brief Output file stream mirror state.*/
+    LogFileState m_mirrorLogFileState;
+    /*! \brief Stream reused to format each message.*/
+    std::ostringstream m_lineFormatStream;
+    /*! \brief Flush policy maximum unflushed messages.*/
+    std::atomic<size_t> m_flushMaxMessages{1};
+    /*! \brief Flush policy maximum delay in milliseconds.*/
+    std::atomic<int64_t> m_flushMaxDelayMs{0};
+    /*! \brief Flush policy flush on error.*/
+    std::atomic<bool> m_flushOnError{true};
+    /*! \brief Number of messages written since the log files were last flushed.*/
+    size_t m_unflushedMessages{0};
+    /*! \brief When the oldest unflushed message was written.*/
+    std::chrono::steady_clock::time_point m_firstUnflushedTime;
     /*! \brief Software version string.*/
     std::string m_softwareVersion;
     /*! \brief Path to current log file.*/
@@ -1090,12 +1896,32 @@ private:
     bool m_logStatus{false};
     /*! \brief Status of mirror log.*/
     bool m_mirrorLogStatus{false};
+    /*! \brief Rings holding each thread's deferred messages.*/
+    dl_private::DeferredLogRings m_deferredRings;
+    /*! \brief Stream reused to format deferred messages.*/
+    std::ostringstream m_deferredFormatStream;
+    /*! \brief Mutex to lock access to the rotation policy.*/
+    mutable std::mutex m_rotationMutex;
+    /*! \brief Rotation policy.*/
+    LogRotationPolicy m_rotationPolicy{1, std::chrono::seconds(0), {}, ".gz"};
+    /*! \brief Rotation policy maximum age in seconds.*/
+    std::atomic<int64_t> m_rotationMaxAgeSecs{0};
+    /*! \brief Mutex held while old logs are compressed so they are not rotated meanwhile.*/
+    std::mutex m_compressionMutex;
+    /*! \brief Message ID used on the compression queue.*/
+    static constexpr int COMPRESS_OLD_LOGS_MESSAGE_ID = 1;
+    /*! \brief Typedef for compression queue thread.*/
+    using compression_queue = threads::MessageQueueThread<int, std::string>;
+    /*! \brief Queue thread compressing old logs, created when a compressor is first set.*/
+    std::unique_ptr<compression_queue> m_compressionQueueThread;
     /*! \brief Typedef for message queue thread.*/
     using log_msg_queue = threads::MessageQueueThread<int, dl_private::LogQueueMessage>;
     /*! \brief Unique_ptr holding message queue thread.*/
     std::unique_ptr<log_msg_queue> m_logMsgQueueThread{
         new log_msg_queue(std::bind(&DebugLog<Formatter>::MessageDecoder, std::placeholders::_1),
-                          threads::eOnDestroyOptions::processRemainingItems)};
+                          threads::eOnDestroyOptions::processRemainingItems,
+                          {},
+                          threads::eQueueProcessingMode::batchDrain)};
 };
 
 /*! \brief Typedef defining our default log's type. */
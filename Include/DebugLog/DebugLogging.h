@@ -64,18 +64,24 @@ static constexpr core_lib::log::eLogMessageLevel LOG_LEVEL_FATAL{
  * \param[in] m - Object to be used as message in DebugLog (must be convertible to string via
  * std::ostringstream).
  * \param[in] l - Log message level from enum eLogMessageLevel.
+ *
+ * The level filter is checked first so m is not evaluated if level l is filtered out.
  */
 #define DEBUG_LOG_EX(x, m, l)                                                                      \
     do                                                                                             \
     {                                                                                              \
-        std::ostringstream os;                                                                     \
-        os << m;                                                                                   \
-        x.AddLogMessage(os.str(),                                                                  \
-                        std::string(__FILE__),                                                     \
-                        BOOST_CURRENT_FUNCTION,                                                    \
-                        __LINE__,                                                                  \
-                        l,                                                                         \
-                        core_lib::log::eMsgTarget::file);                                               \
+        auto& debugLog_ = x;                                                                       \
+        if (debugLog_.IsLogMsgLevelEnabled(l))                                                     \
+        {                                                                                          \
+            std::ostringstream os;                                                                 \
+            os << m;                                                                               \
+            debugLog_.AddLogMessage(os.str(),                                                      \
+                                    core_lib::log::LogCallSite{__FILE__,                           \
+                                                               BOOST_CURRENT_FUNCTION,             \
+                                                               __LINE__},                          \
+                                    l,                                                             \
+                                    core_lib::log::eMsgTarget::file);                              \
+        }                                                                                          \
     } while (false)
 
 /*!
@@ -98,18 +104,24 @@ static constexpr core_lib::log::eLogMessageLevel LOG_LEVEL_FATAL{
  * \param[in] m - Object to be used as message in DebugLog (must be convertible to string via
  * std::ostringstream).
  * \param[in] l - Log message level from enum eLogMessageLevel.
+ *
+ * The level filter is checked first so m is not evaluated if level l is filtered out.
  */
 #define DEBUG_LOG_CON_EX(x, m, l)                                                                  \
     do                                                                                             \
     {                                                                                              \
-        std::ostringstream os;                                                                     \
-        os << m;                                                                                   \
-        x.AddLogMessage(os.str(),                                                                  \
-                        std::string(__FILE__),                                                     \
-                        BOOST_CURRENT_FUNCTION,                                                    \
-                        __LINE__,                                                                  \
-                        l,                                                                         \
-                        core_lib::log::eMsgTarget::console);                                            \
+        auto& debugLog_ = x;                                                                       \
+        if (debugLog_.IsLogMsgLevelEnabled(l))                                                     \
+        {                                                                                          \
+            std::ostringstream os;                                                                 \
+            os << m;                                                                               \
+            debugLog_.AddLogMessage(os.str(),                                                      \
+                                    core_lib::log::LogCallSite{__FILE__,                           \
+                                                               BOOST_CURRENT_FUNCTION,             \
+                                                               __LINE__},                          \
+                                    l,                                                             \
+                                    core_lib::log::eMsgTarget::console);                           \
+        }                                                                                          \
     } while (false)
 
 /*!
@@ -132,18 +144,111 @@ static constexpr core_lib::log::eLogMessageLevel LOG_LEVEL_FATAL{
  * \param[in] m - Object to be used as message in DebugLog (must be convertible to string via
  * std::ostringstream).
  * \param[in] l - Log message level from enum eLogMessageLevel.
+ *
+ * The level filter is checked first so m is not evaluated if level l is filtered out.
  */
 #define DEBUG_LOG_BOTH_EX(x, m, l)                                                                 \
     do                                                                                             \
     {                                                                                              \
-        std::ostringstream os;                                                                     \
-        os << m;                                                                                   \
-        x.AddLogMessage(os.str(),                                                                  \
-                        std::string(__FILE__),                                                     \
-                        BOOST_CURRENT_FUNCTION,                                                    \
-                        __LINE__,                                                                  \
-                        l,                                                                         \
-                        core_lib::log::eMsgTarget::both);                                               \
+        auto& debugLog_ = x;                                                                       \
+        if (debugLog_.IsLogMsgLevelEnabled(l))                                                     \
+        {                                                                                          \
+            std::ostringstream os;                                                                 \
+            os << m;                                                                               \
+            debugLog_.AddLogMessage(os.str(),                                                      \
+                                    core_lib::log::LogCallSite{__FILE__,                           \
+                                                               BOOST_CURRENT_FUNCTION,             \
+                                                               __LINE__},                          \
+                                    l,                                                             \
+                                    core_lib::log::eMsgTarget::both);                              \
+        }                                                                                          \
+    } while (false)
+
+/*!
+ * \brief Macro to log a message whose formatting is deferred to the log's thread, to file only.
+ * \param[in] x - DebugLog object.
+ * \param[in] l - Log message level from enum eLogMessageLevel, must be a constant expression.
+ * \param[in] fmt - String literal format, each "{}" is replaced by the next argument.
+ * \param[in] ... - Arguments, must be arithmetic, enum or string types.
+ *
+ * The call site's file, function, line, level and format are captured once in a
+ * static descriptor and only the arguments are copied on each call, see
+ * DebugLog::AddDeferredLogMessage. The arguments are not evaluated if level l is
+ * filtered out.
+ */
+#define DEBUG_LOG_DEFERRED(x, l, fmt, ...)                                                         \
+    do                                                                                             \
+    {                                                                                              \
+        auto& debugLog_ = x;                                                                       \
+        if (debugLog_.IsLogMsgLevelEnabled(l))                                                     \
+        {                                                                                          \
+            static constexpr core_lib::log::DeferredLogDescriptor debugLogDescriptor_{             \
+                __FILE__,                                                                          \
+                BOOST_CURRENT_FUNCTION,                                                            \
+                __LINE__,                                                                          \
+                l,                                                                                 \
+                core_lib::log::eMsgTarget::file,                                                   \
+                fmt};                                                                              \
+            debugLog_.AddDeferredLogMessage(debugLogDescriptor_ __VA_OPT__(, ) __VA_ARGS__);       \
+        }                                                                                          \
+    } while (false)
+
+/*!
+ * \brief Macro to log a message whose formatting is deferred to the log's thread, console only.
+ * \param[in] x - DebugLog object.
+ * \param[in] l - Log message level from enum eLogMessageLevel, must be a constant expression.
+ * \param[in] fmt - String literal format, each "{}" is replaced by the next argument.
+ * \param[in] ... - Arguments, must be arithmetic, enum or string types.
+ *
+ * The call site's file, function, line, level and format are captured once in a
+ * static descriptor and only the arguments are copied on each call, see
+ * DebugLog::AddDeferredLogMessage. The arguments are not evaluated if level l is
+ * filtered out.
+ */
+#define DEBUG_LOG_CON_DEFERRED(x, l, fmt, ...)                                                     \
+    do                                                                                             \
+    {                                                                                              \
+        auto& debugLog_ = x;                                                                       \
+        if (debugLog_.IsLogMsgLevelEnabled(l))                                                     \
+        {                                                                                          \
+            static constexpr core_lib::log::DeferredLogDescriptor debugLogDescriptor_{             \
+                __FILE__,                                                                          \
+                BOOST_CURRENT_FUNCTION,                                                            \
+                __LINE__,                                                                          \
+                l,                                                                                 \
+                core_lib::log::eMsgTarget::console,                                                \
+                fmt};                                                                              \
+            debugLog_.AddDeferredLogMessage(debugLogDescriptor_ __VA_OPT__(, ) __VA_ARGS__);       \
+        }                                                                                          \
+    } while (false)
+
+/*!
+ * \brief Macro to log a message whose formatting is deferred to the log's thread, file and console.
+ * \param[in] x - DebugLog object.
+ * \param[in] l - Log message level from enum eLogMessageLevel, must be a constant expression.
+ * \param[in] fmt - String literal format, each "{}" is replaced by the next argument.
+ * \param[in] ... - Arguments, must be arithmetic, enum or string types.
+ *
+ * The call site's file, function, line, level and format are captured once in a
+ * static descriptor and only the arguments are copied on each call, see
+ * DebugLog::AddDeferredLogMessage. The arguments are not evaluated if level l is
+ * filtered out.
+ */
+#define DEBUG_LOG_BOTH_DEFERRED(x, l, fmt, ...)                                                    \
+    do                                                                                             \
+    {                                                                                              \
+        auto& debugLog_ = x;                                                                       \
+        if (debugLog_.IsLogMsgLevelEnabled(l))                                                     \
+        {                                                                                          \
+            static constexpr core_lib::log::DeferredLogDescriptor debugLogDescriptor_{             \
+                __FILE__,                                                                          \
+                BOOST_CURRENT_FUNCTION,                                                            \
+                __LINE__,                                                                          \
+                l,                                                                                 \
+                core_lib::log::eMsgTarget::both,                                                   \
+                fmt};                                                                              \
+            debugLog_.AddDeferredLogMessage(debugLogDescriptor_ __VA_OPT__(, ) __VA_ARGS__);       \
+        }                                                                                          \
     } while (false)
 
 /*!
@@ -216,7 +321,7 @@ static constexpr core_lib::log::eLogMessageLevel LOG_LEVEL_FATAL{
  * \param[in] m - Object to be used as message in DebugLog (must be convertible to string via
  * std::ostringstream).
  */
-#define DEBUG_LOG_CON_EX_ERROR(x, m) DEBUG_CON_LOG_EX(x, m, LOG_LEVEL_ERROR)
+#define DEBUG_LOG_CON_EX_ERROR(x, m) DEBUG_LOG_CON_EX(x, m, LOG_LEVEL_ERROR)
 
 /*!
  * \brief Simple macro to simplify logging generating message with level fatal, to console only.
@@ -472,6 +577,23 @@ static constexpr core_lib::log::eLogMessageLevel LOG_LEVEL_FATAL{
         }                                                                                          \
     } while (false)
 
+/*!
+ * \brief Macro to log a message whose formatting is deferred to the log's thread, file only.
+ * \param[in] l - Log message level from enum eLogMessageLevel, must be a constant expression.
+ * \param[in] fmt - String literal format, each "{}" is replaced by the next argument.
+ * \param[in] ... - Arguments, must be arithmetic, enum or string types.
+ *
+ *  This version uses a singleton to maintain a global log object.
+ */
+#define DEBUG_MESSAGE_DEFERRED(l, fmt, ...)                                                        \
+    do                                                                                             \
+    {                                                                                              \
+        if (DEBUG_LOG_SINGLETON_EXISTS)                                                            \
+        {                                                                                          \
+            DEBUG_LOG_DEFERRED(DEBUG_LOG_SINGLETON, l, fmt __VA_OPT__(, ) __VA_ARGS__);            \
+        }                                                                                          \
+    } while (false)
+
 /*!
  * \brief Simple macro to simplify logging generating message with level debug, file only.
  * \param[in] m - Object to be used as message in DebugLog (must be convertible to string via
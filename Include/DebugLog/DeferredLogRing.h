@@ -0,0 +1,491 @@
+// This file is part of CoreLibrary containing useful reusable utility
+// classes.
+//
+// Copyright (C) 2014 to present, Duncan Crutchley
+// Contact <15799155+dac1976@users.noreply.github.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License and GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License
+// and GNU Lesser General Public License along with this program. If
+// not, see <http://www.gnu.org/licenses/>.
+
+/*!
+ * \file DeferredLogRing.h
+ * \brief File containing declarations used by DebugLog's deferred logging mode.
+ */
+
+#ifndef DEFERREDLOGRING_H
+#define DEFERREDLOGRING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "CoreLibraryDllGlobal.h"
+#include "Platform/PlatformDefines.h"
+
+/*! \brief The core_lib namespace. */
+namespace core_lib
+{
+/*! \brief The log namespace. */
+namespace log
+{
+
+struct DeferredLogDescriptor;
+
+namespace dl_private
+{
+
+/*!
+ * \brief Function formatting a deferred record's arguments.
+ * \param[out] os - Stream to write the formatted message to.
+ * \param[in] format - Format string, each "{}" is replaced by the next argument.
+ * \param[in] args - Encoded argument bytes.
+ */
+using deferred_decoder_t = void (*)(std::ostream& os, const char* format, const char* args);
+
+/*! \brief Leading part of every record in a DeferredLogRing. */
+struct DeferredLogRecordPrefix
+{
+    /*! \brief Total size of the record in bytes, a multiple of 8. */
+    uint32_t size;
+    /*! \brief Non-zero if the record only pads the ring out to its end. */
+    uint32_t isPadding;
+};
+
+/*! \brief Header of a deferred log record, followed by the encoded arguments. */
+struct DeferredLogRecord
+{
+    /*! \brief Record size and type. */
+    DeferredLogRecordPrefix prefix;
+    /*! \brief Call site descriptor. */
+    const DeferredLogDescriptor* descriptor;
+    /*! \brief Function to format the arguments. */
+    deferred_decoder_t decoder;
+    /*! \brief Time stamp in nanoseconds since the system clock's epoch. */
+    int64_t timeStamp;
+    /*! \brief Thread ID where message originated. */
+    std::thread::id threadID;
+};
+
+static_assert(alignof(DeferredLogRecord) <= 8, "deferred log records must be 8 byte aligned");
+
+/*!
+ * \brief Single producer, single consumer ring of deferred log records.
+ *
+ * Each thread using the deferred logging mode owns one ring per DebugLog that
+ * it writes encoded records into and the log's message queue thread drains
+ * and formats them. Records never straddle the end of the ring, if one does
+ * not fit a padding record fills the remaining space and it starts again at
+ * the beginning.
+ */
+class CORE_LIBRARY_DLL_SHARED_API DeferredLogRing final
+{
+public:
+    /*! \brief Smallest ring capacity in bytes. */
+    static constexpr size_t MIN_CAPACITY = 4096;
+    /*!
+     * \brief Initialisation constructor.
+     * \param[in] capacity - Capacity in bytes, rounded up to a power of 2.
+     */
+    explicit DeferredLogRing(size_t capacity);
+    /*! \brief Destructor. */
+    ~DeferredLogRing() = default;
+    /*! \brief Copy constructor deleted.*/
+    DeferredLogRing(const DeferredLogRing&) = delete;
+    /*! \brief Copy assignment operator deleted.*/
+    DeferredLogRing& operator=(const DeferredLogRing&) = delete;
+    /*! \brief Move constructor deleted.*/
+    DeferredLogRing(DeferredLogRing&&) = delete;
+    /*! \brief Move assignment operator deleted.*/
+    DeferredLogRing& operator=(DeferredLogRing&&) = delete;
+    /*!
+     * \brief Round a record size up to the ring's alignment.
+     * \param[in] size - Record size in bytes.
+     * \return Aligned size.
+     */
+    static constexpr size_t RecordSize(size_t size) NO_EXCEPT_
+    {
+        return (size + 7) & ~static_cast<size_t>(7);
+    }
+    /*!
+     * \brief Capacity of the ring.
+     * \return Capacity in bytes.
+     */
+    size_t Capacity() const NO_EXCEPT_;
+    /*!
+     * \brief Reserve space for a record, producer only.
+     * \param[in] size - Record size, must come from RecordSize.
+     * \return Pointer to write the record to, nullptr if the ring is full.
+     */
+    char* Reserve(size_t size) NO_EXCEPT_;
+    /*! \brief Publish the record last reserved to the consumer, producer only. */
+    void Commit() NO_EXCEPT_;
+    /*! \brief Count a record that could not be reserved, producer only. */
+    void CountDropped() NO_EXCEPT_;
+    /*!
+     * \brief Take ownership of the ring as its producer.
+     * \return True if taken, false if another thread already owns it.
+     */
+    bool TryAcquire() NO_EXCEPT_;
+    /*! \brief Give up ownership of the ring so another thread can use it. */
+    void Release() NO_EXCEPT_;
+    /*!
+     * \brief Pass every published record to a function and free its space, consumer only.
+     * \param[in] onRecord - Function called as onRecord(record, encodedArgs).
+     * \return Number of records dropped since last drained.
+     */
+    template <typename F> uint64_t Drain(F&& onRecord)
+    {
+        auto       head = m_head.load(std::memory_order_relaxed);
+        auto const tail = m_tail.load(std::memory_order_seq_cst);
+
+        while (head != tail)
+        {
+            auto const record = m_buffer + (head & (m_capacity - 1));
+            auto const prefix = reinterpret_cast<const DeferredLogRecordPrefix*>(record);
+            auto const size   = prefix->size;
+
+            if (prefix->isPadding == 0)
+            {
+                onRecord(*reinterpret_cast<const DeferredLogRecord*>(record),
+                         record + sizeof(DeferredLogRecord));
+            }
+
+            head += size;
+            m_head.store(head, std::memory_order_release);
+        }
+
+        return m_dropped.exchange(0, std::memory_order_relaxed);
+    }
+
+private:
+    /*! \brief Capacity in bytes. */
+    const size_t m_capacity;
+    /*! \brief Ring storage, held as 64 bit words for alignment. */
+    std::unique_ptr<uint64_t[]> m_storage;
+    /*! \brief Ring storage as bytes. */
+    char* m_buffer{nullptr};
+    /*! \brief Published write position. */
+    alignas(64) std::atomic<uint64_t> m_tail{0};
+    /*! \brief Write position after the record last reserved. */
+    uint64_t m_pendingTail{0};
+    /*! \brief Producer's last view of the read position. */
+    uint64_t m_cachedHead{0};
+    /*! \brief Number of records dropped because the ring was full. */
+    std::atomic<uint64_t> m_dropped{0};
+    /*! \brief Read position. */
+    alignas(64) std::atomic<uint64_t> m_head{0};
+    /*! \brief Is the ring owned by a producer thread. */
+    std::atomic<bool> m_owned{false};
+};
+
+/*!
+ * \brief Set of deferred log rings belonging to one DebugLog.
+ *
+ * Hands each producer thread its own ring, reusing rings left behind by
+ * threads that have exited, and tracks whether a drain of the rings has
+ * already been scheduled on the log's message queue thread.
+ */
+class CORE_LIBRARY_DLL_SHARED_API DeferredLogRings final
+{
+public:
+    /*! \brief Default capacity of each thread's ring in bytes. */
+    static constexpr size_t DEFAULT_RING_CAPACITY = 1024 * 1024;
+    /*! \brief Default constructor. */
+    DeferredLogRings();
+    /*! \brief Destructor. */
+    ~DeferredLogRings() = default;
+    /*! \brief Copy constructor deleted.*/
+    DeferredLogRings(const DeferredLogRings&) = delete;
+    /*! \brief Copy assignment operator deleted.*/
+    DeferredLogRings& operator=(const DeferredLogRings&) = delete;
+    /*! \brief Move constructor deleted.*/
+    DeferredLogRings(DeferredLogRings&&) = delete;
+    /*! \brief Move assignment operator deleted.*/
+    DeferredLogRings& operator=(DeferredLogRings&&) = delete;
+    /*!
+     * \brief Set the capacity used for rings created from now on.
+     * \param[in] capacity - Capacity in bytes.
+     */
+    void SetRingCapacity(size_t capacity);
+    /*!
+     * \brief Get the calling thread's ring, creating it on first use.
+     * \return Ring owned by the calling thread.
+     */
+    DeferredLogRing* ThisThreadRing();
+    /*!
+     * \brief Note that a record has been committed.
+     * \return True if the caller must schedule a drain, false if one is already pending.
+     */
+    bool ScheduleDrain() NO_EXCEPT_
+    {
+        return !m_drainPending.load(std::memory_order_seq_cst) &&
+               !m_drainPending.exchange(true, std::memory_order_seq_cst);
+    }
+    /*!
+     * \brief Drain all rings, consumer only.
+     * \param[in] onRecord - Function called as onRecord(record, encodedArgs).
+     * \return Number of records dropped since last drained.
+     */
+    template <typename F> uint64_t Drain(F&& onRecord)
+    {
+        // Clear the flag before reading the rings so a record committed
+        // after we have looked at its ring schedules another drain.
+        m_drainPending.store(false, std::memory_order_seq_cst);
+
+        std::lock_guard<std::mutex> lock{m_mutex};
+        uint64_t                    dropped = 0;
+
+        for (auto& ring : m_rings)
+        {
+            dropped += ring->Drain(onRecord);
+        }
+
+        return dropped;
+    }
+
+private:
+    /*!
+     * \brief Find or create a ring for the calling thread.
+     * \return Ring owned by the calling thread.
+     */
+    DeferredLogRing* AcquireRing();
+
+private:
+    /*! \brief Unique ID, distinguishes this set from one later created at the same address. */
+    const uint64_t m_id;
+    /*! \brief Is a drain scheduled. */
+    std::atomic<bool> m_drainPending{false};
+    /*! \brief Access mutex. */
+    std::mutex m_mutex;
+    /*! \brief Capacity for new rings. */
+    size_t m_ringCapacity{DEFAULT_RING_CAPACITY};
+    /*! \brief All rings created. */
+    std::vector<std::shared_ptr<DeferredLogRing>> m_rings;
+};
+
+/*!
+ * \brief Encoding of a deferred log argument.
+ *
+ * Specialised for arithmetic, enum and string types. Other types cannot be
+ * used with the deferred logging mode.
+ */
+template <typename T, typename Enable = void> struct DeferredArgCodec
+{
+    static_assert(sizeof(T) == 0,
+                  "deferred log arguments must be arithmetic, enum or string types");
+};
+
+/*! \brief Encoding of arithmetic and enum arguments, copied as raw bytes. */
+template <typename T>
+struct DeferredArgCodec<T, std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>>>
+{
+    /*!
+     * \brief Encoded size of an argument.
+     * \return Size in bytes.
+     */
+    static size_t Size(T) NO_EXCEPT_
+    {
+        return sizeof(T);
+    }
+    /*!
+     * \brief Encode an argument.
+     * \param[in] out - Where to write it.
+     * \param[in] value - Argument.
+     * \return Position after the encoded argument.
+     */
+    static char* Encode(char* out, T value) NO_EXCEPT_
+    {
+        std::memcpy(out, &value, sizeof(T));
+        return out + sizeof(T);
+    }
+    /*!
+     * \brief Decode an argument and write it to a stream.
+     * \param[out] os - Stream to write to.
+     * \param[in,out] in - Encoded argument, advanced past it.
+     */
+    static void Decode(std::ostream& os, const char*& in)
+    {
+        T value;
+        std::memcpy(&value, in, sizeof(T));
+        in += sizeof(T);
+
+        if constexpr (std::is_enum_v<T>)
+        {
+            os << static_cast<std::underlying_type_t<T>>(value);
+        }
+        else
+        {
+            os << value;
+        }
+    }
+};
+
+/*! \brief Encoding of string arguments, copied as a length and characters. */
+struct DeferredStringCodec
+{
+    /*!
+     * \brief Encoded size of an argument.
+     * \param[in] value - Argument.
+     * \return Size in bytes.
+     */
+    static size_t Size(std::string_view value) NO_EXCEPT_
+    {
+        return sizeof(uint32_t) + value.size();
+    }
+    /*!
+     * \brief Encode an argument.
+     * \param[in] out - Where to write it.
+     * \param[in] value - Argument.
+     * \return Position after the encoded argument.
+     */
+    static char* Encode(char* out, std::string_view value) NO_EXCEPT_
+    {
+        auto const length = static_cast<uint32_t>(value.size());
+        std::memcpy(out, &length, sizeof(length));
+        std::memcpy(out + sizeof(length), value.data(), value.size());
+        return out + sizeof(length) + value.size();
+    }
+    /*!
+     * \brief Decode an argument and write it to a stream.
+     * \param[out] os - Stream to write to.
+     * \param[in,out] in - Encoded argument, advanced past it.
+     */
+    static void Decode(std::ostream& os, const char*& in)
+    {
+        uint32_t length;
+        std::memcpy(&length, in, sizeof(length));
+        os.write(in + sizeof(length), length);
+        in += sizeof(length) + length;
+    }
+};
+
+/*! \brief Encoding of std::string_view arguments. */
+template <> struct DeferredArgCodec<std::string_view> : DeferredStringCodec
+{
+};
+
+/*! \brief Encoding of std::string arguments. */
+template <> struct DeferredArgCodec<std::string> : DeferredStringCodec
+{
+};
+
+/*! \brief Encoding of C string arguments, nullptr is logged as an empty string. */
+template <typename T>
+struct DeferredArgCodec<
+    T, std::enable_if_t<std::is_same_v<T, const char*> || std::is_same_v<T, char*>>>
+{
+    /*!
+     * \brief Encoded size of an argument.
+     * \param[in] value - Argument.
+     * \return Size in bytes.
+     */
+    static size_t Size(const char* value) NO_EXCEPT_
+    {
+        return DeferredStringCodec::Size(value != nullptr ? value : "");
+    }
+    /*!
+     * \brief Encode an argument.
+     * \param[in] out - Where to write it.
+     * \param[in] value - Argument.
+     * \return Position after the encoded argument.
+     */
+    static char* Encode(char* out, const char* value) NO_EXCEPT_
+    {
+        return DeferredStringCodec::Encode(out, value != nullptr ? value : "");
+    }
+    /*!
+     * \brief Decode an argument and write it to a stream.
+     * \param[out] os - Stream to write to.
+     * \param[in,out] in - Encoded argument, advanced past it.
+     */
+    static void Decode(std::ostream& os, const char*& in)
+    {
+        DeferredStringCodec::Decode(os, in);
+    }
+};
+
+/*!
+ * \brief Write a format string up to its next argument placeholder.
+ * \param[out] os - Stream to write to.
+ * \param[in] format - Remaining format string.
+ * \return Position after the "{}" placeholder, or the end of the string if there are no more.
+ */
+CORE_LIBRARY_DLL_SHARED_API const char* WriteDeferredFormat(std::ostream& os, const char* format);
+
+/*!
+ * \brief Format a deferred record's arguments, instantiated per call site's argument types.
+ * \param[out] os - Stream to write the formatted message to.
+ * \param[in] format - Format string, each "{}" is replaced by the next argument.
+ * \param[in] args - Encoded argument bytes.
+ */
+template <typename... Args>
+void DecodeDeferredArgs(std::ostream& os, const char* format, const char* args)
+{
+    ((format = WriteDeferredFormat(os, format), DeferredArgCodec<Args>::Decode(os, args)), ...);
+    os << format;
+    (void)args;
+}
+
+/*!
+ * \brief Encode a deferred log record into a ring.
+ * \param[in] ring - Calling thread's ring.
+ * \param[in] descriptor - Call site descriptor.
+ * \param[in] args - Arguments to encode.
+ * \return True if the record was committed, false if the ring was full.
+ */
+template <typename... Args>
+bool EncodeDeferredLogRecord(DeferredLogRing& ring, const DeferredLogDescriptor& descriptor,
+                             const Args&... args)
+{
+    auto const size = DeferredLogRing::RecordSize(
+        sizeof(DeferredLogRecord) +
+        (size_t{0} + ... + DeferredArgCodec<std::decay_t<Args>>::Size(args)));
+    auto out = ring.Reserve(size);
+
+    if (nullptr == out)
+    {
+        return false;
+    }
+
+    using std::chrono::system_clock;
+    auto const timeStamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               system_clock::now().time_since_epoch())
+                               .count();
+
+    new (out) DeferredLogRecord{{static_cast<uint32_t>(size), 0},
+                                &descriptor,
+                                &DecodeDeferredArgs<std::decay_t<Args>...>,
+                                static_cast<int64_t>(timeStamp),
+                                std::this_thread::get_id()};
+    out += sizeof(DeferredLogRecord);
+    ((out = DeferredArgCodec<std::decay_t<Args>>::Encode(out, args)), ...);
+    ring.Commit();
+    return true;
+}
+
+} // namespace dl_private
+} // namespace log
+} // namespace core_lib
+
+#endif // DEFERREDLOGRING_H
@@ -35,15 +35,18 @@ namespace filesystem
 
 // These functions exist in boost::filesystem but not in std::filesystem.
 // We'll map to the closest equivalent function from std::filesystem.
+// As with boost an empty path is returned unchanged, std::filesystem::absolute
+// would fail on it.
 
 inline path system_complete(const path& p)
 {
-    return absolute(p);
+    return p.empty() ? p : absolute(p);
 }
 
 inline path system_complete(const path& p, error_code& ec)
 {
-    return absolute(p, ec);
+    ec.clear();
+    return p.empty() ? p : absolute(p, ec);
 }
 
 inline path initial_path()
@@ -31,6 +31,8 @@
 #include "SerializationIncludes.h"
 #include <vector>
 #include <sstream>
+#include <streambuf>
+#include <ostream>
 #include <cstring>
 #include <iterator>
 #include <type_traits>
@@ -305,6 +307,161 @@ namespace core_lib
                 }
             };
 
+            /*!
+             * \brief Stream buffer that appends everything written to it onto a char vector.
+             *
+             * Lets stream based archives write straight into the destination vector
+             * rather than into a stringstream that then has to be copied out.
+             */
+            class CharVectorAppendBuf final : public std::streambuf
+            {
+            public:
+                /*!
+                 * \brief Initialisation constructor.
+                 * \param[in] target - Char vector to append to, must outlive this object.
+                 */
+                explicit CharVectorAppendBuf(char_vector_t &target)
+                    : m_target(target)
+                {
+                }
+
+            protected:
+                /*!
+                 * \brief Append a single character.
+                 * \param[in] ch - Character to append.
+                 * \return Anything other than eof on success.
+                 */
+                int_type overflow(int_type ch) override
+                {
+                    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+                    {
+                        m_target.push_back(traits_type::to_char_type(ch));
+                    }
+
+                    return traits_type::not_eof(ch);
+                }
+
+                /*!
+                 * \brief Append a block of characters.
+                 * \param[in] s - Characters to append.
+                 * \param[in] n - Number of characters to append.
+                 * \return Number of characters appended.
+                 */
+                std::streamsize xsputn(const char_type *s, std::streamsize n) override
+                {
+                    m_target.insert(m_target.end(), s, s + n);
+                    return n;
+                }
+
+            private:
+                /*! \brief Char vector being appended to. */
+                char_vector_t &m_target;
+            };
+
+            /*! \brief Minimal MessagePack stream that appends packed bytes onto a char vector. */
+            struct CharVectorAppendWriter
+            {
+                /*! \brief Char vector being appended to. */
+                char_vector_t &target;
+
+                /*!
+                 * \brief Append a block of bytes, called by msgpack::packer.
+                 * \param[in] data - Bytes to append.
+                 * \param[in] len - Number of bytes to append.
+                 */
+                void write(const char *data, size_t len)
+                {
+                    target.insert(target.end(), data, data + len);
+                }
+            };
+
+            /*!
+             * \brief Serialization appending to char vector implementation.
+             *
+             * Unlike ToCharVectorImpl the serialized bytes are written after whatever
+             * the vector already holds, with no intermediate buffer, so a caller can
+             * reserve space for a header and have the archive fill in the rest.
+             */
+            template <typename T, typename A>
+            struct AppendToCharVectorImpl
+            {
+                /*!
+                 * \brief Function operator
+                 * \param[in] object - Object to serialize
+                 * \param[in,out] result - Char vector the serialized object is appended to
+                 */
+                void operator()(const T &object, char_vector_t &result) const
+                {
+                    CharVectorAppendBuf buf(result);
+                    std::ostream        os(&buf);
+                    // Reduce scope of archive to make sure it has
+                    // flushed its contents to the stream before
+                    // we try and do anything with it.
+                    {
+                        A oa(os);
+                        // CEREAL_NVP / BOOST_SERIALIZATION_NVP is required to fully support xml archives.
+                        SERIALIZE_TO_STREAM_ARCHIVE(oa, object);
+                    }
+                }
+            };
+
+            /*! \brief Serialization appending to char vector implementation, specialization for POD. */
+            template <typename T>
+            struct AppendToCharVectorImpl<T, archives::out_raw_t>
+            {
+                /*!
+                 * \brief Function operator
+                 * \param[in] object - Object to serialize
+                 * \param[in,out] result - Char vector the serialized object is appended to
+                 */
+                void operator()(const T &object, char_vector_t &result) const
+                {
+                    static_assert(std::is_trivially_copyable<T>::value, "object should be POD");
+
+                    auto begin = reinterpret_cast<char const *>(&object);
+                    result.insert(result.end(), begin, std::next(begin, static_cast<int>(sizeof(T))));
+                }
+            };
+
+            /*! \brief Serialization appending to char vector implementation, specialization for Google protocol bufs. */
+            template <typename T>
+            struct AppendToCharVectorImpl<T, archives::out_protobuf_t>
+            {
+                /*!
+                 * \brief Function operator
+                 * \param[in] object - Object to serialize
+                 * \param[in,out] result - Char vector the serialized object is appended to
+                 */
+                void operator()(const T &object, char_vector_t &result) const
+                {
+                    const auto offset = result.size();
+                    const auto len    = object.ByteSizeLong();
+                    result.resize(offset + len);
+
+                    if (!object.SerializeToArray(result.data() + offset, static_cast<int>(len)))
+                    {
+                        result.resize(offset);
+                        BOOST_THROW_EXCEPTION(std::runtime_error("failed to serialize protocol buffer"));
+                    }
+                }
+            };
+
+            /*! \brief Serialization appending to char vector implementation, specialization for Messagepack bufs. */
+            template <typename T>
+            struct AppendToCharVectorImpl<T, archives::out_msgpack_t>
+            {
+                /*!
+                 * \brief Function operator
+                 * \param[in] object - Object to serialize
+                 * \param[in,out] result - Char vector the serialized object is appended to
+                 */
+                void operator()(const T &object, char_vector_t &result) const
+                {
+                    CharVectorAppendWriter writer{result};
+                    msgpack::pack(writer, object);
+                }
+            };
+
             /*!
              * \brief Deserialization to object implementation.
              *
@@ -445,6 +602,20 @@ namespace core_lib
             impl::ToCharVectorImpl<T, OA>()(object, result);
         }
 
+        /*!
+         * \brief Serialize an object onto the end of a char vector.
+         * \param[in] object - A serializable object of type T.
+         * \param[in,out] result - A char vector the serialized object is appended to.
+         *
+         * Existing contents of result are preserved, the serialized bytes are written
+         * directly after them without going through an intermediate buffer.
+         */
+        template <typename T, typename OA = archives::out_port_bin_t>
+        void AppendToCharVector(const T &object, char_vector_t &result)
+        {
+            impl::AppendToCharVectorImpl<T, OA>()(object, result);
+        }
+
         /*!
          * \brief Deserialize a char vector into a corresponding object.
          * \param[in] charVector - A char vector containing a boost serialized object of type T.
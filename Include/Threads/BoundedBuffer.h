@@ -29,9 +29,13 @@
 
 #include <mutex>
 #include <condition_variable>
-#include <functional>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <utility>
 #include <boost/circular_buffer.hpp>
 #include <boost/call_traits.hpp>
+#include "RingQueue.h"
 
 /*! \brief The core_lib namespace. */
 namespace core_lib
@@ -40,6 +44,13 @@ namespace core_lib
 namespace threads
 {
 
+/*! \brief Enumeration defining which threads may access a bounded buffer. */
+enum class eBufferAccess
+{
+    multiProducerConsumer,
+    singleProducerConsumer
+};
+
 /*!
  * \brief Class defining a bounded buffer.
  *
@@ -48,10 +59,20 @@ namespace threads
  * the producer thread when full. It acts like a bounded
  * single producer/single consumer queue.
  *
+ * As well as the blocking PushFront/PopBack there are Try and
+ * Timed variants that never block or give up after a timeout,
+ * and PushFrontN/PopBackN which transfer as many items as will
+ * fit, or are available, under a single lock acquisition.
+ * Items are moved in and out so move-only types are supported.
+ *
+ * Use eBufferAccess::singleProducerConsumer when exactly one
+ * thread pushes and one thread pops to get a lock-free version.
+ *
  * This code is based on the example given in the boost circular
  * buffer documentation.
  */
-template <typename T> class BoundedBuffer final
+template <typename T, eBufferAccess Access = eBufferAccess::multiProducerConsumer>
+class BoundedBuffer final
 {
 public:
     /*! \brief Typedef for container type. */
@@ -80,6 +101,31 @@ public:
     BoundedBuffer(BoundedBuffer&&) = delete;
     /*! \brief Move assignment operator deleted.*/
     BoundedBuffer& operator=(BoundedBuffer&&) = delete;
+    /*!
+     * \brief Buffer capacity.
+     * \return Maximum number of unread items.
+     */
+    size_type Capacity() const
+    {
+        return m_container.capacity();
+    }
+    /*!
+     * \brief Number of unread items.
+     * \return Number of items waiting to be popped.
+     */
+    size_type Size() const
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_unreadCount;
+    }
+    /*!
+     * \brief Is the buffer empty.
+     * \return True if there are no unread items, false otherwise.
+     */
+    bool Empty() const
+    {
+        return Size() == 0;
+    }
     /*!
      * \brief Push new item to the front.
      * \param[in] item - The item to push to the front.
@@ -87,17 +133,86 @@ public:
      * This function blocks if the buffer is at
      * capacity.
      */
-    void PushFront(param_type item)
+    void PushFront(const value_type& item)
+    {
+        EmplaceFront(item);
+    }
+    /*!
+     * \brief Push new item to the front.
+     * \param[in] item - The item to move to the front.
+     *
+     * This function blocks if the buffer is at
+     * capacity.
+     */
+    void PushFront(value_type&& item)
+    {
+        EmplaceFront(std::move(item));
+    }
+    /*!
+     * \brief Construct a new item at the front.
+     * \param[in] args - Arguments to construct the item with.
+     *
+     * This function blocks if the buffer is at
+     * capacity.
+     */
+    template <typename... Args> void EmplaceFront(Args&&... args)
     {
         {
             std::unique_lock<std::mutex> lock{m_mutex};
-            m_notFullEvent.wait(lock, std::bind(&BoundedBuffer<value_type>::IsNotFull, this));
-            m_container.push_front(item);
+            m_notFullEvent.wait(lock, [this] { return IsNotFull(); });
+            m_container.push_front(value_type(std::forward<Args>(args)...));
             ++m_unreadCount;
         }
 
         m_notEmptyEvent.notify_one();
     }
+    /*!
+     * \brief Try and push new item to the front without blocking.
+     * \param[in] item - The item to push, only moved from if pushed.
+     * \return True if pushed, false if the buffer was at capacity.
+     */
+    template <typename U> bool TryPushFront(U&& item)
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+
+            if (!IsNotFull())
+            {
+                return false;
+            }
+
+            m_container.push_front(std::forward<U>(item));
+            ++m_unreadCount;
+        }
+
+        m_notEmptyEvent.notify_one();
+        return true;
+    }
+    /*!
+     * \brief Push new item to the front, waiting for space up to a timeout.
+     * \param[in] timeoutMilliseconds - Maximum time to wait for space.
+     * \param[in] item - The item to push, only moved from if pushed.
+     * \return True if pushed, false if timed out.
+     */
+    template <typename U> bool TimedPushFront(unsigned int timeoutMilliseconds, U&& item)
+    {
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+
+            if (!m_notFullEvent.wait_for(lock,
+                                         std::chrono::milliseconds(timeoutMilliseconds),
+                                         [this] { return IsNotFull(); }))
+            {
+                return false;
+            }
+
+            m_container.push_front(std::forward<U>(item));
+            ++m_unreadCount;
+        }
+
+        m_notEmptyEvent.notify_one();
+        return true;
+    }
     /*!
      * \brief Pop item from the back.
      * \param[out] item - The item to pop from the back.
@@ -109,16 +224,115 @@ public:
     {
         {
             std::unique_lock<std::mutex> lock{m_mutex};
-            m_notEmptyEvent.wait(lock, std::bind(&BoundedBuffer<value_type>::IsNotEmpty, this));
-            item = m_container[--m_unreadCount];
+            m_notEmptyEvent.wait(lock, [this] { return IsNotEmpty(); });
+            item = std::move(m_container[--m_unreadCount]);
         }
 
         m_notFullEvent.notify_one();
     }
+    /*!
+     * \brief Try and pop item from the back without blocking.
+     * \param[out] item - The item popped, only valid if returns true.
+     * \return True if popped, false if the buffer was empty.
+     */
+    bool TryPopBack(value_type& item)
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+
+            if (!IsNotEmpty())
+            {
+                return false;
+            }
+
+            item = std::move(m_container[--m_unreadCount]);
+        }
+
+        m_notFullEvent.notify_one();
+        return true;
+    }
+    /*!
+     * \brief Pop item from the back, waiting for one up to a timeout.
+     * \param[in] timeoutMilliseconds - Maximum time to wait for an item.
+     * \param[out] item - The item popped, only valid if returns true.
+     * \return True if popped, false if timed out.
+     */
+    bool TimedPopBack(unsigned int timeoutMilliseconds, value_type& item)
+    {
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+
+            if (!m_notEmptyEvent.wait_for(lock,
+                                          std::chrono::milliseconds(timeoutMilliseconds),
+                                          [this] { return IsNotEmpty(); }))
+            {
+                return false;
+            }
+
+            item = std::move(m_container[--m_unreadCount]);
+        }
+
+        m_notFullEvent.notify_one();
+        return true;
+    }
+    /*!
+     * \brief Push a range of items to the front.
+     * \param[in] first - Iterator to the first item, items pushed are moved from.
+     * \param[in] count - Number of items in the range.
+     * \return Number of items pushed.
+     *
+     * This function blocks until there is space for at least one item then
+     * pushes as many of the items as will fit under the one lock.
+     */
+    template <typename InputIt> size_type PushFrontN(InputIt first, size_type count)
+    {
+        return PushFrontNImpl(first, count, nullptr);
+    }
+    /*!
+     * \brief Push a range of items to the front, waiting for space up to a timeout.
+     * \param[in] timeoutMilliseconds - Maximum time to wait for space.
+     * \param[in] first - Iterator to the first item, items pushed are moved from.
+     * \param[in] count - Number of items in the range.
+     * \return Number of items pushed, 0 if timed out.
+     */
+    template <typename InputIt>
+    size_type TimedPushFrontN(unsigned int timeoutMilliseconds, InputIt first, size_type count)
+    {
+        const auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMilliseconds);
+        return PushFrontNImpl(first, count, &deadline);
+    }
+    /*!
+     * \brief Pop a range of items from the back.
+     * \param[out] out - Iterator to write the items to, oldest first.
+     * \param[in] maxCount - Maximum number of items to pop.
+     * \return Number of items popped.
+     *
+     * This function blocks until at least one item is available then
+     * pops up to maxCount items under the one lock.
+     */
+    template <typename OutputIt> size_type PopBackN(OutputIt out, size_type maxCount)
+    {
+        return PopBackNImpl(out, maxCount, nullptr);
+    }
+    /*!
+     * \brief Pop a range of items from the back, waiting for one up to a timeout.
+     * \param[in] timeoutMilliseconds - Maximum time to wait for an item.
+     * \param[out] out - Iterator to write the items to, oldest first.
+     * \param[in] maxCount - Maximum number of items to pop.
+     * \return Number of items popped, 0 if timed out.
+     */
+    template <typename OutputIt>
+    size_type TimedPopBackN(unsigned int timeoutMilliseconds, OutputIt out, size_type maxCount)
+    {
+        const auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMilliseconds);
+        return PopBackNImpl(out, maxCount, &deadline);
+    }
 
 private:
     /*! \brief Synchronization mutex. */
-    std::mutex m_mutex;
+    mutable std::mutex m_mutex;
     /*! \brief Condition variable to flag not empty. */
     std::condition_variable m_notEmptyEvent;
     /*! \brief Condition variable to flag not full. */
@@ -143,6 +357,516 @@ private:
     {
         return m_unreadCount < m_container.capacity();
     }
+    /*!
+     * \brief Wait on a condition variable for a predicate to hold.
+     * \param[in] lock - Lock on m_mutex.
+     * \param[in] condition - Condition variable to wait on.
+     * \param[in] pred - Predicate to wait for.
+     * \param[in] deadline - Optional time at which to give up.
+     * \return True if the predicate holds, false if timed out.
+     */
+    template <typename Pred>
+    static bool WaitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& condition,
+                          Pred pred, const std::chrono::steady_clock::time_point* deadline)
+    {
+        if (nullptr == deadline)
+        {
+            condition.wait(lock, pred);
+            return true;
+        }
+
+        return condition.wait_until(lock, *deadline, pred);
+    }
+    /*!
+     * \brief Push a range of items once there is space.
+     * \param[in] first - Iterator to the first item.
+     * \param[in] count - Number of items in the range.
+     * \param[in] deadline - Optional time at which to give up.
+     * \return Number of items pushed.
+     */
+    template <typename InputIt>
+    size_type PushFrontNImpl(InputIt first, size_type count,
+                             const std::chrono::steady_clock::time_point* deadline)
+    {
+        if (count == 0)
+        {
+            return 0;
+        }
+
+        size_type pushed{0};
+
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+
+            if (!WaitUntil(lock, m_notFullEvent, [this] { return IsNotFull(); }, deadline))
+            {
+                return 0;
+            }
+
+            for (; (pushed < count) && IsNotFull(); ++pushed, ++first)
+            {
+                m_container.push_front(std::move(*first));
+                ++m_unreadCount;
+            }
+        }
+
+        if (pushed > 1)
+        {
+            m_notEmptyEvent.notify_all();
+        }
+        else
+        {
+            m_notEmptyEvent.notify_one();
+        }
+
+        return pushed;
+    }
+    /*!
+     * \brief Pop a range of items once there are any.
+     * \param[out] out - Iterator to write the items to.
+     * \param[in] maxCount - Maximum number of items to pop.
+     * \param[in] deadline - Optional time at which to give up.
+     * \return Number of items popped.
+     */
+    template <typename OutputIt>
+    size_type PopBackNImpl(OutputIt out, size_type maxCount,
+                           const std::chrono::steady_clock::time_point* deadline)
+    {
+        if (maxCount == 0)
+        {
+            return 0;
+        }
+
+        size_type popped{0};
+
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+
+            if (!WaitUntil(lock, m_notEmptyEvent, [this] { return IsNotEmpty(); }, deadline))
+            {
+                return 0;
+            }
+
+            for (; (popped < maxCount) && IsNotEmpty(); ++popped, ++out)
+            {
+                *out = std::move(m_container[--m_unreadCount]);
+            }
+        }
+
+        if (popped > 1)
+        {
+            m_notFullEvent.notify_all();
+        }
+        else
+        {
+            m_notFullEvent.notify_one();
+        }
+
+        return popped;
+    }
+};
+
+/*!
+ * \brief Lock-free bounded buffer for exactly one producer and one consumer.
+ *
+ * Offers the same interface as the general BoundedBuffer but is built on
+ * a lock-free single-producer/single-consumer ring. The capacity is rounded
+ * up to a power of two. A blocking call spins briefly before parking the
+ * thread and the other side only takes the parking mutex when it knows a
+ * thread is parked.
+ *
+ * The template T must be default constructible and movable.
+ */
+template <typename T> class BoundedBuffer<T, eBufferAccess::singleProducerConsumer> final
+{
+public:
+    /*! \brief Typedef for container size type. */
+    using size_type = size_t;
+    /*! \brief Typedef for container value type. */
+    using value_type = T;
+    /*! \brief Typedef for container param type. */
+    using param_type = typename boost::call_traits<value_type>::param_type;
+    /*!
+     * \brief Constructor.
+     * \param[in] capacity - The capacity, rounded up to a power of two.
+     */
+    explicit BoundedBuffer(size_type capacity)
+        : m_ring{capacity}
+    {
+    }
+    /*! \brief Default destructor.*/
+    ~BoundedBuffer() = default;
+    /*! \brief Copy constructor deleted.*/
+    BoundedBuffer(const BoundedBuffer&) = delete;
+    /*! \brief Copy assignment operator deleted.*/
+    BoundedBuffer& operator=(const BoundedBuffer&) = delete;
+    /*! \brief Move constructor deleted.*/
+    BoundedBuffer(BoundedBuffer&&) = delete;
+    /*! \brief Move assignment operator deleted.*/
+    BoundedBuffer& operator=(BoundedBuffer&&) = delete;
+    /*!
+     * \brief Buffer capacity.
+     * \return Maximum number of unread items.
+     */
+    size_type Capacity() const
+    {
+        return m_ring.Capacity();
+    }
+    /*!
+     * \brief Approximate number of unread items.
+     * \return Number of items, exact only when there is no concurrent access.
+     */
+    size_type Size() const
+    {
+        return m_ring.Size();
+    }
+    /*!
+     * \brief Is the buffer empty.
+     * \return True if there are no unread items, false otherwise.
+     */
+    bool Empty() const
+    {
+        return Size() == 0;
+    }
+    /*!
+     * \brief Push new item to the front, producer thread only.
+     * \param[in] item - The item to push to the front.
+     *
+     * This function blocks if the buffer is at
+     * capacity.
+     */
+    void PushFront(const value_type& item)
+    {
+        PushWait([this, &item] { return m_ring.TryPush(item); }, nullptr);
+    }
+    /*!
+     * \brief Push new item to the front, producer thread only.
+     * \param[in] item - The item to move to the front.
+     *
+     * This function blocks if the buffer is at
+     * capacity.
+     */
+    void PushFront(value_type&& item)
+    {
+        PushWait([this, &item] { return m_ring.TryPush(std::move(item)); }, nullptr);
+    }
+    /*!
+     * \brief Construct a new item at the front, producer thread only.
+     * \param[in] args - Arguments to construct the item with.
+     *
+     * This function blocks if the buffer is at
+     * capacity.
+     */
+    template <typename... Args> void EmplaceFront(Args&&... args)
+    {
+        PushFront(value_type(std::forward<Args>(args)...));
+    }
+    /*!
+     * \brief Try and push new item to the front without blocking, producer thread only.
+     * \param[in] item - The item to push, only moved from if pushed.
+     * \return True if pushed, false if the buffer was at capacity.
+     */
+    template <typename U> bool TryPushFront(U&& item)
+    {
+        if (!m_ring.TryPush(std::forward<U>(item)))
+        {
+            return false;
+        }
+
+        Wake(m_consumerParked, m_notEmptyEvent);
+        return true;
+    }
+    /*!
+     * \brief Push new item to the front, waiting for space up to a timeout, producer thread only.
+     * \param[in] timeoutMilliseconds - Maximum time to wait for space.
+     * \param[in] item - The item to push, only moved from if pushed.
+     * \return True if pushed, false if timed out.
+     */
+    template <typename U> bool TimedPushFront(unsigned int timeoutMilliseconds, U&& item)
+    {
+        const auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMilliseconds);
+        return PushWait([this, &item] { return m_ring.TryPush(std::forward<U>(item)); },
+                        &deadline);
+    }
+    /*!
+     * \brief Pop item from the back, consumer thread only.
+     * \param[out] item - The item to pop from the back.
+     *
+     * This function blocks if the buffer is empty.
+     */
+    void PopBack(value_type& item)
+    {
+        PopWait([this, &item] { return m_ring.TryPop(item); }, nullptr);
+    }
+    /*!
+     * \brief Try and pop item from the back without blocking, consumer thread only.
+     * \param[out] item - The item popped, only valid if returns true.
+     * \return True if popped, false if the buffer was empty.
+     */
+    bool TryPopBack(value_type& item)
+    {
+        if (!m_ring.TryPop(item))
+        {
+            return false;
+        }
+
+        Wake(m_producerParked, m_notFullEvent);
+        return true;
+    }
+    /*!
+     * \brief Pop item from the back, waiting for one up to a timeout, consumer thread only.
+     * \param[in] timeoutMilliseconds - Maximum time to wait for an item.
+     * \param[out] item - The item popped, only valid if returns true.
+     * \return True if popped, false if timed out.
+     */
+    bool TimedPopBack(unsigned int timeoutMilliseconds, value_type& item)
+    {
+        const auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMilliseconds);
+        return PopWait([this, &item] { return m_ring.TryPop(item); }, &deadline);
+    }
+    /*!
+     * \brief Push a range of items to the front, producer thread only.
+     * \param[in] first - Iterator to the first item, items pushed are moved from.
+     * \param[in] count - Number of items in the range.
+     * \return Number of items pushed.
+     *
+     * This function blocks until there is space for at least one item then
+     * pushes as many of the items as will fit, waking the consumer once.
+     */
+    template <typename InputIt> size_type PushFrontN(InputIt first, size_type count)
+    {
+        return PushFrontNImpl(first, count, nullptr);
+    }
+    /*!
+     * \brief Push a range of items to the front, waiting for space up to a timeout.
+     * \param[in] timeoutMilliseconds - Maximum time to wait for space.
+     * \param[in] first - Iterator to the first item, items pushed are moved from.
+     * \param[in] count - Number of items in the range.
+     * \return Number of items pushed, 0 if timed out.
+     */
+    template <typename InputIt>
+    size_type TimedPushFrontN(unsigned int timeoutMilliseconds, InputIt first, size_type count)
+    {
+        const auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMilliseconds);
+        return PushFrontNImpl(first, count, &deadline);
+    }
+    /*!
+     * \brief Pop a range of items from the back, consumer thread only.
+     * \param[out] out - Iterator to write the items to, oldest first.
+     * \param[in] maxCount - Maximum number of items to pop.
+     * \return Number of items popped.
+     *
+     * This function blocks until at least one item is available then
+     * pops up to maxCount items, waking the producer once.
+     */
+    template <typename OutputIt> size_type PopBackN(OutputIt out, size_type maxCount)
+    {
+        return PopBackNImpl(out, maxCount, nullptr);
+    }
+    /*!
+     * \brief Pop a range of items from the back, waiting for one up to a timeout.
+     * \param[in] timeoutMilliseconds - Maximum time to wait for an item.
+     * \param[out] out - Iterator to write the items to, oldest first.
+     * \param[in] maxCount - Maximum number of items to pop.
+     * \return Number of items popped, 0 if timed out.
+     */
+    template <typename OutputIt>
+    size_type TimedPopBackN(unsigned int timeoutMilliseconds, OutputIt out, size_type maxCount)
+    {
+        const auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMilliseconds);
+        return PopBackNImpl(out, maxCount, &deadline);
+    }
+
+private:
+    /*! \brief Number of attempts made on the ring before a blocking call parks. */
+    static constexpr int SPIN_COUNT = 128;
+    /*! \brief Number of those attempts made before yielding between attempts. */
+    static constexpr int BUSY_SPIN_COUNT = 32;
+
+    /*! \brief Underlying lock-free ring. */
+    ring_impl::SpscRing<T> m_ring;
+    /*! \brief Mutex only used while parking or waking a thread. */
+    std::mutex m_mutex;
+    /*! \brief Condition variable to flag not empty. */
+    std::condition_variable m_notEmptyEvent;
+    /*! \brief Condition variable to flag not full. */
+    std::condition_variable m_notFullEvent;
+    /*! \brief Is the consumer parked. */
+    std::atomic<bool> m_consumerParked{false};
+    /*! \brief Is the producer parked. */
+    std::atomic<bool> m_producerParked{false};
+
+    /*!
+     * \brief Wake the other side if, and only if, it is parked.
+     * \param[in] parked - Parked flag of the other side.
+     * \param[in] condition - Condition the other side waits on.
+     */
+    void Wake(std::atomic<bool>& parked, std::condition_variable& condition)
+    {
+        // Pairs with the fence in Park: either the parked thread sees our
+        // change to the ring or we see its flag.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (parked.load(std::memory_order_relaxed))
+        {
+            {
+                std::lock_guard<std::mutex> lock{m_mutex};
+            }
+
+            condition.notify_one();
+        }
+    }
+    /*!
+     * \brief Retry an operation on the ring, spinning then parking until it succeeds.
+     * \param[in] tryOp - Operation to retry, returns true on success.
+     * \param[in] parked - Our parked flag.
+     * \param[in] condition - Condition to park on.
+     * \param[in] deadline - Optional time at which to give up.
+     * \return True if the operation succeeded, false if timed out.
+     */
+    template <typename F>
+    bool Park(F tryOp, std::atomic<bool>& parked, std::condition_variable& condition,
+              const std::chrono::steady_clock::time_point* deadline)
+    {
+        for (int spin = 0; spin < SPIN_COUNT; ++spin)
+        {
+            if (tryOp())
+            {
+                return true;
+            }
+
+            if (spin >= BUSY_SPIN_COUNT)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        bool done{false};
+        parked.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+
+            for (;;)
+            {
+                if (tryOp())
+                {
+                    done = true;
+                    break;
+                }
+
+                if (nullptr == deadline)
+                {
+                    condition.wait(lock);
+                }
+                else if (condition.wait_until(lock, *deadline) == std::cv_status::timeout)
+                {
+                    done = tryOp();
+                    break;
+                }
+            }
+        }
+
+        parked.store(false, std::memory_order_relaxed);
+        return done;
+    }
+    /*!
+     * \brief Push using an operation on the ring, waiting for space.
+     * \param[in] tryPush - Push operation, returns true on success.
+     * \param[in] deadline - Optional time at which to give up.
+     * \return True if pushed, false if timed out.
+     */
+    template <typename F>
+    bool PushWait(F tryPush, const std::chrono::steady_clock::time_point* deadline)
+    {
+        if (!Park(tryPush, m_producerParked, m_notFullEvent, deadline))
+        {
+            return false;
+        }
+
+        Wake(m_consumerParked, m_notEmptyEvent);
+        return true;
+    }
+    /*!
+     * \brief Pop using an operation on the ring, waiting for an item.
+     * \param[in] tryPop - Pop operation, returns true on success.
+     * \param[in] deadline - Optional time at which to give up.
+     * \return True if popped, false if timed out.
+     */
+    template <typename F>
+    bool PopWait(F tryPop, const std::chrono::steady_clock::time_point* deadline)
+    {
+        if (!Park(tryPop, m_consumerParked, m_notEmptyEvent, deadline))
+        {
+            return false;
+        }
+
+        Wake(m_producerParked, m_notFullEvent);
+        return true;
+    }
+    /*!
+     * \brief Push a range of items once there is space.
+     * \param[in] first - Iterator to the first item.
+     * \param[in] count - Number of items in the range.
+     * \param[in] deadline - Optional time at which to give up.
+     * \return Number of items pushed.
+     */
+    template <typename InputIt>
+    size_type PushFrontNImpl(InputIt first, size_type count,
+                             const std::chrono::steady_clock::time_point* deadline)
+    {
+        size_type pushed{0};
+        auto      tryPush = [this, &first, &pushed, count] {
+            for (; (pushed < count) && m_ring.TryPush(std::move(*first)); ++pushed, ++first)
+            {
+            }
+
+            return pushed > 0;
+        };
+
+        if ((count == 0) || !Park(tryPush, m_producerParked, m_notFullEvent, deadline))
+        {
+            return 0;
+        }
+
+        Wake(m_consumerParked, m_notEmptyEvent);
+        return pushed;
+    }
+    /*!
+     * \brief Pop a range of items once there are any.
+     * \param[out] out - Iterator to write the items to.
+     * \param[in] maxCount - Maximum number of items to pop.
+     * \param[in] deadline - Optional time at which to give up.
+     * \return Number of items popped.
+     */
+    template <typename OutputIt>
+    size_type PopBackNImpl(OutputIt out, size_type maxCount,
+                           const std::chrono::steady_clock::time_point* deadline)
+    {
+        size_type popped{0};
+        T         item;
+        auto      tryPop = [this, &out, &popped, &item, maxCount] {
+            for (; (popped < maxCount) && m_ring.TryPop(item); ++popped, ++out)
+            {
+                *out = std::move(item);
+            }
+
+            return popped > 0;
+        };
+
+        if ((maxCount == 0) || !Park(tryPop, m_consumerParked, m_notEmptyEvent, deadline))
+        {
+            return 0;
+        }
+
+        Wake(m_producerParked, m_notFullEvent);
+        return popped;
+    }
 };
 
 } // namespace threads
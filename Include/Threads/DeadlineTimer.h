@@ -29,8 +29,7 @@
 
 #include <cstdint>
 #include <functional>
-#include <thread>
-#include "SyncEvent.h"
+#include "TimerService.h"
 #include "CoreLibraryDllGlobal.h"
 #include "Platform/PlatformDefines.h"
 
@@ -41,25 +40,57 @@ namespace core_lib
 namespace threads
 {
 
+/*!
+ * \brief One-shot timer calling a function after a timeout.
+ *
+ * This is a lightweight handle onto a TimerService, by default the shared
+ * process wide service, so starting, restarting and cancelling do not create
+ * or join threads. The callback runs on one of the service's callback
+ * threads, see TimerService.
+ *
+ * A DeadlineTimer must be destroyed before the TimerService it uses.
+ */
 class CORE_LIBRARY_DLL_SHARED_API DeadlineTimer final
 {
     using callback_t = std::function<void()>;
 
 public:
+    /*! \brief Default constructor, uses TimerService::Default(). */
     DeadlineTimer();
+    /*!
+     * \brief Initialisation constructor.
+     * \param[in] service - Timer service to schedule on, must outlive this object.
+     */
+    explicit DeadlineTimer(TimerService& service);
+    /*! \brief Destructor, cancels the timer. */
     ~DeadlineTimer();
-
+    /*! \brief Copy constructor deleted.*/
+    DeadlineTimer(const DeadlineTimer&) = delete;
+    /*! \brief Copy assignment operator deleted.*/
+    DeadlineTimer& operator=(const DeadlineTimer&) = delete;
+    /*! \brief Move constructor deleted.*/
+    DeadlineTimer(DeadlineTimer&&) = delete;
+    /*! \brief Move assignment operator deleted.*/
+    DeadlineTimer& operator=(DeadlineTimer&&) = delete;
+    /*!
+     * \brief Start, or restart, the timer.
+     * \param[in] timeoutMillisecs - Timeout in milliseconds, must be greater than 0.
+     * \param[in] onTimedOut - Function to call when the timer expires.
+     */
     void Start(uint32_t timeoutMillisecs, callback_t const& onTimedOut);
+    /*!
+     * \brief Cancel the timer.
+     *
+     * Once this returns the callback will not be called and is not running,
+     * unless Cancel was itself called from the callback.
+     */
     void Cancel();
 
 private:
-    void TimeoutThread();
-
-private:
-    uint32_t    m_timeoutMillisecs;
-    callback_t  m_onTimedOut;
-    SyncEvent   m_timeoutEvent;
-    std::thread m_timeoutThread;
+    /*! \brief Service the timer is scheduled on. */
+    TimerService& m_service;
+    /*! \brief Entry linked into the service's wheel. */
+    TimerEntry m_entry;
 };
 
 } // namespace threads
@@ -27,6 +27,9 @@
 #define EVENTTHREAD_H
 
 #include <functional>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include "Platform/PlatformDefines.h"
 #include "Threads/ThreadBase.h"
 #include "Threads/SyncEvent.h"
@@ -38,6 +41,42 @@ namespace core_lib
 namespace threads
 {
 
+/*! \brief Enumeration defining how an EventThread schedules its ticks. */
+enum class eEventScheduling
+{
+    /*! \brief Wait a full period after each callback returns, the tick rate drifts by the
+     * callback's run time. */
+    fixedDelay,
+    /*! \brief Tick against absolute deadlines one period apart, no drift. */
+    fixedRate
+};
+
+/*! \brief Enumeration defining what a fixedRate EventThread does after overrunning a deadline. */
+enum class eOverrunPolicy
+{
+    /*! \brief Run the missed ticks back to back until back on schedule. */
+    catchUp,
+    /*! \brief Drop the missed ticks and carry on from the next deadline in the future. */
+    skip
+};
+
+/*! \brief Per-tick timing statistics gathered by an EventThread. */
+struct EventThreadStats
+{
+    /*! \brief Number of callbacks run. */
+    uint64_t ticks{0};
+    /*! \brief Number of times a callback finished after the next deadline (fixedRate only). */
+    uint64_t overruns{0};
+    /*! \brief Number of ticks dropped under eOverrunPolicy::skip. */
+    uint64_t skippedTicks{0};
+    /*! \brief Lateness of the most recent tick against its deadline (fixedRate only). */
+    std::chrono::nanoseconds lastJitter{0};
+    /*! \brief Largest lateness of any tick against its deadline (fixedRate only). */
+    std::chrono::nanoseconds maxJitter{0};
+    /*! \brief Mean lateness of ticks against their deadlines (fixedRate only). */
+    std::chrono::nanoseconds meanJitter{0};
+};
+
 /*! \brief Class defining an EventThread that ticks at a given rate and executes a registered
  * callback. */
 class CORE_LIBRARY_DLL_SHARED_API EventThread final : public core_lib::threads::ThreadBase
@@ -84,6 +123,26 @@ public:
      * \return Period between event being triggered, in milliseconds.
      */
     unsigned int EventPeriod(eWaitTimeUnit* timeUnit = nullptr) const;
+    /*!
+     * \brief Set how ticks are scheduled.
+     * \param[in] scheduling - Fixed delay (default) or fixed rate scheduling.
+     * \param[in] overrunPolicy - What to do when a fixed rate tick overruns its deadline.
+     * \param[in] spinMicrosecs - Busy wait for this long before each fixed rate deadline
+     *                            rather than sleeping, to reduce wake-up jitter at the
+     *                            cost of CPU, 0 to always sleep.
+     *
+     * May be called while the thread is running, the schedule restarts from the next tick.
+     */
+    void SetScheduling(eEventScheduling scheduling,
+                       eOverrunPolicy   overrunPolicy = eOverrunPolicy::skip,
+                       unsigned int     spinMicrosecs = 0);
+    /*!
+     * \brief Get the tick timing statistics.
+     * \return Statistics gathered since start or the last ResetStatistics call.
+     */
+    EventThreadStats Statistics() const;
+    /*! \brief Reset the tick timing statistics. */
+    void ResetStatistics();
 
     /*!
      * \brief Force signal the thread to tick.
@@ -95,6 +154,19 @@ private:
     void ThreadFunction() NO_EXCEPT_ OVERRIDE_;
     /*! \brief Function to process termination conditions.*/
     void ProcessTerminationConditions() NO_EXCEPT_ OVERRIDE_;
+    /*! \brief Run the callback once, swallowing exceptions.*/
+    void RunCallback() NO_EXCEPT_;
+    /*!
+     * \brief Single fixed rate iteration of the thread.
+     * \param[in] period - Tick period.
+     */
+    void FixedRateTick(std::chrono::nanoseconds period) NO_EXCEPT_;
+    /*!
+     * \brief Wait until a deadline, optionally spinning for the final stretch.
+     * \param[in] deadline - Time to wait until.
+     * \return True if woken early by ForceTick or Stop, false otherwise.
+     */
+    bool WaitUntil(std::chrono::steady_clock::time_point deadline) NO_EXCEPT_;
 
 private:
 	/*! \brief Event period mutex.*/
@@ -107,6 +179,32 @@ private:
     unsigned int m_eventPeriod{0};
     /*! \brief Unit of time for tick period.*/
     eWaitTimeUnit m_timeUnit{eWaitTimeUnit::milliseconds};
+    /*! \brief Tick period as read by the thread, avoids locking every tick.*/
+    std::atomic<int64_t> m_periodNanosecs{0};
+    /*! \brief Scheduling mode.*/
+    std::atomic<eEventScheduling> m_scheduling{eEventScheduling::fixedDelay};
+    /*! \brief Fixed rate overrun policy.*/
+    std::atomic<eOverrunPolicy> m_overrunPolicy{eOverrunPolicy::skip};
+    /*! \brief Time to spin before a fixed rate deadline.*/
+    std::atomic<int64_t> m_spinNanosecs{0};
+    /*! \brief Set when the fixed rate schedule must restart from now.*/
+    std::atomic<bool> m_rebaseSchedule{true};
+    /*! \brief Next fixed rate deadline, only used on the thread.*/
+    std::chrono::steady_clock::time_point m_nextDeadline{};
+    /*! \brief Statistic: callbacks run.*/
+    std::atomic<uint64_t> m_ticks{0};
+    /*! \brief Statistic: overruns.*/
+    std::atomic<uint64_t> m_overruns{0};
+    /*! \brief Statistic: skipped ticks.*/
+    std::atomic<uint64_t> m_skippedTicks{0};
+    /*! \brief Statistic: ticks that contributed to jitter totals.*/
+    std::atomic<uint64_t> m_jitterSamples{0};
+    /*! \brief Statistic: last jitter.*/
+    std::atomic<int64_t> m_lastJitterNanosecs{0};
+    /*! \brief Statistic: maximum jitter.*/
+    std::atomic<int64_t> m_maxJitterNanosecs{0};
+    /*! \brief Statistic: total jitter.*/
+    std::atomic<int64_t> m_totalJitterNanosecs{0};
 };
 
 } // namespace threads
@@ -30,6 +30,9 @@
 #include "Platform/PlatformDefines.h"
 #include <functional>
 #include <map>
+#include <vector>
+#include <utility>
+#include <type_traits>
 #include <stdexcept>
 #include <boost/throw_exception.hpp>
 #include "ThreadBase.h"
@@ -50,6 +53,14 @@ enum class eOnDestroyOptions
     /*! Process remaining items. */
     processRemainingItems
 };
+/*! \brief Control how many messages are taken off the queue per thread iteration. */
+enum class eQueueProcessingMode
+{
+    /*! Pop and dispatch one message at a time. */
+    singleMessage,
+    /*! Take everything queued and dispatch it as one batch. */
+    batchDrain
+};
 /*!
  * \brief Message Queue Thread.
  *
@@ -70,6 +81,13 @@ enum class eOnDestroyOptions
  *           queue thread. Because lookups in an std::unordered_map are
  *           typically much faster, at best, and no slower, at worst, than
  *           a std::map.
+ *
+ * In eQueueProcessingMode::batchDrain mode each iteration waits for a
+ * message then takes everything else already queued, resolving each distinct
+ * message ID's handler once and dispatching the whole batch under a single
+ * lock of the handler map. For small integral or enum message IDs
+ * EnableFlatDispatch can additionally replace the map lookup with an array
+ * index.
  */
 template <typename MessageId, typename MessageType,
           typename MapType = std::map<MessageId, std::function<bool(MessageType&)>>>
@@ -96,14 +114,17 @@ public:
      * \param[in] messageIdDecoder - Function object that returns the message ID for a message.
      * \param[in] destroyOptions - (Optional) Set the Message threads destroy option.
      * \param[in] messageDeleter - (Optional) Message deletion helper.
+     * \param[in] processingMode - (Optional) Process messages singly or in batches.
      */
     explicit MessageQueueThread(
         msg_id_decoder_t const& messageIdDecoder,
         eOnDestroyOptions       destroyOptions = eOnDestroyOptions::ignoreRemainingItems,
-        msg_deleter_t const&    messageDeleter = msg_deleter_t())
+        msg_deleter_t const&    messageDeleter = msg_deleter_t(),
+        eQueueProcessingMode    processingMode = eQueueProcessingMode::singleMessage)
         : m_msgIdDecoder{messageIdDecoder}
         , m_destroyOptions{destroyOptions}
         , m_messageDeleter{messageDeleter}
+        , m_processingMode{processingMode}
     {
         if (!Start())
         {
@@ -128,7 +149,7 @@ public:
             switch (m_destroyOptions)
             {
             case eOnDestroyOptions::processRemainingItems:
-                ProcessNextMessage();
+                ProcessMessages();
                 break;
             case eOnDestroyOptions::ignoreRemainingItems:
             default:
@@ -158,12 +179,60 @@ public:
     {
         std::lock_guard<std::mutex> lock{m_mutex};
 
-        if (m_msgHandlerMap.count(messageID) > 0)
+        auto result = m_msgHandlerMap.emplace(messageID, messageHandler);
+
+        if (!result.second)
         {
             throw std::invalid_argument("message handler already defined");
         }
 
-        m_msgHandlerMap.emplace(messageID, messageHandler);
+        size_t index;
+
+        if (FlatIndex(messageID, index) && (index < m_flatHandlers.size()))
+        {
+            m_flatHandlers[index] = &result.first->second;
+        }
+    }
+    /*! \brief Typedef defining function called when the queue has been drained. */
+    using queue_drained_handler_t = std::function<void()>;
+    /*!
+     * \brief Register a function to call each time this thread empties its queue.
+     * \param[in] queueDrainedHandler - Function object to call, replaces any previous one.
+     *
+     * The function is called on this thread after the last message currently
+     * queued has been handled, letting handlers group work such as flushing
+     * output over everything that arrived together.
+     */
+    void RegisterQueueDrainedHandler(const queue_drained_handler_t& queueDrainedHandler)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_queueDrainedHandler = queueDrainedHandler;
+    }
+    /*!
+     * \brief Dispatch message IDs below a given value through an array rather than the map.
+     * \param[in] tableSize - One more than the largest message ID to index directly.
+     *
+     * Only available when MessageId is an integral or enum type. IDs outside
+     * [0, tableSize) continue to be looked up in the map. Handlers registered
+     * before or after this call are both picked up.
+     */
+    void EnableFlatDispatch(size_t tableSize)
+    {
+        static_assert(std::is_integral<MessageId>::value || std::is_enum<MessageId>::value,
+                      "flat dispatch requires an integral or enum message ID");
+
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_flatHandlers.assign(tableSize, nullptr);
+
+        for (auto& handler : m_msgHandlerMap)
+        {
+            size_t index;
+
+            if (FlatIndex(handler.first, index) && (index < tableSize))
+            {
+                m_flatHandlers[index] = &handler.second;
+            }
+        }
     }
     /*!
      * \brief Push a message as an array of items onto this thread's queue.
@@ -204,7 +273,7 @@ private:
     /*! \brief Execute a single iteration of the thread. */
     void ThreadFunction() NO_EXCEPT_ OVERRIDE_
     {
-        ProcessNextMessage();
+        ProcessMessages();
     }
     /*! \brief Perform any special termination actions.*/
     void ProcessTerminationConditions() NO_EXCEPT_ OVERRIDE_
@@ -212,6 +281,20 @@ private:
         // Make sure we break out of m_messageQueue.Pop();
         m_messageQueue.BreakPopWait();
     }
+    /*!
+     * \brief Process the next message or batch of messages depending on mode.
+     */
+    void ProcessMessages()
+    {
+        if (m_processingMode == eQueueProcessingMode::batchDrain)
+        {
+            ProcessNextBatch();
+        }
+        else
+        {
+            ProcessNextMessage();
+        }
+    }
     /*!
      * \brief Process next message.
      */
@@ -224,38 +307,223 @@ private:
             return;
         }
 
-        bool canDeleteMsg;
+        bool                    canDeleteMsg;
+        queue_drained_handler_t drainedHandler;
 
         try
         {
             MessageId                   messageId{m_msgIdDecoder(msg)};
             std::lock_guard<std::mutex> lock{m_mutex};
+            drainedHandler                      = DrainedHandlerIfQueueEmpty();
+            auto                        handler = FindHandler(messageId);
+            canDeleteMsg                        = (nullptr == handler) || (*handler)(msg);
+        }
+        catch (...)
+        {
+            canDeleteMsg = true;
+        }
 
-            if (m_msgHandlerMap.count(messageId) > 0)
-            {
-                canDeleteMsg = m_msgHandlerMap[messageId](msg);
-            }
-            else
+        if (canDeleteMsg)
+        {
+            DeleteMessage(msg);
+        }
+
+        NotifyQueueDrained(drainedHandler);
+    }
+    /*!
+     * \brief Process every message currently queued as one batch.
+     */
+    void ProcessNextBatch()
+    {
+        MessageType first{};
+
+        if (!m_messageQueue.Pop(first))
+        {
+            return;
+        }
+
+        auto batch = m_messageQueue.TakeAll();
+        batch.emplace_front(std::move(first));
+
+        queue_drained_handler_t drainedHandler;
+
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_resolvedHandlers.clear();
+
+            for (auto& msg : batch)
             {
-                canDeleteMsg = true;
+                bool canDeleteMsg;
+
+                try
+                {
+                    auto handler = ResolveHandler(m_msgIdDecoder(msg));
+                    canDeleteMsg = (nullptr == handler) || (*handler)(msg);
+                }
+                catch (...)
+                {
+                    canDeleteMsg = true;
+                }
+
+                if (canDeleteMsg)
+                {
+                    DeleteMessage(msg);
+                }
             }
+
+            drainedHandler = DrainedHandlerIfQueueEmpty();
+        }
+
+        NotifyQueueDrained(drainedHandler);
+    }
+    /*!
+     * \brief Get a copy of the queue drained handler if one is registered and the queue is empty.
+     * \return Copy of the handler, empty if none registered or messages are still queued.
+     *
+     * Must be called with m_mutex locked.
+     */
+    queue_drained_handler_t DrainedHandlerIfQueueEmpty() const
+    {
+        if (!m_queueDrainedHandler || !m_messageQueue.Empty())
+        {
+            return {};
+        }
+
+        return m_queueDrainedHandler;
+    }
+    /*!
+     * \brief Call a queue drained handler, if not empty.
+     * \param[in] drainedHandler - Copy of the handler taken while m_mutex was locked.
+     *
+     * Must be called with m_mutex unlocked so the handler may do slow work such as
+     * flushing files without blocking handler registration.
+     */
+    static void NotifyQueueDrained(const queue_drained_handler_t& drainedHandler)
+    {
+        if (!drainedHandler)
+        {
+            return;
+        }
+
+        try
+        {
+            drainedHandler();
         }
         catch (...)
         {
-            canDeleteMsg = true;
+            // Do nothing.
         }
+    }
+    /*!
+     * \brief Convert a message ID to a flat dispatch table index.
+     * \param[in] messageId - Message ID.
+     * \param[out] index - Table index, only valid if returns true.
+     * \return True if the ID is integral or enum and not negative, false otherwise.
+     */
+    static bool FlatIndex(MessageId const& messageId, size_t& index)
+    {
+        if constexpr (std::is_enum<MessageId>::value)
+        {
+            using underlying_t = std::underlying_type_t<MessageId>;
+            auto value         = static_cast<underlying_t>(messageId);
+
+            if constexpr (std::is_signed<underlying_t>::value)
+            {
+                if (value < 0)
+                {
+                    return false;
+                }
+            }
 
-        if (canDeleteMsg && m_messageDeleter)
+            index = static_cast<size_t>(value);
+            return true;
+        }
+        else if constexpr (std::is_integral<MessageId>::value)
         {
-            try
+            if constexpr (std::is_signed<MessageId>::value)
             {
-                m_messageDeleter(msg);
+                if (messageId < 0)
+                {
+                    return false;
+                }
             }
-            catch (...)
+
+            index = static_cast<size_t>(messageId);
+            return true;
+        }
+        else
+        {
+            (void)messageId;
+            (void)index;
+            return false;
+        }
+    }
+    /*!
+     * \brief Find the handler for a message ID, m_mutex must be held.
+     * \param[in] messageId - Message ID.
+     * \return Pointer to handler or nullptr if none registered.
+     *
+     * Handlers are never removed and map nodes are stable, so the pointer
+     * remains valid for the lifetime of this object.
+     */
+    msg_handler_t const* FindHandler(MessageId const& messageId) const
+    {
+        size_t index;
+
+        if (FlatIndex(messageId, index) && (index < m_flatHandlers.size()))
+        {
+            return m_flatHandlers[index];
+        }
+
+        auto handlerIt = m_msgHandlerMap.find(messageId);
+        return handlerIt == m_msgHandlerMap.end() ? nullptr : &handlerIt->second;
+    }
+    /*!
+     * \brief Find the handler for a message ID within a batch, m_mutex must be held.
+     * \param[in] messageId - Message ID.
+     * \return Pointer to handler or nullptr if none registered.
+     *
+     * Each distinct ID is looked up once per batch, up to a small limit after
+     * which further new IDs go straight to FindHandler.
+     */
+    msg_handler_t const* ResolveHandler(MessageId const& messageId)
+    {
+        for (auto const& resolved : m_resolvedHandlers)
+        {
+            if (resolved.first == messageId)
             {
-                // Do nothing.
+                return resolved.second;
             }
         }
+
+        auto handler = FindHandler(messageId);
+
+        if (m_resolvedHandlers.size() < MAX_RESOLVED_HANDLERS)
+        {
+            m_resolvedHandlers.emplace_back(messageId, handler);
+        }
+
+        return handler;
+    }
+    /*!
+     * \brief Delete a message using the optional deleter.
+     * \param[in] msg - Message to delete.
+     */
+    void DeleteMessage(MessageType& msg)
+    {
+        if (!m_messageDeleter)
+        {
+            return;
+        }
+
+        try
+        {
+            m_messageDeleter(msg);
+        }
+        catch (...)
+        {
+            // Do nothing.
+        }
     }
     /*!
      * \brief Delete next message.
@@ -291,10 +559,20 @@ private:
     eOnDestroyOptions m_destroyOptions;
     /*! \brief Optional message item deleter function object. */
     msg_deleter_t m_messageDeleter;
+    /*! \brief Single message or batch processing. */
+    eQueueProcessingMode m_processingMode;
     /*! \brief Typedef for message map type. */
     using msg_map_t = MapType;
     /*! \brief Message handler function Map. */
     msg_map_t m_msgHandlerMap;
+    /*! \brief Optional array of handlers indexed by message ID. */
+    std::vector<msg_handler_t const*> m_flatHandlers;
+    /*! \brief Maximum distinct message IDs remembered per batch. */
+    static constexpr size_t MAX_RESOLVED_HANDLERS = 16;
+    /*! \brief Handlers resolved so far in the current batch. */
+    std::vector<std::pair<MessageId, msg_handler_t const*>> m_resolvedHandlers;
+    /*! \brief Optional function called when the queue has been drained. */
+    queue_drained_handler_t m_queueDrainedHandler;
     /*! \brief Message queue. */
     ConcurrentQueue<MessageType> m_messageQueue;
 };
@@ -0,0 +1,776 @@
+// This file is part of CoreLibrary containing useful reusable utility
+// classes.
+//
+// Copyright (C) 2014 to present, Duncan Crutchley
+// Contact <15799155+dac1976@users.noreply.github.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License and GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License
+// and GNU Lesser General Public License along with this program. If
+// not, see <http://www.gnu.org/licenses/>.
+
+/*!
+ * \file RingQueue.h
+ * \brief File containing bounded lock-free ring queue declarations.
+ */
+
+#ifndef RINGQUEUE
+#define RINGQUEUE
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <new>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <boost/throw_exception.hpp>
+
+/*! \brief The core_lib namespace. */
+namespace core_lib
+{
+/*! \brief The threads namespace. */
+namespace threads
+{
+
+/*! \brief The implementation namespace. */
+namespace ring_impl
+{
+
+/*! \brief Assumed cache line size used to keep producer and consumer indices apart. */
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/*!
+ * \brief Round a requested capacity up to a power of two.
+ * \param[in] capacity - Requested capacity, must be greater than zero.
+ * \return Capacity rounded up to the next power of two.
+ */
+inline size_t RoundUpCapacity(size_t capacity)
+{
+    if (capacity == 0)
+    {
+        BOOST_THROW_EXCEPTION(std::invalid_argument("ring queue capacity must be greater than 0"));
+    }
+
+    size_t rounded = 1;
+
+    while (rounded < capacity)
+    {
+        rounded <<= 1;
+    }
+
+    return rounded;
+}
+
+/*! \brief Uninitialised storage for a single ring slot. */
+template <typename T> struct Slot
+{
+    /*! \brief Raw storage the item is constructed in. */
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    /*!
+     * \brief Access the item held in the slot.
+     * \return Pointer to item.
+     */
+    T* Item()
+    {
+        return std::launder(reinterpret_cast<T*>(storage));
+    }
+};
+
+/*!
+ * \brief Bounded multi-producer, multi-consumer lock-free ring.
+ *
+ * Each cell carries a sequence number that tells producers and consumers
+ * whether it is free to write or ready to read, so claiming a cell is a
+ * single compare-and-swap on the shared enqueue or dequeue position.
+ */
+template <typename T> class MpmcRing final
+{
+public:
+    /*!
+     * \brief Initialisation constructor.
+     * \param[in] capacity - Maximum number of items, rounded up to a power of two.
+     */
+    explicit MpmcRing(size_t capacity)
+        : m_capacity(RoundUpCapacity(capacity))
+        , m_mask(m_capacity - 1)
+        , m_cells(new Cell[m_capacity])
+    {
+        for (size_t i = 0; i < m_capacity; ++i)
+        {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    /*! \brief Destructor, destroys any items still held. */
+    ~MpmcRing()
+    {
+        T item;
+
+        while (TryPop(item))
+        {
+        }
+    }
+    /*! \brief Copy constructor deleted.*/
+    MpmcRing(const MpmcRing&) = delete;
+    /*! \brief Copy assignment operator deleted.*/
+    MpmcRing& operator=(const MpmcRing&) = delete;
+    /*! \brief Move constructor deleted.*/
+    MpmcRing(MpmcRing&&) = delete;
+    /*! \brief Move assignment operator deleted.*/
+    MpmcRing& operator=(MpmcRing&&) = delete;
+    /*!
+     * \brief Capacity of the ring.
+     * \return Maximum number of items.
+     */
+    size_t Capacity() const
+    {
+        return m_capacity;
+    }
+    /*!
+     * \brief Approximate number of items in the ring.
+     * \return Number of items, exact only when there is no concurrent access.
+     */
+    size_t Size() const
+    {
+        const auto dequeuePos = m_dequeuePos.load(std::memory_order_acquire);
+        const auto enqueuePos = m_enqueuePos.load(std::memory_order_acquire);
+        return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+    }
+    /*!
+     * \brief Try and push an item.
+     * \param[in] item - Item to push.
+     * \return True if pushed, false if the ring was full.
+     */
+    template <typename U> bool TryPush(U&& item)
+    {
+        Cell* cell;
+        auto  pos = m_enqueuePos.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell           = &m_cells[pos & m_mask];
+            const auto seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff =
+                static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+
+            if (diff == 0)
+            {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (cell->slot.storage) T(std::forward<U>(item));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+    /*!
+     * \brief Try and pop an item.
+     * \param[out] item - Popped item, only valid if returns true.
+     * \return True if popped, false if the ring was empty.
+     */
+    bool TryPop(T& item)
+    {
+        Cell* cell;
+        auto  pos = m_dequeuePos.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell           = &m_cells[pos & m_mask];
+            const auto seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff =
+                static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+
+            if (diff == 0)
+            {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        auto ptr = cell->slot.Item();
+        item     = std::move(*ptr);
+        ptr->~T();
+        cell->sequence.store(pos + m_capacity, std::memory_order_release);
+        return true;
+    }
+
+private:
+    /*! \brief Ring cell, a slot plus its sequence number. */
+    struct Cell
+    {
+        /*! \brief Sequence number controlling access to the slot. */
+        std::atomic<size_t> sequence{0};
+        /*! \brief Item storage. */
+        Slot<T> slot;
+    };
+
+    /*! \brief Ring capacity. */
+    const size_t m_capacity;
+    /*! \brief Mask used to map positions onto cells. */
+    const size_t m_mask;
+    /*! \brief Ring cells. */
+    std::unique_ptr<Cell[]> m_cells;
+    /*! \brief Next position to be claimed by a producer. */
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_enqueuePos{0};
+    /*! \brief Next position to be claimed by a consumer. */
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_dequeuePos{0};
+};
+
+/*!
+ * \brief Bounded single-producer, single-consumer lock-free ring.
+ *
+ * Only one thread may push and only one thread may pop, which lets each
+ * side own its index outright and avoid compare-and-swap altogether.
+ */
+template <typename T> class SpscRing final
+{
+public:
+    /*!
+     * \brief Initialisation constructor.
+     * \param[in] capacity - Maximum number of items, rounded up to a power of two.
+     */
+    explicit SpscRing(size_t capacity)
+        : m_capacity(RoundUpCapacity(capacity))
+        , m_mask(m_capacity - 1)
+        , m_slots(new Slot<T>[m_capacity])
+    {
+    }
+    /*! \brief Destructor, destroys any items still held. */
+    ~SpscRing()
+    {
+        T item;
+
+        while (TryPop(item))
+        {
+        }
+    }
+    /*! \brief Copy constructor deleted.*/
+    SpscRing(const SpscRing&) = delete;
+    /*! \brief Copy assignment operator deleted.*/
+    SpscRing& operator=(const SpscRing&) = delete;
+    /*! \brief Move constructor deleted.*/
+    SpscRing(SpscRing&&) = delete;
+    /*! \brief Move assignment operator deleted.*/
+    SpscRing& operator=(SpscRing&&) = delete;
+    /*!
+     * \brief Capacity of the ring.
+     * \return Maximum number of items.
+     */
+    size_t Capacity() const
+    {
+        return m_capacity;
+    }
+    /*!
+     * \brief Approximate number of items in the ring.
+     * \return Number of items, exact only when there is no concurrent access.
+     */
+    size_t Size() const
+    {
+        const auto head = m_head.load(std::memory_order_acquire);
+        const auto tail = m_tail.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+    /*!
+     * \brief Try and push an item, must only be called from the producer thread.
+     * \param[in] item - Item to push.
+     * \return True if pushed, false if the ring was full.
+     */
+    template <typename U> bool TryPush(U&& item)
+    {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+
+        if (tail - m_headCache == m_capacity)
+        {
+            m_headCache = m_head.load(std::memory_order_acquire);
+
+            if (tail - m_headCache == m_capacity)
+            {
+                return false;
+            }
+        }
+
+        new (m_slots[tail & m_mask].storage) T(std::forward<U>(item));
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    /*!
+     * \brief Try and pop an item, must only be called from the consumer thread.
+     * \param[out] item - Popped item, only valid if returns true.
+     * \return True if popped, false if the ring was empty.
+     */
+    bool TryPop(T& item)
+    {
+        const auto head = m_head.load(std::memory_order_relaxed);
+
+        if (head == m_tailCache)
+        {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+
+            if (head == m_tailCache)
+            {
+                return false;
+            }
+        }
+
+        auto ptr = m_slots[head & m_mask].Item();
+        item     = std::move(*ptr);
+        ptr->~T();
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    /*! \brief Ring capacity. */
+    const size_t m_capacity;
+    /*! \brief Mask used to map positions onto slots. */
+    const size_t m_mask;
+    /*! \brief Ring slots. */
+    std::unique_ptr<Slot<T>[]> m_slots;
+    /*! \brief Producer position and its cached view of the consumer position. */
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail{0};
+    /*! \brief Consumer position last seen by the producer. */
+    size_t m_headCache{0};
+    /*! \brief Consumer position and its cached view of the producer position. */
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head{0};
+    /*! \brief Producer position last seen by the consumer. */
+    size_t m_tailCache{0};
+};
+
+} // namespace ring_impl
+
+/*!
+ * \brief Class defining a bounded lock-free ring queue.
+ *
+ * This offers the same Push/Pop/TryPop/TimedPop style interface as
+ * ConcurrentQueue but over a fixed-size ring, so pushing and popping
+ * never take a lock. A blocking call first spins on the ring for a
+ * short while and only parks the thread if that fails; the other side
+ * only touches the parking mutex when it knows a thread is parked.
+ *
+ * Use MpmcRingQueue for any mix of producers and consumers, or
+ * SpscRingQueue when there is exactly one of each.
+ *
+ * The template T must be default constructible and movable. Moving T
+ * should not throw, a throwing move on push leaves its slot unusable.
+ */
+template <typename T, typename Ring> class RingQueue final
+{
+public:
+    /*!
+     * \brief Initialisation constructor.
+     * \param[in] capacity - Maximum number of items, rounded up to a power of two.
+     */
+    explicit RingQueue(size_t capacity)
+        : m_ring(capacity)
+    {
+    }
+    /*! \brief Copy constructor deleted.*/
+    RingQueue(const RingQueue&) = delete;
+    /*! \brief Copy assignment operator deleted.*/
+    RingQueue& operator=(const RingQueue&) = delete;
+    /*! \brief Move constructor deleted.*/
+    RingQueue(RingQueue&&) = delete;
+    /*! \brief Move assignment operator deleted.*/
+    RingQueue& operator=(RingQueue&&) = delete;
+    /*!
+     * \brief Destructor
+     *
+     * As with ConcurrentQueue, if the queue items do not manage their
+     * own memory call Clear with a suitable deleter first.
+     */
+    ~RingQueue() = default;
+    /*!
+     * \brief Capacity of the queue.
+     * \return The maximum number of items the queue can hold.
+     */
+    size_t Capacity() const
+    {
+        return m_ring.Capacity();
+    }
+    /*!
+     * \brief Size of the queue.
+     * \return The number of items on the queue, approximate under concurrent access.
+     */
+    size_t Size() const
+    {
+        return m_ring.Size();
+    }
+    /*!
+     * \brief Is the queue empty.
+     * \return True if empty, false otherwise.
+     */
+    bool Empty() const
+    {
+        return Size() == 0;
+    }
+    /*!
+     * \brief Push an item onto the queue, waiting for space if full.
+     * \param[in] item - Object of type T to push onto queue.
+     */
+    void Push(T&& item)
+    {
+        PushWait(std::move(item));
+    }
+    /*!
+     * \brief Push a copy of an item onto the queue, waiting for space if full.
+     * \param[in] item - Object of type T to push onto queue.
+     */
+    void Push(const T& item)
+    {
+        PushWait(item);
+    }
+    /*!
+     * \brief Try and push an item onto the queue without waiting.
+     * \param[in] item - Object of type T to push onto queue.
+     * \return True if pushed, false if the queue was full.
+     */
+    bool TryPush(T&& item)
+    {
+        return PushNow(std::move(item));
+    }
+    /*!
+     * \brief Try and push a copy of an item onto the queue without waiting.
+     * \param[in] item - Object of type T to push onto queue.
+     * \return True if pushed, false if the queue was full.
+     */
+    bool TryPush(const T& item)
+    {
+        return PushNow(item);
+    }
+    /*!
+     * \brief Break out of waiting on a Pop method.
+     *
+     * Each call makes one waiting Pop, or the next one to wait, return false.
+     */
+    void BreakPopWait()
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            ++m_breakPopWaits;
+        }
+
+        m_itemCondition.notify_one();
+    }
+    /*!
+     * \brief Pop an item off the queue if there are any else wait.
+     * \param[out] item - The popped item, only valid if returns true.
+     * \return True if item popped off queue, false if BreakPopWait was called.
+     */
+    bool Pop(T& item)
+    {
+        return PopWait(item, nullptr);
+    }
+    /*!
+     * \brief Pop an item off the queue if there are any else wait.
+     * \param[out] item - The popped item, only valid if no exception is thrown.
+     *
+     * This will throw std::runtime_error if woken without an item.
+     */
+    void PopThrow(T& item)
+    {
+        if (!Pop(item))
+        {
+            throw std::runtime_error("queue is empty");
+        }
+    }
+    /*!
+     * \brief Pop an item off the queue if there are any else return.
+     * \param[out] item - The popped item, only valid if returns true.
+     * \return True if item popped off queue, false otherwise.
+     */
+    bool TryPop(T& item)
+    {
+        return PopNow(item);
+    }
+    /*!
+     * \brief Pop an item off the queue.
+     * \param[out] item - The popped item.
+     *
+     * This will throw std::runtime_error if there are no items
+     * on the queue when called.
+     */
+    void TryPopThrow(T& item)
+    {
+        if (!PopNow(item))
+        {
+            throw std::runtime_error("queue is empty");
+        }
+    }
+    /*!
+     * \brief Pop an item off the queue but only wait for a given amount of time.
+     * \param[in] timeoutMilliseconds - Amount of time to wait.
+     * \param[out] item - The popped item, only valid if returns true.
+     * \return True if item popped successfully, false if timed out or nothing to pop.
+     */
+    bool TimedPop(unsigned int timeoutMilliseconds, T& item)
+    {
+        const auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMilliseconds);
+        return PopWait(item, &deadline);
+    }
+    /*!
+     * \brief Pop an item off the queue but only wait for a given amount of time.
+     * \param[in] timeoutMilliseconds - Amount of time to wait.
+     * \param[out] item - The popped item.
+     *
+     * If no item could be popped in the time then std::runtime_error is thrown.
+     */
+    void TimedPopThrow(unsigned int timeoutMilliseconds, T& item)
+    {
+        if (!TimedPop(timeoutMilliseconds, item))
+        {
+            throw std::runtime_error("timed out");
+        }
+    }
+    /*!
+     * \brief Clear the queue.
+     *
+     * Must be called from a consumer thread when using SpscRingQueue.
+     */
+    void Clear()
+    {
+        T item;
+
+        while (PopNow(item))
+        {
+        }
+    }
+    /*!
+     * \brief Clear the queue.
+     * \param[in] deleter - Deleter applied to each queue item, e.g. SingleItemDeleter.
+     *
+     * Must be called from a consumer thread when using SpscRingQueue.
+     */
+    template <typename F> void Clear(F deleter)
+    {
+        T item;
+
+        while (PopNow(item))
+        {
+            deleter(item);
+        }
+    }
+    /*! \brief Typedef for paramteter type. */
+    using value_type = T;
+
+private:
+    /*! \brief Number of attempts made on the ring before a blocking call parks. */
+    static constexpr int SPIN_COUNT = 128;
+    /*! \brief Number of those attempts made before yielding between attempts. */
+    static constexpr int BUSY_SPIN_COUNT = 32;
+
+    /*! \brief Underlying lock-free ring. */
+    Ring m_ring;
+    /*! \brief Mutex only used while parking or waking a thread. */
+    std::mutex m_mutex;
+    /*! \brief Condition parked consumers wait on. */
+    std::condition_variable m_itemCondition;
+    /*! \brief Condition parked producers wait on. */
+    std::condition_variable m_spaceCondition;
+    /*! \brief Number of parked consumers. */
+    std::atomic<uint32_t> m_popWaiters{0};
+    /*! \brief Number of parked producers. */
+    std::atomic<uint32_t> m_pushWaiters{0};
+    /*! \brief Outstanding BreakPopWait calls, each consumed by one waiting pop. */
+    uint32_t m_breakPopWaits{0};
+
+    /*!
+     * \brief Wake a parked thread if, and only if, there is one.
+     * \param[in] waiters - Count of parked threads.
+     * \param[in] condition - Condition those threads wait on.
+     */
+    void WakeOne(std::atomic<uint32_t>& waiters, std::condition_variable& condition)
+    {
+        // Pairs with the fence in the waiting thread: either it sees our
+        // change to the ring or we see it counted in waiters.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (waiters.load(std::memory_order_relaxed) > 0)
+        {
+            // Taking the mutex stops the notify landing between the waiter
+            // checking the ring and going to sleep.
+            {
+                std::lock_guard<std::mutex> lock{m_mutex};
+            }
+
+            condition.notify_one();
+        }
+    }
+    /*!
+     * \brief Push an item and wake a parked consumer if needed.
+     * \param[in] item - Item to push.
+     * \return True if pushed, false if the ring was full.
+     */
+    template <typename U> bool PushNow(U&& item)
+    {
+        if (!m_ring.TryPush(std::forward<U>(item)))
+        {
+            return false;
+        }
+
+        WakeOne(m_popWaiters, m_itemCondition);
+        return true;
+    }
+    /*!
+     * \brief Pop an item and wake a parked producer if needed.
+     * \param[out] item - Popped item.
+     * \return True if popped, false if the ring was empty.
+     */
+    bool PopNow(T& item)
+    {
+        if (!m_ring.TryPop(item))
+        {
+            return false;
+        }
+
+        WakeOne(m_pushWaiters, m_spaceCondition);
+        return true;
+    }
+    /*!
+     * \brief Push an item, spinning then parking while the ring is full.
+     * \param[in] item - Item to push.
+     */
+    template <typename U> void PushWait(U&& item)
+    {
+        // The item is only moved from once TryPush has claimed a slot
+        // so retrying with the same forwarded item is safe.
+        for (int spin = 0; spin < SPIN_COUNT; ++spin)
+        {
+            if (PushNow(std::forward<U>(item)))
+            {
+                return;
+            }
+
+            if (spin >= BUSY_SPIN_COUNT)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        m_pushWaiters.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+
+            while (!m_ring.TryPush(std::forward<U>(item)))
+            {
+                m_spaceCondition.wait(lock);
+            }
+        }
+
+        m_pushWaiters.fetch_sub(1, std::memory_order_relaxed);
+        WakeOne(m_popWaiters, m_itemCondition);
+    }
+    /*!
+     * \brief Pop an item, spinning then parking while the ring is empty.
+     * \param[out] item - Popped item.
+     * \param[in] deadline - Optional time at which to give up.
+     * \return True if popped, false if timed out or BreakPopWait was called.
+     */
+    bool PopWait(T& item, const std::chrono::steady_clock::time_point* deadline)
+    {
+        for (int spin = 0; spin < SPIN_COUNT; ++spin)
+        {
+            if (PopNow(item))
+            {
+                return true;
+            }
+
+            if (spin >= BUSY_SPIN_COUNT)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        bool popped{false};
+        m_popWaiters.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+
+            for (;;)
+            {
+                if (m_ring.TryPop(item))
+                {
+                    popped = true;
+                    break;
+                }
+
+                if (m_breakPopWaits > 0)
+                {
+                    --m_breakPopWaits;
+                    break;
+                }
+
+                if (nullptr == deadline)
+                {
+                    m_itemCondition.wait(lock);
+                }
+                else if (m_itemCondition.wait_until(lock, *deadline) == std::cv_status::timeout)
+                {
+                    popped = m_ring.TryPop(item);
+                    break;
+                }
+            }
+        }
+
+        m_popWaiters.fetch_sub(1, std::memory_order_relaxed);
+
+        if (popped)
+        {
+            WakeOne(m_pushWaiters, m_spaceCondition);
+        }
+
+        return popped;
+    }
+};
+
+/*! \brief Bounded lock-free queue for any number of producers and consumers. */
+template <typename T> using MpmcRingQueue = RingQueue<T, ring_impl::MpmcRing<T>>;
+
+/*! \brief Bounded lock-free queue for exactly one producer and one consumer. */
+template <typename T> using SpscRingQueue = RingQueue<T, ring_impl::SpscRing<T>>;
+
+} // namespace threads
+} // namespace core_lib
+
+#endif // RINGQUEUE
@@ -28,9 +28,12 @@
 #define SYNCEVENT
 
 #include "CoreLibraryDllGlobal.h"
+#include <atomic>
+#include <cstdint>
 #include <mutex>
 #include <functional>
 #include <condition_variable>
+#include <chrono>
 
 /*! \brief The core_lib namespace. */
 namespace core_lib
@@ -77,6 +80,13 @@ enum class eWaitTimeUnit
  * that is built using a mutex and a condition variable
  * it makes for a neater implementation than using these
  * types of object as is.
+ *
+ * When no external condition is given the signalled flag and
+ * a count of blocked waiters are kept in a single atomic word.
+ * Signalling with nobody waiting is then one atomic operation
+ * and waiting on an already signalled event never takes the
+ * mutex. Wait spins briefly then blocks using std::atomic::wait,
+ * timed waits fall back to the condition variable.
  */
 class CORE_LIBRARY_DLL_SHARED_API SyncEvent final
 {
@@ -151,6 +161,15 @@ public:
      * else we use the internally tracked condition.
      */
     bool WaitForTime(unsigned int period, eWaitTimeUnit timeUnit = eWaitTimeUnit::milliseconds);
+    /*!
+     * \brief Wait for event until an absolute point in time.
+     * \param[in] deadline - Time at which to stop waiting.
+     * \return true if signalled, false if timed out.
+     *
+     * As WaitForTime but against a fixed deadline, so repeated waits do not
+     * accumulate the time spent between them.
+     */
+    bool WaitUntil(std::chrono::steady_clock::time_point deadline);
     /*!
      * \brief Signal event.
      *
@@ -180,16 +199,34 @@ public:
     void Reset();
 
 private:
-    bool SignalFlag() const;
-    void SetSignalFlag(bool signalFlag);
+    /*!
+     * \brief Test the internal flag, clearing it if auto-reset.
+     * \return True if the event was signalled, false otherwise.
+     */
+    bool TryConsumeSignal();
 
 private:
+    /*! \brief Bit in m_state set while the event is signalled. */
+    static constexpr uint32_t SIGNALLED_BIT = 1;
+    /*! \brief Amount added to m_state per blocked waiter. */
+    static constexpr uint32_t WAITER_INC = 2;
+    /*! \brief Number of attempts Wait makes to take the signal before blocking. */
+    static constexpr int SPIN_COUNT = 128;
+    /*! \brief Number of those attempts made before yielding between attempts. */
+    static constexpr int BUSY_SPIN_COUNT = 32;
+    /*! \brief Mutex used by the condition variable and external conditions. */
     mutable std::mutex      m_signalMutex;
+    /*! \brief Condition variable used by timed waits and external conditions. */
     std::condition_variable m_signalCondVar;
+    /*! \brief Notify all waiting threads when signalled. */
     bool                    m_signalAllThreads{false};
+    /*! \brief Automatically reset when a wait returns. */
     bool                    m_autoReset{true};
-    bool                    m_signalFlag{false};
+    /*! \brief Signalled flag in the low bit, number of blocked waiters above it. */
+    std::atomic<uint32_t>   m_state{0};
+    /*! \brief External condition getter, empty if using the internal flag. */
     get_condition_t         m_getCondition;
+    /*! \brief External condition setter, empty if using the internal flag. */
     set_condition_t         m_setCondition;
 };
 
@@ -29,6 +29,8 @@
 
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <stop_token>
 #include "CoreLibraryDllGlobal.h"
 #include "Platform/PlatformDefines.h"
 
@@ -45,6 +47,10 @@ namespace threads
  * This abstract class can be used as a base class for
  * objects that need to be threaded. It neatly wraps all
  * the useful functionality of std::thread in a usable way.
+ *
+ * The started and terminating flags are atomics so the run loop, and any
+ * derived class checking IsTerminating() or its StopToken() in a hot loop,
+ * never takes a lock to do so.
  */
 class CORE_LIBRARY_DLL_SHARED_API ThreadBase
 {
@@ -113,7 +119,22 @@ protected:
      * \brief Is thread terminating.
      * \return Returns true if terminating, false otherwise.
      */
-    bool IsTerminating() const;
+    bool IsTerminating() const
+    {
+        return m_terminating.load(std::memory_order_acquire);
+    }
+    /*!
+     * \brief Get a token that is signalled when Stop() is called.
+     * \return Stop token for the current run of the thread.
+     *
+     * Pass this to code called from ThreadFunction() that loops for a
+     * long time so it can check stop_requested() cheaply, or register a
+     * std::stop_callback on it to be woken when stopping.
+     */
+    std::stop_token StopToken() const
+    {
+        return m_stopSource.get_token();
+    }
     /*!
      * \brief Make this thread sleep for a period of time.
      * \param[in] milliSecs - Time period in milliseconds.
@@ -178,12 +199,14 @@ private:
     void Run();
 
 private:
-    /*! \brief Access mutex to protect private data.*/
+    /*! \brief Access mutex to protect thread ID and native handle.*/
     mutable std::mutex m_mutex;
     /*! \brief Boolean flag to mark thread as started.*/
-    bool m_started{};
+    std::atomic<bool> m_started{};
     /*! \brief Boolean flag to mark thread as terminating.*/
-    bool m_terminating{};
+    std::atomic<bool> m_terminating{};
+    /*! \brief Stop source for the current run, replaced on each Start.*/
+    std::stop_source m_stopSource{};
     /*! \brief Thread ID of started thread object.*/
     std::thread::id m_threadId{};
     /*! \brief Native thread handle (where supported) of started thread.*/
@@ -0,0 +1,317 @@
+// This file is part of CoreLibrary containing useful reusable utility
+// classes.
+//
+// Copyright (C) 2014 to present, Duncan Crutchley
+// Contact <15799155+dac1976@users.noreply.github.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License and GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License
+// and GNU Lesser General Public License along with this program. If
+// not, see <http://www.gnu.org/licenses/>.
+
+/*!
+ * \file ThreadPool.h
+ * \brief File containing declaration of ThreadPool class.
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <boost/throw_exception.hpp>
+#include "CoreLibraryDllGlobal.h"
+#include "ThreadGroup.h"
+#include "ConcurrentQueue.h"
+
+/*! \brief The core_lib namespace. */
+namespace core_lib
+{
+/*! \brief The threads namespace. */
+namespace threads
+{
+
+class ThreadPool;
+
+/*! \brief The pool implementation namespace. */
+namespace pool_impl
+{
+
+/*! \brief Completion state shared between a task and the continuations attached to it. */
+class CORE_LIBRARY_DLL_SHARED_API ContinuationState final
+{
+public:
+    /*! \brief Mark the task complete and run any continuations registered so far. */
+    void Complete();
+    /*!
+     * \brief Register a function to run once the task completes.
+     * \param[in] continuation - Function to run, called immediately if already complete.
+     */
+    void Add(std::function<void()> continuation);
+
+private:
+    /*! \brief Access mutex. */
+    std::mutex m_mutex;
+    /*! \brief Has the task completed. */
+    bool m_complete{false};
+    /*! \brief Continuations waiting for completion. */
+    std::vector<std::function<void()>> m_continuations;
+};
+
+} // namespace pool_impl
+
+/*!
+ * \brief Future returned by ThreadPool::Submit.
+ *
+ * Wraps a std::shared_future and additionally allows continuations to be
+ * attached with Then, which are submitted to the pool once this task
+ * completes rather than blocking a worker waiting for it.
+ */
+template <typename R> class TaskFuture final
+{
+public:
+    /*! \brief Default constructor, creates an invalid future. */
+    TaskFuture() = default;
+    /*!
+     * \brief Initialisation constructor.
+     * \param[in] pool - Pool the task was submitted to.
+     * \param[in] future - Future for the task's result.
+     * \param[in] state - Task completion state.
+     */
+    TaskFuture(ThreadPool* pool, std::shared_future<R> future,
+               std::shared_ptr<pool_impl::ContinuationState> state)
+        : m_pool(pool)
+        , m_future(std::move(future))
+        , m_state(std::move(state))
+    {
+    }
+    /*!
+     * \brief Does this refer to a task.
+     * \return True if valid, false otherwise.
+     */
+    bool Valid() const
+    {
+        return m_future.valid();
+    }
+    /*! \brief Wait for the task to complete. */
+    void Wait() const
+    {
+        m_future.wait();
+    }
+    /*!
+     * \brief Wait for the task to complete for up to a given time.
+     * \param[in] timeout - Maximum time to wait.
+     * \return Status of the future.
+     */
+    template <typename Rep, typename Period>
+    std::future_status WaitFor(std::chrono::duration<Rep, Period> const& timeout) const
+    {
+        return m_future.wait_for(timeout);
+    }
+    /*!
+     * \brief Get the task's result, waiting if necessary.
+     * \return Task result, rethrows any exception the task threw.
+     */
+    decltype(auto) Get() const
+    {
+        return m_future.get();
+    }
+    /*!
+     * \brief Access the underlying shared future.
+     * \return The shared future.
+     */
+    std::shared_future<R> const& SharedFuture() const
+    {
+        return m_future;
+    }
+    /*!
+     * \brief Attach a continuation to run on the pool once this task completes.
+     * \param[in] continuation - Callable taking a std::shared_future<R>.
+     * \return Future for the continuation's result.
+     *
+     * Throws std::logic_error if this future was not returned by the pool.
+     */
+    template <typename C>
+    auto Then(C&& continuation) const
+        -> TaskFuture<std::invoke_result_t<std::decay_t<C>, std::shared_future<R>>>;
+
+private:
+    /*! \brief Pool the task was submitted to. */
+    ThreadPool* m_pool{nullptr};
+    /*! \brief Future for the task's result. */
+    std::shared_future<R> m_future;
+    /*! \brief Task completion state. */
+    std::shared_ptr<pool_impl::ContinuationState> m_state;
+};
+
+/*!
+ * \brief Work-stealing thread pool.
+ *
+ * Each worker owns a ConcurrentQueue of tasks. Tasks submitted from a
+ * worker go onto that worker's own queue, tasks submitted from elsewhere
+ * are spread round-robin. A worker takes from the front of its own queue
+ * and when that is empty steals from the back of the other workers' queues,
+ * so long running tasks do not leave work stranded behind them.
+ *
+ * Workers can optionally be pinned to CPUs using SetThreadAffinity.
+ *
+ * The destructor runs all tasks already submitted before joining the workers.
+ * Tasks must not be submitted from outside the pool once destruction has begun.
+ */
+class CORE_LIBRARY_DLL_SHARED_API ThreadPool final
+{
+public:
+    /*!
+     * \brief Initialisation constructor.
+     * \param[in] numThreads - Number of worker threads, 0 uses the number of logical CPUs.
+     * \param[in] pinToCpus - Pin worker N to logical CPU N modulo the number of CPUs.
+     */
+    explicit ThreadPool(size_t numThreads = 0, bool pinToCpus = false);
+    /*! \brief Destructor, completes outstanding tasks then joins the workers. */
+    ~ThreadPool();
+    /*! \brief Copy constructor deleted.*/
+    ThreadPool(const ThreadPool&) = delete;
+    /*! \brief Copy assignment operator deleted.*/
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    /*! \brief Move constructor deleted.*/
+    ThreadPool(ThreadPool&&) = delete;
+    /*! \brief Move assignment operator deleted.*/
+    ThreadPool& operator=(ThreadPool&&) = delete;
+    /*!
+     * \brief Number of worker threads.
+     * \return Number of workers.
+     */
+    size_t Size() const;
+    /*!
+     * \brief Number of tasks queued but not yet started.
+     * \return Number of pending tasks.
+     */
+    size_t PendingTasks() const;
+    /*!
+     * \brief Is the calling thread one of this pool's workers.
+     * \return True if it is, false otherwise.
+     */
+    bool IsThisThreadIn() const;
+    /*!
+     * \brief Submit a task to the pool.
+     * \param[in] function - Callable to run.
+     * \param[in] args - Arguments to call it with, copied or moved into the task.
+     * \return Future for the task's result.
+     */
+    template <typename F, typename... Args>
+    auto Submit(F&& function, Args&&... args)
+        -> TaskFuture<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>>
+    {
+        using result_t = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+
+        auto task = std::make_shared<std::packaged_task<result_t()>>(
+            [func = std::forward<F>(function),
+             argsTuple = std::make_tuple(std::forward<Args>(args)...)]() mutable -> result_t {
+                return std::apply(std::move(func), std::move(argsTuple));
+            });
+        auto state = std::make_shared<pool_impl::ContinuationState>();
+        TaskFuture<result_t> future(this, task->get_future().share(), state);
+
+        Post([task, state]() {
+            (*task)();
+            state->Complete();
+        });
+
+        return future;
+    }
+    /*!
+     * \brief Post a fire-and-forget task to the pool.
+     * \param[in] task - Function to run, exceptions it throws are swallowed.
+     */
+    void Post(std::function<void()> task);
+
+private:
+    /*!
+     * \brief Worker thread function.
+     * \param[in] index - Worker's index.
+     */
+    void WorkerLoop(size_t index);
+    /*!
+     * \brief Take a task from our own queue or steal one from another worker.
+     * \param[in] index - Worker's index.
+     * \param[out] task - Task taken, only valid if returns true.
+     * \return True if a task was taken, false otherwise.
+     */
+    bool TakeTask(size_t index, std::function<void()>& task);
+
+private:
+    /*! \brief Typedef for task queue. */
+    using task_queue_t = ConcurrentQueue<std::function<void()>>;
+    /*! \brief Per-worker task queues. */
+    std::vector<std::unique_ptr<task_queue_t>> m_queues;
+    /*! \brief Worker threads. */
+    ThreadGroup m_threads;
+    /*! \brief Mutex used while idle workers wait for tasks. */
+    std::mutex m_waitMutex;
+    /*! \brief Signalled when tasks are posted or the pool stops. */
+    std::condition_variable m_workCondition;
+    /*! \brief Number of queued tasks not yet taken by a worker. */
+    std::atomic<size_t> m_pendingTasks{0};
+    /*! \brief Number of workers waiting, or about to wait, on m_workCondition. */
+    std::atomic<size_t> m_parkedWorkers{0};
+    /*! \brief Round robin counter for tasks posted from outside the pool. */
+    std::atomic<size_t> m_nextQueue{0};
+    /*! \brief Stop flag. */
+    bool m_stop{false};
+};
+
+template <typename R>
+template <typename C>
+auto TaskFuture<R>::Then(C&& continuation) const
+    -> TaskFuture<std::invoke_result_t<std::decay_t<C>, std::shared_future<R>>>
+{
+    using result_t = std::invoke_result_t<std::decay_t<C>, std::shared_future<R>>;
+
+    if (!m_pool || !m_state || !m_future.valid())
+    {
+        BOOST_THROW_EXCEPTION(std::logic_error("continuation attached to an invalid task future"));
+    }
+
+    auto task = std::make_shared<std::packaged_task<result_t()>>(
+        [func = std::forward<C>(continuation), antecedent = m_future]() mutable -> result_t {
+            return func(antecedent);
+        });
+    auto state = std::make_shared<pool_impl::ContinuationState>();
+    TaskFuture<result_t> future(m_pool, task->get_future().share(), state);
+    auto pool = m_pool;
+
+    m_state->Add([pool, task, state]() {
+        pool->Post([task, state]() {
+            (*task)();
+            state->Complete();
+        });
+    });
+
+    return future;
+}
+
+} // namespace threads
+} // namespace core_lib
+
+#endif // THREADPOOL_H
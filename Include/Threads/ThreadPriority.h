@@ -88,6 +88,10 @@ bool CORE_LIBRARY_DLL_SHARED_API SetThreadPriority(std::thread::native_handle_ty
                                                    eHglThreadPriority priority);
 #endif
 
+// Pin a thread to a single logical CPU, cpuIndex is zero based.
+bool CORE_LIBRARY_DLL_SHARED_API SetThreadAffinity(std::thread::native_handle_type const& threadId,
+                                                   unsigned int cpuIndex);
+
 } // namespace threads
 } // namespace core_lib
 
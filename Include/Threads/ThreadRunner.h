@@ -82,6 +82,12 @@ public:
      * made to sleep.
      */
     void SleepThreadForTime(unsigned int milliSecs) const;
+    /*!
+     * \brief Get a token that is signalled when Stop() is called.
+     *
+     * Lets the thread function check for termination inside long loops.
+     */
+    using ThreadBase::StopToken;
 
 private:
     /*! \brief Functor to call in the ThreadFunction method. */
@@ -0,0 +1,239 @@
+// This file is part of CoreLibrary containing useful reusable utility
+// classes.
+//
+// Copyright (C) 2014 to present, Duncan Crutchley
+// Contact <15799155+dac1976@users.noreply.github.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License and GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License
+// and GNU Lesser General Public License along with this program. If
+// not, see <http://www.gnu.org/licenses/>.
+
+/*!
+ * \file TimerService.h
+ * \brief File containing declaration of TimerService class.
+ */
+
+#ifndef TIMERSERVICE_H
+#define TIMERSERVICE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <utility>
+#include "CoreLibraryDllGlobal.h"
+
+/*! \brief The core_lib namespace. */
+namespace core_lib
+{
+/*! \brief The threads namespace. */
+namespace threads
+{
+
+class TimerService;
+
+/*!
+ * \brief A single timer slot owned by the user of a TimerService.
+ *
+ * Entries are intrusively linked into the service's wheel so scheduling and
+ * cancelling never allocate. An entry must be cancelled before it is destroyed,
+ * DeadlineTimer takes care of this.
+ */
+class CORE_LIBRARY_DLL_SHARED_API TimerEntry final
+{
+public:
+    /*! \brief Default constructor. */
+    TimerEntry() = default;
+    /*! \brief Copy constructor deleted.*/
+    TimerEntry(const TimerEntry&) = delete;
+    /*! \brief Copy assignment operator deleted.*/
+    TimerEntry& operator=(const TimerEntry&) = delete;
+    /*! \brief Move constructor deleted.*/
+    TimerEntry(TimerEntry&&) = delete;
+    /*! \brief Move assignment operator deleted.*/
+    TimerEntry& operator=(TimerEntry&&) = delete;
+    /*! \brief Default destructor. */
+    ~TimerEntry() = default;
+
+private:
+    friend class TimerService;
+
+    /*! \brief Previous entry in the list this entry is linked into. */
+    TimerEntry* m_prev{this};
+    /*! \brief Next entry in the list this entry is linked into. */
+    TimerEntry* m_next{this};
+    /*! \brief Number of full wheel turns left before the entry expires. */
+    uint64_t m_rounds{0};
+    /*! \brief Function called on expiry. */
+    std::function<void()> m_callback;
+};
+
+/*!
+ * \brief Shared timer service backed by a hashed timing wheel.
+ *
+ * One thread drives the wheel, sleeping until the earliest pending entry is
+ * due and then firing any entries that have come due. Starting, cancelling
+ * and restarting a timer are constant time operations and do not create
+ * threads, so many thousands of concurrent timeouts cost a fixed number of
+ * threads in total.
+ *
+ * Expired callbacks are handed to a small pool of callback threads so a slow
+ * or blocking callback does not hold up the wheel or other timers, unless all
+ * the callback threads are busy. A given entry's callback never runs on two
+ * threads at once. With no callback threads callbacks run one at a time on
+ * the wheel thread, so one slow callback delays every other timer.
+ *
+ * Timers fire no earlier than requested and at most one tick late, plus any
+ * time waiting for a free callback thread.
+ */
+class CORE_LIBRARY_DLL_SHARED_API TimerService final
+{
+public:
+    /*! \brief Typedef for timeout callback. */
+    using callback_t = std::function<void()>;
+    /*!
+     * \brief Initialisation constructor.
+     * \param[in] tickMillisecs - Wheel resolution in milliseconds.
+     * \param[in] numSlots - Number of slots in the wheel.
+     * \param[in] numCallbackThreads - Threads to run callbacks on, 0 runs them on the wheel
+     * thread.
+     */
+    explicit TimerService(uint32_t tickMillisecs = 1, size_t numSlots = 4096,
+                          size_t numCallbackThreads = 4);
+    /*! \brief Destructor, stops the service threads. Pending timers do not fire. */
+    ~TimerService();
+    /*! \brief Copy constructor deleted.*/
+    TimerService(const TimerService&) = delete;
+    /*! \brief Copy assignment operator deleted.*/
+    TimerService& operator=(const TimerService&) = delete;
+    /*! \brief Move constructor deleted.*/
+    TimerService(TimerService&&) = delete;
+    /*! \brief Move assignment operator deleted.*/
+    TimerService& operator=(TimerService&&) = delete;
+    /*!
+     * \brief Process wide service used by default constructed DeadlineTimers.
+     * \return Reference to shared service.
+     */
+    static TimerService& Default();
+    /*!
+     * \brief Schedule an entry, rescheduling it if it is already pending.
+     * \param[in] entry - Entry to schedule.
+     * \param[in] timeoutMillisecs - Timeout in milliseconds, must be greater than 0.
+     * \param[in] onTimedOut - Function to call on expiry.
+     */
+    void Schedule(TimerEntry& entry, uint32_t timeoutMillisecs, callback_t const& onTimedOut);
+    /*!
+     * \brief Cancel an entry.
+     * \param[in] entry - Entry to cancel.
+     *
+     * If the entry's callback is running this waits for it to finish, unless
+     * called from that callback.
+     */
+    void Cancel(TimerEntry& entry);
+    /*!
+     * \brief Number of pending timers.
+     * \return Number of scheduled entries yet to fire.
+     */
+    size_t ActiveTimers() const;
+
+private:
+    /*! \brief Wheel thread function. */
+    void Run();
+    /*! \brief Callback thread function. */
+    void RunCallbacks();
+    /*! \brief Move the wheel on one slot and collect expired entries, m_mutex must be held. */
+    void AdvanceWheel();
+    /*!
+     * \brief Ticks until the next entry in the wheel is due, m_mutex must be held.
+     * \return Ticks to the earliest due entry, or one full turn if none are due within it.
+     */
+    uint64_t TicksToNextExpiry() const;
+    /*!
+     * \brief Run callbacks of expired entries on the wheel thread.
+     * \param[in] lock - Lock on m_mutex, released while each callback runs.
+     */
+    void FireExpired(std::unique_lock<std::mutex>& lock);
+    /*!
+     * \brief Get the next expired entry not already running, m_mutex must be held.
+     * \return Expired entry, or nullptr if there is none.
+     */
+    TimerEntry* NextRunnable() const;
+    /*!
+     * \brief Unlink an expired entry and run its callback.
+     * \param[in] lock - Lock on m_mutex, released while the callback runs.
+     * \param[in] entry - Expired entry.
+     */
+    void RunEntry(std::unique_lock<std::mutex>& lock, TimerEntry& entry);
+    /*!
+     * \brief Is an entry's callback running on another thread, m_mutex must be held.
+     * \param[in] entry - Entry to check.
+     * \return True if running on a thread other than the caller's, false otherwise.
+     */
+    bool IsRunningElsewhere(TimerEntry const& entry) const;
+    /*!
+     * \brief Unlink an entry from whichever list it is in, m_mutex must be held.
+     * \param[in] entry - Entry to unlink.
+     * \return True if the entry was linked, false otherwise.
+     */
+    static bool Unlink(TimerEntry& entry);
+    /*!
+     * \brief Link an entry at the back of a list, m_mutex must be held.
+     * \param[in] head - List sentinel.
+     * \param[in] entry - Entry to link.
+     */
+    static void LinkBack(TimerEntry& head, TimerEntry& entry);
+
+private:
+    /*! \brief Wheel resolution. */
+    const std::chrono::milliseconds m_tick;
+    /*! \brief Synchronisation mutex. */
+    mutable std::mutex m_mutex;
+    /*! \brief Wakes the wheel thread. */
+    std::condition_variable m_wakeCondition;
+    /*! \brief Wakes the callback threads. */
+    std::condition_variable m_callbackCondition;
+    /*! \brief Signalled when a callback finishes. */
+    std::condition_variable m_callbackDoneCondition;
+    /*! \brief Wheel slots, each a sentinel of a circular list of entries. */
+    std::vector<TimerEntry> m_slots;
+    /*! \brief Sentinel of list of entries waiting for their callback to run. */
+    TimerEntry m_expired;
+    /*! \brief Slot the wheel is currently on. */
+    size_t m_currentSlot{0};
+    /*! \brief Number of ticks the wheel has advanced. */
+    uint64_t m_currentTick{0};
+    /*! \brief Tick the wheel thread is sleeping until, used to decide whether to wake it. */
+    uint64_t m_wakeTick{0};
+    /*! \brief Time the wheel next advances. */
+    std::chrono::steady_clock::time_point m_nextTickTime;
+    /*! \brief Number of pending entries. */
+    size_t m_activeTimers{0};
+    /*! \brief Entries whose callbacks are currently running and the threads running them. */
+    std::vector<std::pair<TimerEntry const*, std::thread::id>> m_running;
+    /*! \brief Stop flag. */
+    bool m_stop{false};
+    /*! \brief Wheel thread. */
+    std::thread m_thread;
+    /*! \brief Callback threads. */
+    std::vector<std::thread> m_callbackThreads;
+};
+
+} // namespace threads
+} // namespace core_lib
+
+#endif // TIMERSERVICE_H
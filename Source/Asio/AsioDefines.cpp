@@ -71,6 +71,8 @@ MessageHeader& MessageHeader::operator=(MessageHeader&& header)
 
 const connection_t NULL_CONNECTION("0.0.0.0", 0);
 
+const connection_id_t NULL_CONNECTION_ID{0};
+
 } // namespace defs
 } // namespace asio
 } // namespace core_lib
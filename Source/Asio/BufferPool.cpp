@@ -0,0 +1,228 @@
+// This file is part of CoreLibrary containing useful reusable utility
+// classes.
+//
+// Copyright (C) 2014 to present, Duncan Crutchley
+// Contact <15799155+dac1976@users.noreply.github.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License and GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License
+// and GNU Lesser General Public License along with this program. If
+// not, see <http://www.gnu.org/licenses/>.
+
+/*!
+ * \file BufferPool.cpp
+ * \brief File containing buffer pool class definition.
+ */
+
+#include "Asio/BufferPool.h"
+#include <utility>
+
+namespace core_lib
+{
+namespace asio
+{
+
+// ****************************************************************************
+// 'class BufferPool::Block' definition
+// ****************************************************************************
+BufferPool::Block::Block(BufferPool* pool, char* data, size_t size) NO_EXCEPT_
+    : m_pool(pool)
+    , m_data(data)
+    , m_size(size)
+{
+}
+
+BufferPool::Block::~Block()
+{
+    Reset();
+}
+
+BufferPool::Block::Block(Block&& block) NO_EXCEPT_
+    : m_pool(std::exchange(block.m_pool, nullptr))
+    , m_data(std::exchange(block.m_data, nullptr))
+    , m_size(std::exchange(block.m_size, 0))
+{
+}
+
+BufferPool::Block& BufferPool::Block::operator=(Block&& block) NO_EXCEPT_
+{
+    if (this != &block)
+    {
+        Reset();
+        m_pool = std::exchange(block.m_pool, nullptr);
+        m_data = std::exchange(block.m_data, nullptr);
+        m_size = std::exchange(block.m_size, 0);
+    }
+
+    return *this;
+}
+
+char* BufferPool::Block::Data() const NO_EXCEPT_
+{
+    return m_data;
+}
+
+size_t BufferPool::Block::Size() const NO_EXCEPT_
+{
+    return m_size;
+}
+
+bool BufferPool::Block::Empty() const NO_EXCEPT_
+{
+    return m_data == nullptr;
+}
+
+void BufferPool::Block::Reset() NO_EXCEPT_
+{
+    if (m_data != nullptr)
+    {
+        m_pool->Release(m_data, m_size);
+        m_pool = nullptr;
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
+
+// ****************************************************************************
+// 'class BufferPool' definition
+// ****************************************************************************
+BufferPool::BufferPool(size_t maxCachedBytes)
+    : m_maxCachedBytes(maxCachedBytes)
+{
+}
+
+BufferPool::~BufferPool()
+{
+    Trim();
+}
+
+BufferPool& BufferPool::Default()
+{
+    // Deliberately leaked so connections released during static destruction
+    // can still return their blocks.
+    static BufferPool* pool = new BufferPool();
+    return *pool;
+}
+
+BufferPool::Block BufferPool::Acquire(size_t size)
+{
+    auto const sizeClass = SizeClass(size);
+    char*      data      = nullptr;
+
+    if (sizeClass < NUM_SIZE_CLASSES)
+    {
+        size = MIN_BLOCK_SIZE << sizeClass;
+
+        auto& freeList = m_freeLists[sizeClass];
+
+        {
+            std::lock_guard<std::mutex> lock{freeList.mutex};
+
+            if (!freeList.blocks.empty())
+            {
+                data = freeList.blocks.back();
+                freeList.blocks.pop_back();
+            }
+        }
+
+        if (data != nullptr)
+        {
+            m_cachedBytes.fetch_sub(size, std::memory_order_relaxed);
+        }
+    }
+
+    if (data == nullptr)
+    {
+        data = new char[size];
+    }
+
+    m_bytesInUse.fetch_add(size, std::memory_order_relaxed);
+    return Block(this, data, size);
+}
+
+size_t BufferPool::CachedBytes() const NO_EXCEPT_
+{
+    return m_cachedBytes.load(std::memory_order_relaxed);
+}
+
+size_t BufferPool::BytesInUse() const NO_EXCEPT_
+{
+    return m_bytesInUse.load(std::memory_order_relaxed);
+}
+
+void BufferPool::Trim()
+{
+    for (size_t sizeClass = 0; sizeClass < NUM_SIZE_CLASSES; ++sizeClass)
+    {
+        std::vector<char*> blocks;
+
+        {
+            std::lock_guard<std::mutex> lock{m_freeLists[sizeClass].mutex};
+            blocks.swap(m_freeLists[sizeClass].blocks);
+        }
+
+        m_cachedBytes.fetch_sub(blocks.size() * (MIN_BLOCK_SIZE << sizeClass),
+                                std::memory_order_relaxed);
+
+        for (auto data : blocks)
+        {
+            delete[] data;
+        }
+    }
+}
+
+void BufferPool::Release(char* data, size_t size) NO_EXCEPT_
+{
+    m_bytesInUse.fetch_sub(size, std::memory_order_relaxed);
+
+    auto const sizeClass = SizeClass(size);
+
+    // Reserve room in the cache before publishing the block so concurrent
+    // releases can never take it over its limit.
+    if ((sizeClass < NUM_SIZE_CLASSES) &&
+        (m_cachedBytes.fetch_add(size, std::memory_order_relaxed) + size <= m_maxCachedBytes))
+    {
+        try
+        {
+            std::lock_guard<std::mutex> lock{m_freeLists[sizeClass].mutex};
+            m_freeLists[sizeClass].blocks.push_back(data);
+            return;
+        }
+        catch (...)
+        {
+            // Free list could not grow so fall through and free the block.
+        }
+    }
+
+    if (sizeClass < NUM_SIZE_CLASSES)
+    {
+        m_cachedBytes.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    delete[] data;
+}
+
+size_t BufferPool::SizeClass(size_t size) NO_EXCEPT_
+{
+    size_t sizeClass = 0;
+
+    while ((sizeClass < NUM_SIZE_CLASSES) && ((MIN_BLOCK_SIZE << sizeClass) < size))
+    {
+        ++sizeClass;
+    }
+
+    return sizeClass;
+}
+
+} // namespace asio
+} // namespace core_lib
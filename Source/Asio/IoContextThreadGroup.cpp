@@ -25,7 +25,9 @@
  */
 
 #include "Asio/IoContextThreadGroup.h"
+#include "Threads/ThreadPriority.h"
 #include <algorithm>
+#include <atomic>
 #include <functional>
 
 namespace core_lib
@@ -33,22 +35,182 @@ namespace core_lib
 namespace asio
 {
 
+namespace io_context_impl
+{
+
+// ****************************************************************************
+// 'class TimerTask' definition
+// ****************************************************************************
+/*! \brief A function scheduled on an IoContextThreadGroup's steady_timer. */
+class TimerTask final : public std::enable_shared_from_this<TimerTask>
+{
+public:
+    TimerTask(IoContextThreadGroup& group, std::function<void()> function,
+              std::chrono::steady_clock::duration period, asio_compat::strand_t* strand)
+        : m_group(group)
+        , m_timer(group.NextIoService())
+        , m_function(std::move(function))
+        , m_period(period)
+        , m_strand(strand)
+    {
+    }
+
+    void Start(std::chrono::steady_clock::time_point when)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_expiry = when;
+        AsyncWait();
+    }
+
+    void Cancel()
+    {
+        m_cancelled = true;
+
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_timer.cancel();
+    }
+
+    bool Cancelled() const
+    {
+        return m_cancelled;
+    }
+
+private:
+    // m_mutex must be held.
+    void AsyncWait()
+    {
+        m_timer.expires_at(m_expiry);
+
+        auto handler = [weakSelf = weak_from_this()](boost::system::error_code const& error) {
+            if (auto self = weakSelf.lock())
+            {
+                self->OnTimer(error);
+            }
+        };
+
+        if (nullptr != m_strand)
+        {
+            m_timer.async_wait(asio_compat::wrap(*m_strand, std::move(handler)));
+        }
+        else
+        {
+            m_timer.async_wait(std::move(handler));
+        }
+    }
+
+    void OnTimer(boost::system::error_code const& error)
+    {
+        if (error || m_cancelled)
+        {
+            m_group.RemoveTimer(shared_from_this());
+            return;
+        }
+
+        try
+        {
+            m_function();
+        }
+        catch (...)
+        {
+            // Do nothing, an exception must not escape into the I/O service.
+        }
+
+        if (m_period == std::chrono::steady_clock::duration::zero())
+        {
+            m_group.RemoveTimer(shared_from_this());
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock{m_mutex};
+
+        if (m_cancelled)
+        {
+            m_group.RemoveTimer(shared_from_this());
+            return;
+        }
+
+        // Keep to the original schedule, skipping any periods we overran.
+        m_expiry += m_period;
+        const auto now = std::chrono::steady_clock::now();
+
+        if (m_expiry <= now)
+        {
+            m_expiry += ((now - m_expiry) / m_period + 1) * m_period;
+        }
+
+        AsyncWait();
+    }
+
+private:
+    IoContextThreadGroup&                 m_group;
+    std::mutex                            m_mutex;
+    boost::asio::steady_timer             m_timer;
+    std::function<void()>                 m_function;
+    std::chrono::steady_clock::duration   m_period;
+    asio_compat::strand_t*                m_strand;
+    std::chrono::steady_clock::time_point m_expiry;
+    std::atomic<bool>                     m_cancelled{false};
+};
+
+} // namespace io_context_impl
+
+// ****************************************************************************
+// 'class TimerHandle' definition
+// ****************************************************************************
+TimerHandle::TimerHandle(std::weak_ptr<io_context_impl::TimerTask> task)
+    : m_task(std::move(task))
+{
+}
+
+void TimerHandle::Cancel()
+{
+    if (auto task = m_task.lock())
+    {
+        task->Cancel();
+    }
+}
+
+bool TimerHandle::IsPending() const
+{
+    auto task = m_task.lock();
+    return task && !task->Cancelled();
+}
+
 // ****************************************************************************
 // 'class IoContextThreadGroup' definition
 // ****************************************************************************
-IoContextThreadGroup::IoContextThreadGroup(unsigned int numThreads)
-    : m_ioWork(asio_compat::make_work_guard(m_ioService))
+IoContextThreadGroup::IoContextThreadGroup(unsigned int numThreads, eIoContextMode mode,
+                                           bool pinThreads)
+    : m_mode(mode)
 {
     const unsigned int numThreadsToUse = std::max(static_cast<unsigned int>(1), numThreads);
+    const unsigned int numServices =
+        m_mode == eIoContextMode::perThread ? numThreadsToUse : 1;
+
+    for (unsigned int s = 0; s < numServices; ++s)
+    {
+        // Tell each per-thread context it is only ever run by one thread.
+        m_ioServices.emplace_back(m_mode == eIoContextMode::perThread
+                                      ? std::make_unique<asio_compat::io_service_t>(1)
+                                      : std::make_unique<asio_compat::io_service_t>());
+        m_ioWorks.emplace_back(asio_compat::make_work_guard(*m_ioServices.back()));
+    }
+
+    const auto numCpus = std::max(std::thread::hardware_concurrency(), 1U);
 
     for (unsigned int t = 0; t < numThreadsToUse; ++t)
     {
-        auto* svc = &m_ioService;
+        auto* svc = m_ioServices[t % numServices].get();
 
-        m_threadGroup.CreateThread([svc]()
+        auto thread = m_threadGroup.CreateThread([svc]()
         {
             (void)svc->run();
         });
+
+        if (pinThreads)
+        {
+            threads::SetThreadAffinity(thread->native_handle(), t % numCpus);
+        }
     }
 }
 
@@ -59,7 +221,38 @@ IoContextThreadGroup::~IoContextThreadGroup()
 
 asio_compat::io_service_t& IoContextThreadGroup::IoService()
 {
-    return m_ioService;
+    return *m_ioServices.front();
+}
+
+asio_compat::io_service_t& IoContextThreadGroup::IoService(size_t index)
+{
+    return *m_ioServices.at(index);
+}
+
+asio_compat::io_service_t& IoContextThreadGroup::NextIoService()
+{
+    if (m_ioServices.size() == 1)
+    {
+        return *m_ioServices.front();
+    }
+
+    return *m_ioServices[m_nextIoService++ % m_ioServices.size()];
+}
+
+size_t IoContextThreadGroup::NumIoServices() const
+{
+    return m_ioServices.size();
+}
+
+eIoContextMode IoContextThreadGroup::Mode() const
+{
+    return m_mode;
+}
+
+size_t IoContextThreadGroup::PendingTimers() const
+{
+    std::lock_guard<std::mutex> lock{m_timersMutex};
+    return m_timers.size();
 }
 
 void IoContextThreadGroup::Stop()
@@ -67,14 +260,48 @@ void IoContextThreadGroup::Stop()
 #if (BOOST_VERSION >= 106600)
     // Let run() exit cleanly once queued work drains (optional, but correct).
     // Then stop() to force unblock if needed.
-    m_ioWork.reset();
+    for (auto& ioWork : m_ioWorks)
+    {
+        ioWork.reset();
+    }
 #endif
 
-    if (!m_ioService.stopped())
-        m_ioService.stop();
+    for (auto& ioService : m_ioServices)
+    {
+        if (!ioService->stopped())
+            ioService->stop();
+    }
 
     m_threadGroup.JoinAll();
 }
 
+TimerHandle IoContextThreadGroup::ScheduleTimer(std::chrono::steady_clock::time_point when,
+                                                std::chrono::steady_clock::duration   period,
+                                                std::function<void()>                 function,
+                                                asio_compat::strand_t*                strand)
+{
+    if (!function)
+    {
+        BOOST_THROW_EXCEPTION(std::invalid_argument("invalid timer function"));
+    }
+
+    auto task =
+        std::make_shared<io_context_impl::TimerTask>(*this, std::move(function), period, strand);
+
+    {
+        std::lock_guard<std::mutex> lock{m_timersMutex};
+        m_timers.insert(task);
+    }
+
+    task->Start(when);
+    return TimerHandle(task);
+}
+
+void IoContextThreadGroup::RemoveTimer(std::shared_ptr<io_context_impl::TimerTask> const& task)
+{
+    std::lock_guard<std::mutex> lock{m_timersMutex};
+    m_timers.erase(task);
+}
+
 } // namespace asio
 } // namespace core_lib
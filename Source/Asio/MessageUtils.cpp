@@ -74,15 +74,17 @@ MessageHandler& MessageHandler::operator=(MessageHandler&& mh)
     std::swap(m_messageDispatcher, mh.m_messageDispatcher);
     m_magicString.swap(mh.m_magicString);
     m_msgPool.swap(mh.m_msgPool);
+    std::swap(m_maxDirectBodySize, mh.m_maxDirectBodySize);
 }
 #endif
 
 MessageHandler::MessageHandler(const defs::default_message_dispatcher_t& messageDispatcher,
                                std::string_view magicString, size_t memPoolMsgCount,
-                               size_t defaultMsgSize)
+                               size_t defaultMsgSize, size_t maxDirectBodySize)
     : m_messageDispatcher(messageDispatcher)
     , m_magicString(magicString)
     , m_msgPool(std::make_shared<msg_pool_t>(memPoolMsgCount, defaultMsgSize))
+    , m_maxDirectBodySize(maxDirectBodySize)
 {
 }
 
@@ -164,6 +166,53 @@ void MessageHandler::MessageReceivedHandler(defs::char_buf_cspan_t message) cons
     m_messageDispatcher(receivedMessage);
 }
 
+bool MessageHandler::PrepareBodyReceive(defs::char_buf_cspan_t   header,
+                                        defs::BodyReceiveTarget& target) const
+{
+    if (!CheckMessage(header))
+    {
+#if defined(USE_SOCKET_DEBUG)
+        DEBUG_MESSAGE_EX_ERROR("Incomplete message header");
+#endif
+        return false;
+    }
+
+    auto const bodyLength = CheckBytesLeftToRead(header.first(defs::MESSAGE_HEADER_LEN));
+
+    if (std::numeric_limits<size_t>::max() == bodyLength)
+    {
+        return false;
+    }
+
+    // Don't trust the peer's length for a large body, let the connection grow its buffer as
+    // the data actually arrives instead.
+    if (bodyLength > m_maxDirectBodySize)
+    {
+        return false;
+    }
+
+    auto receivedMessage = m_msgPool->Acquire(bodyLength);
+
+    if (!TryConvertToPod<defs::MessageHeader>(receivedMessage->header, header))
+    {
+#if defined(USE_SOCKET_DEBUG)
+        DEBUG_MESSAGE_EX_ERROR("Failed to convert first 80 bytes of buffer to HGL_MSG_HDR");
+#endif
+        return false;
+    }
+
+    // Pool messages already have this capacity reserved so this does not reallocate.
+    receivedMessage->body.resize(bodyLength);
+
+    target.body       = receivedMessage->body;
+    target.onComplete = [this, receivedMessage]()
+    {
+        m_messageDispatcher(receivedMessage);
+    };
+
+    return true;
+}
+
 bool MessageHandler::CheckMessage(defs::char_buf_cspan_t message)
 {
     return message.size() >= sizeof(defs::MessageHeader);
@@ -310,6 +359,7 @@ MessageBuilder::MessageBuilder(MessageBuilder&& mb)
 MessageBuilder& MessageBuilder::operator=(MessageBuilder&& mb)
 {
     m_magicString.swap(mb.m_magicString);
+    std::swap(m_mode, mb.m_mode);
 }
 #endif
 
@@ -318,17 +368,41 @@ MessageBuilder::MessageBuilder(std::string_view magicString)
 {
 }
 
+MessageBuilder::MessageBuilder(std::string_view magicString, eBuilderMode mode)
+    : m_magicString(magicString)
+    , m_mode(mode)
+{
+}
+
+bool MessageBuilder::ThreadSafe() const
+{
+    return m_mode == eBuilderMode::perThreadBuffers;
+}
+
+defs::char_buffer_t& MessageBuilder::MessageBuffer() const
+{
+    if (m_mode == eBuilderMode::perThreadBuffers)
+    {
+        thread_local defs::char_buffer_t threadMessageBuffer;
+        return threadMessageBuffer;
+    }
+
+    return m_messageBuffer;
+}
+
 auto MessageBuilder::Build(int32_t messageId, const defs::connection_t& responseAddress) const
     -> defs::char_buf_cspan_t
 {
+    auto& messageBuffer = MessageBuffer();
+
     // Resize message buffer.
     auto totalLength = sizeof(defs::MessageHeader);
-    m_messageBuffer.resize(totalLength);
+    messageBuffer.resize(totalLength);
 
-    defs::MessageHeader* header = reinterpret_cast<defs::MessageHeader*>(m_messageBuffer.data());
+    defs::MessageHeader* header = reinterpret_cast<defs::MessageHeader*>(messageBuffer.data());
     FillHeader(m_magicString, defs::eArchiveType::raw, messageId, responseAddress, 0, *header);
 
-    return m_messageBuffer;
+    return messageBuffer;
 }
 
 auto MessageBuilder::Build(defs::char_buf_cspan_t message, int32_t messageId,
@@ -340,12 +414,14 @@ auto MessageBuilder::Build(defs::char_buf_cspan_t message, int32_t messageId,
         BOOST_THROW_EXCEPTION(std::runtime_error("message is empty"));
     }
 
+    auto& messageBuffer = MessageBuffer();
+
     // Resize message buffer.
     auto totalLength = sizeof(defs::MessageHeader) + message.size();
-    m_messageBuffer.resize(totalLength);
+    messageBuffer.resize(totalLength);
 
     // Fill header.
-    defs::MessageHeader* header = reinterpret_cast<defs::MessageHeader*>(m_messageBuffer.data());
+    defs::MessageHeader* header = reinterpret_cast<defs::MessageHeader*>(messageBuffer.data());
     FillHeader(m_magicString,
                archiveType,
                messageId,
@@ -353,10 +429,10 @@ auto MessageBuilder::Build(defs::char_buf_cspan_t message, int32_t messageId,
                static_cast<uint32_t>(message.size()),
                *header);
 
-    auto writePosIter = std::next(m_messageBuffer.begin(), sizeof(defs::MessageHeader));
+    auto writePosIter = std::next(messageBuffer.begin(), sizeof(defs::MessageHeader));
     std::copy(message.data(), message.data() + message.size(), writePosIter);
 
-    return m_messageBuffer;
+    return messageBuffer;
 }
 
 } // namespace messages
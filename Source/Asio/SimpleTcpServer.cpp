@@ -47,7 +47,8 @@ SimpleTcpServer::SimpleTcpServer(asio_compat::io_service_t& ioService,
     : m_messageHandler{messageDispatcher,
                        defs::DEFAULT_MAGIC_STRING,
                        settings.memPoolMsgCount,
-                       settings.recvPoolMsgSize}
+                       settings.recvPoolMsgSize,
+                       settings.connSettings.maxDirectBodySize}
     , m_tcpTypedServer{ioService,
                        listenPort,
                        std::bind(&messages::MessageHandler::CheckBytesLeftToRead, &m_messageHandler,
@@ -57,7 +58,9 @@ SimpleTcpServer::SimpleTcpServer(asio_compat::io_service_t& ioService,
                        m_messageBuilder,
                        settings.connSettings,
                        defs::message_received_handler_ex_t(),
-                       defs::check_bytes_left_to_read_ex_t()}
+                       defs::check_bytes_left_to_read_ex_t(),
+                       std::bind(&messages::MessageHandler::PrepareBodyReceive, &m_messageHandler,
+                                 std::placeholders::_1, std::placeholders::_2)}
 {
 }
 
@@ -67,7 +70,8 @@ SimpleTcpServer::SimpleTcpServer(uint16_t listenPort,
     : m_messageHandler{messageDispatcher,
                        defs::DEFAULT_MAGIC_STRING,
                        settings.memPoolMsgCount,
-                       settings.recvPoolMsgSize}
+                       settings.recvPoolMsgSize,
+                       settings.connSettings.maxDirectBodySize}
     , m_tcpTypedServer{listenPort,
                        std::bind(&messages::MessageHandler::CheckBytesLeftToRead, &m_messageHandler,
                                  std::placeholders::_1),
@@ -76,7 +80,9 @@ SimpleTcpServer::SimpleTcpServer(uint16_t listenPort,
                        m_messageBuilder,
                        settings.connSettings,
                        defs::message_received_handler_ex_t(),
-                       defs::check_bytes_left_to_read_ex_t()}
+                       defs::check_bytes_left_to_read_ex_t(),
+                       std::bind(&messages::MessageHandler::PrepareBodyReceive, &m_messageHandler,
+                                 std::placeholders::_1, std::placeholders::_2)}
 {
 }
 
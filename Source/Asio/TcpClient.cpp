@@ -42,13 +42,15 @@ TcpClient::TcpClient(asio_compat::io_service_t& ioService, defs::connection_t co
                      defs::message_received_handler_t const&    messageReceivedHandler,
                      TcpConnSettings const&                     settings,
                      defs::message_received_handler_ex_t const& messageReceivedHandlerEx,
-                     defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx)
+                     defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx,
+                     defs::prepare_body_receive_t const&        prepareBodyReceive)
     : m_ioService(ioService)
     , m_server{server}
     , m_checkBytesLeftToRead{checkBytesLeftToRead}
     , m_checkBytesLeftToReadEx{checkBytesLeftToReadEx}
     , m_messageReceivedHandler{messageReceivedHandler}
     , m_messageReceivedHandlerEx{messageReceivedHandlerEx}
+    , m_prepareBodyReceive{prepareBodyReceive}
     , m_settings{settings}
     , m_serverConnection(std::make_shared<TcpConnections>())
 {
@@ -63,7 +65,8 @@ TcpClient::TcpClient(defs::connection_t const&                  server,
                      defs::message_received_handler_t const&    messageReceivedHandler,
                      TcpConnSettings const&                     settings,
                      defs::message_received_handler_ex_t const& messageReceivedHandlerEx,
-                     defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx)
+                     defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx,
+                     defs::prepare_body_receive_t const&        prepareBodyReceive)
     : m_ioThreadGroup{new IoContextThreadGroup(1)}
     , m_ioService(m_ioThreadGroup->IoService())
     , m_server{server}
@@ -71,6 +74,7 @@ TcpClient::TcpClient(defs::connection_t const&                  server,
     , m_checkBytesLeftToReadEx{checkBytesLeftToReadEx}
     , m_messageReceivedHandler{messageReceivedHandler}
     , m_messageReceivedHandlerEx{messageReceivedHandlerEx}
+    , m_prepareBodyReceive{prepareBodyReceive}
     , m_settings{settings}
     , m_serverConnection(std::make_shared<TcpConnections>())
 {
@@ -137,6 +141,11 @@ size_t TcpClient::NumberOfUnsentAsyncMessages() const
     return m_serverConnection->NumberOfUnsentAsyncMessages(m_server);
 }
 
+SendPoolStatistics TcpClient::SendPoolStats() const
+{
+    return m_serverConnection->SendPoolStats(m_server);
+}
+
 void TcpClient::CreateConnection()
 {
     try
@@ -147,7 +156,8 @@ void TcpClient::CreateConnection()
 												  m_messageReceivedHandler,
 												  m_settings,
 												  m_messageReceivedHandlerEx,
-												  m_checkBytesLeftToReadEx);
+												  m_checkBytesLeftToReadEx,
+												  m_prepareBodyReceive);
         connection->Connect(m_server);
     }
     catch (...)
@@ -28,6 +28,8 @@
 #include "Asio/TcpConnections.h"
 #include <algorithm>
 #include <limits>
+#include <cstring>
+#include <stdexcept>
 #include <boost/bind.hpp>
 #if defined(USE_SOCKET_DEBUG)
 #include <boost/exception/all.hpp>
@@ -41,6 +43,31 @@ namespace asio
 namespace tcp
 {
 
+namespace
+{
+
+/*! \brief Free-list link marking the end of the send pool free-list. */
+constexpr uint32_t END_OF_POOL_FREE_LIST = UINT32_MAX;
+
+/*!
+ * \brief Build a send pool free-list head.
+ * \param[in] oldHead - Head being replaced, its ABA tag is incremented.
+ * \param[in] index - Pool index at the top of the free-list.
+ * \return New head.
+ */
+constexpr uint64_t NextPoolFreeHead(uint64_t oldHead, uint32_t index) NO_EXCEPT_
+{
+    return (((oldHead >> 32) + 1) << 32) | index;
+}
+
+defs::connection_id_t NextUniqueConnectionId() NO_EXCEPT_
+{
+    static std::atomic<defs::connection_id_t> s_nextId{defs::NULL_CONNECTION_ID};
+    return s_nextId.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+} // namespace
+
 // ****************************************************************************
 // 'class TcpConnection' definition
 // ****************************************************************************
@@ -50,7 +77,10 @@ TcpConnection::TcpConnection(asio_compat::io_service_t&                 ioServic
                              const defs::message_received_handler_t&    messageReceivedHandler,
                              const TcpConnSettings&                     settings,
                              const defs::message_received_handler_ex_t& messageReceivedHandlerEx,
-                             const defs::check_bytes_left_to_read_ex_t& checkBytesLeftToReadEx)
+                             const defs::check_bytes_left_to_read_ex_t& checkBytesLeftToReadEx,
+                             const defs::prepare_body_receive_t&        prepareBodyReceive,
+                             const defs::message_received_handler_id_t& messageReceivedHandlerId,
+                             const defs::check_bytes_left_to_read_id_t& checkBytesLeftToReadId)
     : m_closing{false}
     , m_strand(asio_compat::make_strand(ioService))
     , m_connections{connections}
@@ -58,13 +88,28 @@ TcpConnection::TcpConnection(asio_compat::io_service_t&                 ioServic
     , m_checkBytesLeftToReadEx{checkBytesLeftToReadEx}
     , m_messageReceivedHandler{messageReceivedHandler}
     , m_messageReceivedHandlerEx{messageReceivedHandlerEx}
+    , m_checkBytesLeftToReadId{checkBytesLeftToReadId}
+    , m_messageReceivedHandlerId{messageReceivedHandlerId}
+    , m_prepareBodyReceive{prepareBodyReceive}
     , m_settings{settings}
     , m_connectEvent(threads::eNotifyType::signalOneThread, threads::eResetCondition::manualReset,
                      threads::eIntialCondition::notSignalled)
+    , m_id{NextUniqueConnectionId()}
     , m_socket{ioService}
 {
     InitialiseMsgPool();
 
+    if ((m_settings.readMode == eReadMode::directToBody) && !m_prepareBodyReceive)
+    {
+        m_settings.readMode = eReadMode::headerThenBody;
+    }
+
+    if (m_settings.bufferMode == eBufferMode::onDemand)
+    {
+        // Buffers are taken from the shared pool when the first data arrives.
+        return;
+    }
+
 #if defined(USE_SOCKET_DEBUG)
     DEBUG_MESSAGE_EX_DEBUG("Reserving memory for receive buffer as: "
                            << static_cast<int32_t>(DEFAULT_SMALL_RESERVED_SIZE)
@@ -72,7 +117,16 @@ TcpConnection::TcpConnection(asio_compat::io_service_t&                 ioServic
                            << static_cast<int32_t>(DEFAULT_LARGE_RESERVED_SIZE) << " bytes");
 #endif
 
-    m_messageBuffer.reserve(DEFAULT_LARGE_RESERVED_SIZE);
+    if (m_settings.readMode == eReadMode::streaming)
+    {
+        // In streaming mode the message buffer is read into directly so it must be sized.
+        m_messageBuffer.resize(DEFAULT_LARGE_RESERVED_SIZE);
+    }
+    else
+    {
+        ReceiveBuffer(DEFAULT_SMALL_RESERVED_SIZE);
+        m_messageBuffer.reserve(DEFAULT_LARGE_RESERVED_SIZE);
+    }
 }
 
 boost_tcp_t::socket& TcpConnection::Socket()
@@ -277,10 +331,21 @@ void TcpConnection::DestroySelfOnStrand()
 
 void TcpConnection::StartAsyncRead(const defs::connection_t& endPoint)
 {
+    // Capture the remote end once here rather than querying the socket for every message.
+    defs::connection_t remoteEndPoint = endPoint;
+    boost_sys::error_code ec;
+    auto                  rep = m_socket.remote_endpoint(ec);
+
+    if (!ec)
+    {
+        remoteEndPoint = std::make_pair(rep.address().to_string(), rep.port());
+    }
+
     // Reduce scope of mutex to store endpoint
     {
         std::lock_guard<std::mutex> lock{m_mutex};
-        m_endPoint = endPoint;
+        m_endPoint       = endPoint;
+        m_remoteEndPoint = std::move(remoteEndPoint);
     }
 
     auto self = shared_from_this();
@@ -295,16 +360,44 @@ void TcpConnection::StartAsyncRead(const defs::connection_t& endPoint)
 
     connections->Add(self->m_endPoint, self);
 
-    asio_compat::post(
-        m_strand,
-        boost::bind(&TcpConnection::AsyncReadFromSocket, self, self->m_settings.minAmountToRead));
+    if (m_settings.readMode == eReadMode::streaming)
+    {
+        asio_compat::post(m_strand, boost::bind(&TcpConnection::AsyncReadSomeFromSocket, self));
+    }
+    else if (m_settings.readMode == eReadMode::directToBody)
+    {
+        asio_compat::post(m_strand, boost::bind(&TcpConnection::AsyncReadHeaderFromSocket, self));
+    }
+    else
+    {
+        asio_compat::post(m_strand,
+                          boost::bind(&TcpConnection::AsyncReadFromSocket,
+                                      self,
+                                      self->m_settings.minAmountToRead));
+    }
 }
 
 void TcpConnection::AsyncReadFromSocket(size_t amountToRead)
 {
+    char* receiveBuffer;
+
+    try
+    {
+        receiveBuffer = ReceiveBuffer(amountToRead);
+    }
+    catch (...)
+    {
+#if defined(USE_SOCKET_DEBUG)
+        DEBUG_MESSAGE_EX_ERROR("Error allocating receive buffer, will safely self-destruct, for: "
+                               << m_endPoint.first << ":" << m_endPoint.second);
+#endif
+        DestroySelf();
+        return;
+    }
+
     // Wrap in strand just to be safe in case of multiple threads running the IO service.
     boost_asio::async_read(m_socket,
-                           boost_asio::buffer(m_receiveBuffer.data(), amountToRead),
+                           boost_asio::buffer(receiveBuffer, amountToRead),
                            asio_compat::wrap(m_strand,
                                              boost::bind(&TcpConnection::ReadComplete,
                                                          shared_from_this(),
@@ -352,41 +445,13 @@ void TcpConnection::ReadComplete(const boost_sys::error_code& error, size_t byte
             m_messageBuffer.resize(currentSize + bytesReceived);
 
             auto dataWritePos = m_messageBuffer.data() + currentSize;
-            std::copy(m_receiveBuffer.data(), m_receiveBuffer.data() + bytesReceived, dataWritePos);
+            std::copy(m_receiveBuffer.Data(), m_receiveBuffer.Data() + bytesReceived, dataWritePos);
 
-            if (m_checkBytesLeftToReadEx)
-            {
-                numBytes =
-                    m_checkBytesLeftToReadEx(m_messageBuffer,
-                                             m_socket.remote_endpoint().address().to_string(),
-                                             m_socket.remote_endpoint().port());
-            }
-            else
-            {
-                if (m_checkBytesLeftToRead)
-                {
-                    numBytes = m_checkBytesLeftToRead(m_messageBuffer);
-                }
-            }
+            numBytes = CheckBytesLeftToRead(m_messageBuffer);
 
             if (numBytes == 0)
             {
-                // Ideally only one of m_messageReceivedHandler or m_messageReceivedHandlerEx should
-                // be defined at any one time.
-
-                if (m_messageReceivedHandlerEx)
-                {
-                    m_messageReceivedHandlerEx(m_messageBuffer,
-                                               m_socket.remote_endpoint().address().to_string(),
-                                               m_socket.remote_endpoint().port());
-                }
-                else
-                {
-                    if (m_messageReceivedHandler)
-                    {
-                        m_messageReceivedHandler(m_messageBuffer);
-                    }
-                }
+                MessageReceived(m_messageBuffer);
 
                 numBytes    = m_settings.minAmountToRead;
                 clearMsgBuf = true;
@@ -419,7 +484,11 @@ void TcpConnection::ReadComplete(const boost_sys::error_code& error, size_t byte
 
     if (clearMsgBuf)
     {
-        if (m_messageBuffer.capacity() > DEFAULT_LARGE_RESERVED_SIZE)
+        if ((m_settings.bufferMode == eBufferMode::onDemand) && SocketIdle())
+        {
+            ReleaseIdleBuffers();
+        }
+        else if (m_messageBuffer.capacity() > DEFAULT_LARGE_RESERVED_SIZE)
         {
             defs::char_buffer_t tmp;
             tmp.reserve(DEFAULT_LARGE_RESERVED_SIZE);
@@ -437,55 +506,473 @@ void TcpConnection::ReadComplete(const boost_sys::error_code& error, size_t byte
         {
             // We dispatch instead of post as we are already with a strand protected posted
             // branch of execution, so dispatch will be faster and still safe.
-            asio_compat::dispatch(
-                m_strand,
-                boost::bind(&TcpConnection::AsyncReadFromSocket, shared_from_this(), numBytes));
+            if (clearMsgBuf && (m_settings.readMode == eReadMode::directToBody))
+            {
+                // Message done, directToBody only uses this path for bodies it declined.
+                asio_compat::dispatch(
+                    m_strand,
+                    boost::bind(&TcpConnection::AsyncReadHeaderFromSocket, shared_from_this()));
+            }
+            else
+            {
+                asio_compat::dispatch(
+                    m_strand,
+                    boost::bind(&TcpConnection::AsyncReadFromSocket, shared_from_this(), numBytes));
+            }
         }
         // else: closing -> don't schedule further reads
     }
 }
 
-bool TcpConnection::SendMessageAsync(defs::char_buf_cspan_t message)
+void TcpConnection::AsyncReadSomeFromSocket()
 {
-    // Copying overload: accepts if we can reserve a slot.
-    // We *prepare* the pool/dynamic backing store before posting to the strand to avoid
-    // per-send allocations when the pool is enabled.
-    // "true" means accepted/queued for sending by this connection (not that it reached the wire).
-    if (IsClosing())
+    if ((m_settings.bufferMode == eBufferMode::onDemand) && m_messageBuffer.empty())
     {
-        return false;
+        AsyncWaitReadable();
+        return;
     }
 
-    PendingWrite w;
+    // Move any partial message to the front of the buffer so the free space is contiguous.
+    if (m_streamReadPos > 0)
+    {
+        auto const pending = m_streamWritePos - m_streamReadPos;
 
-    if (!AcquirePendingWrite(message, w))
+        if (pending > 0)
+        {
+            std::memmove(
+                m_messageBuffer.data(), m_messageBuffer.data() + m_streamReadPos, pending);
+        }
+
+        m_streamReadPos  = 0;
+        m_streamWritePos = pending;
+    }
+
+    // A single message larger than the buffer has filled it, so grow to make room.
+    if (m_streamWritePos == m_messageBuffer.size())
     {
-        return false;
+        m_messageBuffer.resize(
+            std::max(m_messageBuffer.size() * 2, static_cast<size_t>(DEFAULT_SMALL_RESERVED_SIZE)));
     }
 
-    try
+    m_socket.async_read_some(
+        boost_asio::buffer(m_messageBuffer.data() + m_streamWritePos,
+                           m_messageBuffer.size() - m_streamWritePos),
+        asio_compat::wrap(m_strand,
+                          boost::bind(&TcpConnection::ReadSomeComplete,
+                                      shared_from_this(),
+                                      boost_placeholders::error,
+                                      boost_placeholders::bytes_transferred)));
+}
+
+void TcpConnection::ReadSomeComplete(const boost_sys::error_code& error, size_t bytesReceived)
+{
+    if (error)
     {
-        asio_compat::post(m_strand, EnqueuePreparedSendHandler(shared_from_this(), std::move(w)));
+#if defined(USE_SOCKET_DEBUG)
+        DEBUG_MESSAGE_EX_ERROR("Error in ReadSomeComplete, error: "
+                               << error.message() << ", will safely self-destruct, for: "
+                               << m_endPoint.first << ":" << m_endPoint.second);
+#endif
+        DestroySelf();
+        return;
+    }
 
-        return true;
+    m_streamWritePos += bytesReceived;
+
+    try
+    {
+        DispatchBufferedMessages();
     }
     catch (...)
     {
-        // Extremely rare (post throwing), but keep reservation accurate.
-        if (w.kind == PendingWrite::eKind::pool)
+#if defined(USE_SOCKET_DEBUG)
+        DEBUG_MESSAGE_EX_ERROR("Error in ReadSomeComplete, error: "
+                               << boost::current_exception_diagnostic_information()
+                               << ", for: " << m_endPoint.first << ":" << m_endPoint.second);
+#endif
+        // Message framing is lost so discard everything buffered.
+        m_streamReadPos  = 0;
+        m_streamWritePos = 0;
+    }
+
+    if (m_streamReadPos == m_streamWritePos)
+    {
+        m_streamReadPos  = 0;
+        m_streamWritePos = 0;
+
+        if (m_settings.bufferMode == eBufferMode::onDemand)
         {
-            ReleasePoolIndex(w.poolIndex);
+            if (SocketIdle())
+            {
+                ReleaseIdleBuffers();
+            }
         }
+        else if (m_messageBuffer.size() > DEFAULT_LARGE_RESERVED_SIZE)
+        {
+            defs::char_buffer_t tmp(DEFAULT_LARGE_RESERVED_SIZE);
+            m_messageBuffer.swap(tmp);
+        }
+    }
 
-        m_numUnsentAsyncMessages.fetch_sub(1, std::memory_order_acq_rel);
+    if (!IsClosing())
+    {
+        // We dispatch instead of post as we are already with a strand protected posted
+        // branch of execution, so dispatch will be faster and still safe.
+        asio_compat::dispatch(
+            m_strand, boost::bind(&TcpConnection::AsyncReadSomeFromSocket, shared_from_this()));
+    }
+}
+
+void TcpConnection::AsyncWaitReadable()
+{
+#if BOOST_VERSION >= 106600
+    m_socket.async_wait(boost_tcp_t::socket::wait_read,
+                        asio_compat::wrap(m_strand,
+                                          boost::bind(&TcpConnection::ReadableComplete,
+                                                      shared_from_this(),
+                                                      boost_placeholders::error)));
+#else
+    m_socket.async_read_some(boost_asio::null_buffers(),
+                             asio_compat::wrap(m_strand,
+                                               boost::bind(&TcpConnection::ReadableComplete,
+                                                           shared_from_this(),
+                                                           boost_placeholders::error)));
+#endif
+}
+
+void TcpConnection::ReadableComplete(const boost_sys::error_code& error)
+{
+    if (!error)
+    {
+        try
+        {
+            m_messageBuffer.resize(DEFAULT_SMALL_RESERVED_SIZE);
+        }
+        catch (...)
+        {
+            m_messageBuffer.clear();
+        }
+    }
 
+    if (error || m_messageBuffer.empty())
+    {
 #if defined(USE_SOCKET_DEBUG)
-        DEBUG_MESSAGE_EX_ERROR("Error in SendMessageAsync(post), error: "
+        DEBUG_MESSAGE_EX_ERROR("Error in ReadableComplete, will safely self-destruct, for: "
+                               << m_endPoint.first << ":" << m_endPoint.second);
+#endif
+        DestroySelf();
+        return;
+    }
+
+    AsyncReadSomeFromSocket();
+}
+
+void TcpConnection::DispatchBufferedMessages()
+{
+    auto const headerLen = std::max(m_settings.minAmountToRead, static_cast<size_t>(1));
+
+    while (m_streamWritePos - m_streamReadPos >= headerLen)
+    {
+        auto const available = m_streamWritePos - m_streamReadPos;
+        auto const msgStart  = m_messageBuffer.data() + m_streamReadPos;
+        size_t     msgLen    = headerLen;
+        bool       complete  = false;
+
+        // Grow the candidate message by whatever the callback says is missing until it is
+        // complete or extends beyond the bytes we have buffered.
+        while (msgLen <= available)
+        {
+            auto const bytesLeft = CheckBytesLeftToRead(defs::char_buf_cspan_t(msgStart, msgLen));
+
+            if (bytesLeft == 0)
+            {
+                complete = true;
+                break;
+            }
+
+            if (std::numeric_limits<size_t>::max() == bytesLeft)
+            {
+                throw std::runtime_error("invalid message length");
+            }
+
+            msgLen += bytesLeft;
+        }
+
+        if (!complete)
+        {
+            break;
+        }
+
+        MessageReceived(defs::char_buf_cspan_t(msgStart, msgLen));
+        m_streamReadPos += msgLen;
+    }
+}
+
+void TcpConnection::AsyncReadHeaderFromSocket()
+{
+    char* receiveBuffer;
+
+    try
+    {
+        receiveBuffer = ReceiveBuffer(m_settings.minAmountToRead);
+    }
+    catch (...)
+    {
+#if defined(USE_SOCKET_DEBUG)
+        DEBUG_MESSAGE_EX_ERROR("Error allocating receive buffer, will safely self-destruct, for: "
+                               << m_endPoint.first << ":" << m_endPoint.second);
+#endif
+        DestroySelf();
+        return;
+    }
+
+    boost_asio::async_read(m_socket,
+                           boost_asio::buffer(receiveBuffer, m_settings.minAmountToRead),
+                           asio_compat::wrap(m_strand,
+                                             boost::bind(&TcpConnection::HeaderReadComplete,
+                                                         shared_from_this(),
+                                                         boost_placeholders::error,
+                                                         boost_placeholders::bytes_transferred)));
+}
+
+void TcpConnection::HeaderReadComplete(const boost_sys::error_code& error, size_t bytesReceived)
+{
+    if (error)
+    {
+#if defined(USE_SOCKET_DEBUG)
+        DEBUG_MESSAGE_EX_ERROR("Error in HeaderReadComplete, error: "
+                               << error.message() << ", will safely self-destruct, for: "
+                               << m_endPoint.first << ":" << m_endPoint.second);
+#endif
+        DestroySelf();
+        return;
+    }
+
+    bool haveTarget = false;
+
+    try
+    {
+        haveTarget = m_prepareBodyReceive(
+            defs::char_buf_cspan_t(m_receiveBuffer.Data(), bytesReceived), m_bodyTarget);
+    }
+    catch (...)
+    {
+#if defined(USE_SOCKET_DEBUG)
+        DEBUG_MESSAGE_EX_ERROR("Error in HeaderReadComplete, error: "
                                << boost::current_exception_diagnostic_information()
                                << ", for: " << m_endPoint.first << ":" << m_endPoint.second);
 #endif
+    }
+
+    if (!haveTarget)
+    {
+        m_bodyTarget = defs::BodyReceiveTarget{};
+
+        if (m_checkBytesLeftToReadId || m_checkBytesLeftToReadEx || m_checkBytesLeftToRead)
+        {
+            // The body is too large to read directly, or the header is invalid, so handle this
+            // message as in headerThenBody mode. That reads the body in chunks as it arrives, or
+            // drops an invalid header, then goes back to reading headers.
+            ReadComplete(boost_sys::error_code(), bytesReceived, bytesReceived);
+            return;
+        }
+
+        // Invalid header so drop it and try to read the next one.
+    }
+    else if (!m_bodyTarget.body.empty())
+    {
+        if (!IsClosing())
+        {
+            asio_compat::dispatch(
+                m_strand, boost::bind(&TcpConnection::AsyncReadBodyFromSocket, shared_from_this()));
+        }
+
+        return;
+    }
+
+    CompleteBodyReceive();
+}
+
+void TcpConnection::AsyncReadBodyFromSocket()
+{
+    boost_asio::async_read(m_socket,
+                           boost_asio::buffer(m_bodyTarget.body.data(), m_bodyTarget.body.size()),
+                           asio_compat::wrap(m_strand,
+                                             boost::bind(&TcpConnection::BodyReadComplete,
+                                                         shared_from_this(),
+                                                         boost_placeholders::error,
+                                                         boost_placeholders::bytes_transferred)));
+}
+
+void TcpConnection::BodyReadComplete(const boost_sys::error_code&    error,
+                                     CORELIB_ARG_MAYBE_UNUSED size_t bytesReceived)
+{
+    CORELIB_UNUSED_ARG(bytesReceived)
+
+    if (error)
+    {
+#if defined(USE_SOCKET_DEBUG)
+        DEBUG_MESSAGE_EX_ERROR("Error in BodyReadComplete, error: "
+                               << error.message() << ", will safely self-destruct, for: "
+                               << m_endPoint.first << ":" << m_endPoint.second);
+#endif
+        m_bodyTarget = defs::BodyReceiveTarget{};
+        DestroySelf();
+        return;
+    }
+
+    CompleteBodyReceive();
+}
+
+void TcpConnection::CompleteBodyReceive()
+{
+    // Take ownership first so whatever the callback holds is released once it returns.
+    auto onComplete = std::move(m_bodyTarget.onComplete);
+    m_bodyTarget    = defs::BodyReceiveTarget{};
+
+    if (onComplete)
+    {
+        try
+        {
+            onComplete();
+        }
+        catch (...)
+        {
+#if defined(USE_SOCKET_DEBUG)
+            DEBUG_MESSAGE_EX_ERROR("Error in CompleteBodyReceive, error: "
+                                   << boost::current_exception_diagnostic_information()
+                                   << ", for: " << m_endPoint.first << ":" << m_endPoint.second);
+#endif
+        }
+    }
+
+    if (!IsClosing())
+    {
+        asio_compat::dispatch(
+            m_strand, boost::bind(&TcpConnection::AsyncReadHeaderFromSocket, shared_from_this()));
+    }
+}
+
+size_t TcpConnection::CheckBytesLeftToRead(defs::char_buf_cspan_t message)
+{
+    if (m_checkBytesLeftToReadId)
+    {
+        return m_checkBytesLeftToReadId(
+            message, m_remoteEndPoint.first, m_remoteEndPoint.second, m_id);
+    }
+
+    if (m_checkBytesLeftToReadEx)
+    {
+        return m_checkBytesLeftToReadEx(message, m_remoteEndPoint.first, m_remoteEndPoint.second);
+    }
+
+    if (m_checkBytesLeftToRead)
+    {
+        return m_checkBytesLeftToRead(message);
+    }
+
+    return 0;
+}
+
+char* TcpConnection::ReceiveBuffer(size_t size)
+{
+    if (m_receiveBuffer.Size() < size)
+    {
+        // When preallocating take a full sized chunk so the block is never swapped.
+        if (m_settings.bufferMode != eBufferMode::onDemand)
+        {
+            size = std::max(size, static_cast<size_t>(DEFAULT_SMALL_RESERVED_SIZE));
+        }
+
+        m_receiveBuffer = BufferPool::Default().Acquire(size);
+    }
+
+    return m_receiveBuffer.Data();
+}
+
+bool TcpConnection::SocketIdle()
+{
+    boost_sys::error_code ec;
+    auto const            available = m_socket.available(ec);
+    return ec || (available == 0);
+}
+
+void TcpConnection::ReleaseIdleBuffers()
+{
+    // Keep a block only just big enough for the next header read, anything at
+    // least twice that size came from reading a message body.
+    auto const headerBlockLimit =
+        2 * std::max(m_settings.minAmountToRead, BufferPool::MIN_BLOCK_SIZE);
+
+    if ((m_settings.readMode == eReadMode::streaming) ||
+        (m_receiveBuffer.Size() >= headerBlockLimit))
+    {
+        m_receiveBuffer.Reset();
+    }
+
+    defs::char_buffer_t().swap(m_messageBuffer);
+}
+
+void TcpConnection::MessageReceived(defs::char_buf_cspan_t message)
+{
+    // Ideally only one of m_messageReceivedHandler, m_messageReceivedHandlerEx or
+    // m_messageReceivedHandlerId should be defined at any one time.
+    if (m_messageReceivedHandlerId)
+    {
+        m_messageReceivedHandlerId(
+            message, m_remoteEndPoint.first, m_remoteEndPoint.second, m_id);
+    }
+    else if (m_messageReceivedHandlerEx)
+    {
+        m_messageReceivedHandlerEx(message, m_remoteEndPoint.first, m_remoteEndPoint.second);
+    }
+    else if (m_messageReceivedHandler)
+    {
+        m_messageReceivedHandler(message);
+    }
+}
+
+bool TcpConnection::SendMessageAsync(defs::char_buf_cspan_t message)
+{
+    // Copying overload: accepts if we can reserve a slot.
+    // We *prepare* the pool/dynamic backing store before posting to the strand to avoid
+    // per-send allocations when the pool is enabled.
+    // "true" means accepted/queued for sending by this connection (not that it reached the wire).
+    if (IsClosing())
+    {
         return false;
     }
+
+    PendingWrite w;
+
+    if (!AcquirePendingWrite(message, w))
+    {
+        return false;
+    }
+
+    return PostPreparedSend(std::move(w));
+}
+
+bool TcpConnection::SendMessageAsync(const defs::shared_char_buffer_t& message)
+{
+    // Sharing overload: the buffer is referenced, not copied, so the same buffer can be
+    // queued on many connections and is freed when the last write completes.
+    if (!message || IsClosing())
+    {
+        return false;
+    }
+
+    if (!ReserveUnsentAsyncMessage())
+    {
+        return false;
+    }
+
+    PendingWrite w;
+    w.kind = PendingWrite::eKind::dynamic;
+    w.dyn  = message;
+    w.len  = message->size();
+
+    return PostPreparedSend(std::move(w));
 }
 
 bool TcpConnection::SendMessageSync(defs::char_buf_cspan_t message)
@@ -527,22 +1014,44 @@ bool TcpConnection::SendMessageSync(defs::char_buf_cspan_t message)
 
 bool TcpConnection::TryAcquirePoolIndex(size_t& idx)
 {
-    std::lock_guard<std::mutex> lock{m_poolMutex};
+    auto head = m_poolFreeHead.load(std::memory_order_acquire);
 
-    if (m_availablePoolIndices.empty())
+    for (;;)
     {
-        return false;
-    }
+        auto const top = static_cast<uint32_t>(head);
 
-    idx = m_availablePoolIndices.back();
-    m_availablePoolIndices.pop_back();
-    return true;
+        if (END_OF_POOL_FREE_LIST == top)
+        {
+            return false;
+        }
+
+        // If another thread pops this slot first the link read here may be stale, but
+        // the head's tag will have changed so the exchange below fails and we retry.
+        auto const next = m_poolNextFree[top].load(std::memory_order_relaxed);
+
+        if (m_poolFreeHead.compare_exchange_weak(head,
+                                                 NextPoolFreeHead(head, next),
+                                                 std::memory_order_acquire,
+                                                 std::memory_order_acquire))
+        {
+            idx = top;
+            return true;
+        }
+    }
 }
 
 void TcpConnection::ReleasePoolIndex(size_t idx)
 {
-    std::lock_guard<std::mutex> lock{m_poolMutex};
-    m_availablePoolIndices.push_back(idx);
+    auto const index = static_cast<uint32_t>(idx);
+    auto       head  = m_poolFreeHead.load(std::memory_order_relaxed);
+
+    do
+    {
+        m_poolNextFree[index].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+    } while (!m_poolFreeHead.compare_exchange_weak(head,
+                                                   NextPoolFreeHead(head, index),
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed));
 }
 
 // Uses move semantics hence pass by value
@@ -576,30 +1085,70 @@ void TcpConnection::StartNextWriteOnStrand()
     }
 
     m_writeInProgress = true;
-    DoAsyncWriteOnStrand(m_pendingWrites.front());
+
+    if ((m_settings.maxGatherWriteBytes > 0) && (m_pendingWrites.size() > 1))
+    {
+        DoAsyncGatherWriteOnStrand();
+    }
+    else
+    {
+        m_numWritesInFlight = 1;
+        DoAsyncWriteOnStrand(m_pendingWrites.front());
+    }
 }
 
 void TcpConnection::DoAsyncWriteOnStrand(const PendingWrite& w)
+{
+    boost_asio::async_write(
+        m_socket,
+        PendingWriteBuffer(w),
+        asio_compat::wrap(
+            m_strand,
+            boost::bind(&TcpConnection::WriteCompleteOnStrand, shared_from_this(), _1, _2)));
+}
+
+void TcpConnection::DoAsyncGatherWriteOnStrand()
+{
+    m_gatherBuffers.clear();
+
+    size_t totalBytes = 0;
+
+    for (auto const& w : m_pendingWrites)
+    {
+        if (!m_gatherBuffers.empty() && (totalBytes + w.len > m_settings.maxGatherWriteBytes))
+        {
+            break;
+        }
+
+        m_gatherBuffers.emplace_back(PendingWriteBuffer(w));
+        totalBytes += w.len;
+    }
+
+    // The buffers stay valid until completion as the pending writes covered are only
+    // released in WriteCompleteOnStrand.
+    m_numWritesInFlight = m_gatherBuffers.size();
+
+    boost_asio::async_write(
+        m_socket,
+        m_gatherBuffers,
+        asio_compat::wrap(
+            m_strand,
+            boost::bind(&TcpConnection::WriteCompleteOnStrand, shared_from_this(), _1, _2)));
+}
+
+boost_asio::const_buffer TcpConnection::PendingWriteBuffer(const PendingWrite& w) const
 {
     if (w.kind == PendingWrite::eKind::pool)
     {
-        auto& block = m_msgPool[w.poolIndex];
-        boost_asio::async_write(
-            m_socket,
-            boost_asio::buffer(block.data(), w.len),
-            asio_compat::wrap(
-                m_strand,
-                boost::bind(&TcpConnection::WriteCompleteOnStrand, shared_from_this(), _1, _2)));
+        return boost_asio::buffer(m_msgPool[w.poolIndex].data(), w.len);
     }
-    else
+
+    if (w.kind == PendingWrite::eKind::block)
     {
-        boost_asio::async_write(
-            m_socket,
-            boost_asio::buffer(w.dyn->data(), w.len),
-            asio_compat::wrap(
-                m_strand,
-                boost::bind(&TcpConnection::WriteCompleteOnStrand, shared_from_this(), _1, _2)));
+        return boost_asio::buffer(w.block.Data(), w.len);
     }
+
+    return boost_asio::buffer(w.dyn->data(), w.len);
 }
 
 void TcpConnection::WriteCompleteOnStrand(const boost_sys::error_code&    error,
@@ -614,11 +1163,15 @@ void TcpConnection::WriteCompleteOnStrand(const boost_sys::error_code&    error,
         return;
     }
 
-    // Release resources for the completed write.
-    ReleasePendingWriteOnStrand(m_pendingWrites.front());
-    m_pendingWrites.pop_front();
+    // Release resources for the completed write(s).
+    for (; (m_numWritesInFlight > 0) && !m_pendingWrites.empty(); --m_numWritesInFlight)
+    {
+        ReleasePendingWriteOnStrand(m_pendingWrites.front());
+        m_pendingWrites.pop_front();
+    }
 
-    m_writeInProgress = false;
+    m_numWritesInFlight = 0;
+    m_writeInProgress   = false;
 
     if (error)
     {
@@ -657,6 +1210,26 @@ size_t TcpConnection::NumberOfUnsentAsyncMessages() const
     return m_numUnsentAsyncMessages.load(std::memory_order_acquire);
 }
 
+SendPoolStatistics TcpConnection::SendPoolStats() const
+{
+    SendPoolStatistics stats;
+    stats.hits               = m_poolHits.load(std::memory_order_relaxed);
+    stats.misses             = m_poolMisses.load(std::memory_order_relaxed);
+    stats.allocationFailures = m_poolAllocFailures.load(std::memory_order_relaxed);
+    return stats;
+}
+
+defs::connection_id_t TcpConnection::Id() const NO_EXCEPT_
+{
+    return m_id;
+}
+
+defs::connection_t TcpConnection::RemoteEndPoint() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_remoteEndPoint;
+}
+
 void TcpConnection::DecrementUnsentAsyncCounterOnStrand()
 {
     // Strand-only decrement paired with the reservation in SendMessageAsync.
@@ -666,7 +1239,7 @@ void TcpConnection::DecrementUnsentAsyncCounterOnStrand()
 
 void TcpConnection::InitialiseMsgPool()
 {
-    m_availablePoolIndices.clear();
+    m_poolFreeHead.store(END_OF_POOL_FREE_LIST, std::memory_order_relaxed);
 
     if (0 == m_settings.maxAllowedUnsentAsyncMessages)
     {
@@ -693,14 +1266,21 @@ void TcpConnection::InitialiseMsgPool()
     // to dynamic sends.
 
     m_msgPool.clear();
-    m_availablePoolIndices.clear();
 
     if (m_settings.sendPoolMsgSize == 0)
     {
         return;
     }
 
-    const size_t poolCount = m_settings.maxAllowedUnsentAsyncMessages;
+    if (m_settings.bufferMode == eBufferMode::onDemand)
+    {
+        // Blocks are taken from the shared buffer pool per message instead.
+        return;
+    }
+
+    // Pool indices must fit in the lower half of the free-list head.
+    const size_t poolCount = std::min(m_settings.maxAllowedUnsentAsyncMessages,
+                                      static_cast<size_t>(END_OF_POOL_FREE_LIST));
     const size_t poolSize  = m_settings.sendPoolMsgSize;
 
     m_msgPool.resize(poolCount);
@@ -710,12 +1290,17 @@ void TcpConnection::InitialiseMsgPool()
         b.resize(poolSize);
     }
 
-    m_availablePoolIndices.reserve(poolCount);
+    // Link every slot into the free-list, lowest index on top.
+    m_poolNextFree = std::make_unique<std::atomic<uint32_t>[]>(poolCount);
 
     for (size_t i = 0; i < poolCount; ++i)
     {
-        m_availablePoolIndices.push_back(i);
+        m_poolNextFree[i].store(
+            (i + 1 < poolCount) ? static_cast<uint32_t>(i + 1) : END_OF_POOL_FREE_LIST,
+            std::memory_order_relaxed);
     }
+
+    m_poolFreeHead.store(0, std::memory_order_release);
 }
 
 void TcpConnection::ConnectHandler(const boost::system::error_code&                  errorIn,
@@ -752,7 +1337,7 @@ size_t TcpConnection::CurrentConnectionId() const NO_EXCEPT_
     return m_currentConnectionId;
 }
 
-bool TcpConnection::AcquirePendingWrite(defs::char_buf_cspan_t message, PendingWrite& w)
+bool TcpConnection::ReserveUnsentAsyncMessage()
 {
     const size_t maxAllowed = m_settings.maxAllowedUnsentAsyncMessages;
 
@@ -780,13 +1365,46 @@ bool TcpConnection::AcquirePendingWrite(defs::char_buf_cspan_t message, PendingW
         return false;
     }
 
+    return true;
+}
+
+bool TcpConnection::AcquirePendingWrite(defs::char_buf_cspan_t message, PendingWrite& w)
+{
+    if (!ReserveUnsentAsyncMessage())
+    {
+        return false;
+    }
+
     w.kind = PendingWrite::eKind::dynamic;
 
     // Prefer pool when enabled AND message fits.
     const bool   poolEnabled = !m_msgPool.empty();
     const size_t poolCap     = m_settings.sendPoolMsgSize;
 
-    if (poolEnabled && (poolCap > 0) && (message.size() <= poolCap))
+    if ((m_settings.bufferMode == eBufferMode::onDemand) && (poolCap > 0) &&
+        (message.size() <= poolCap))
+    {
+        try
+        {
+            w.block = BufferPool::Default().Acquire(message.size());
+
+            if (!message.empty())
+            {
+                std::memcpy(w.block.Data(), message.data(), message.size());
+            }
+
+            w.kind = PendingWrite::eKind::block;
+            w.len  = message.size();
+            m_poolHits.fetch_add(1, std::memory_order_relaxed);
+        }
+        catch (...)
+        {
+            // The shared pool has no free list limit so this is an allocation failure, not a
+            // miss. Fall back to a dynamic allocation below.
+            m_poolAllocFailures.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    else if (poolEnabled && (poolCap > 0) && (message.size() <= poolCap))
     {
         size_t idx = 0;
 
@@ -810,6 +1428,11 @@ bool TcpConnection::AcquirePendingWrite(defs::char_buf_cspan_t message, PendingW
             w.kind      = PendingWrite::eKind::pool;
             w.poolIndex = idx;
             w.len       = message.size();
+            m_poolHits.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            m_poolMisses.fetch_add(1, std::memory_order_relaxed);
         }
     }
 
@@ -837,6 +1460,33 @@ bool TcpConnection::AcquirePendingWrite(defs::char_buf_cspan_t message, PendingW
     return true;
 }
 
+bool TcpConnection::PostPreparedSend(PendingWrite&& w)
+{
+    try
+    {
+        asio_compat::post(m_strand, EnqueuePreparedSendHandler(shared_from_this(), std::move(w)));
+
+        return true;
+    }
+    catch (...)
+    {
+        // Extremely rare (post throwing), but keep reservation accurate.
+        if (w.kind == PendingWrite::eKind::pool)
+        {
+            ReleasePoolIndex(w.poolIndex);
+        }
+
+        m_numUnsentAsyncMessages.fetch_sub(1, std::memory_order_acq_rel);
+
+#if defined(USE_SOCKET_DEBUG)
+        DEBUG_MESSAGE_EX_ERROR("Error in SendMessageAsync(post), error: "
+                               << boost::current_exception_diagnostic_information()
+                               << ", for: " << m_endPoint.first << ":" << m_endPoint.second);
+#endif
+        return false;
+    }
+}
+
 } // namespace tcp
 } // namespace asio
 } // namespace core_lib
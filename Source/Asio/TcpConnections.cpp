@@ -27,6 +27,7 @@
 
 #include "Asio/TcpConnections.h"
 #include <sstream>
+#include <functional>
 #include <boost/exception/all.hpp>
 #include "Asio/TcpConnection.h"
 
@@ -49,11 +50,49 @@ void TcpConnections::SetOnCloseCallback(defs::on_close_t const& onClose)
 
 void TcpConnections::Add(defs::connection_t const& endpoint, const defs::tcp_conn_ptr_t& connection)
 {
-    if (connection)
+    if (!connection)
     {
-        std::lock_guard<std::mutex> lock{m_mutex};
-        m_connections[endpoint] = connection;
+        return;
+    }
+
+    auto const                  key = PackedKey(endpoint);
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    // If this connection was previously registered under a different endpoint drop that entry.
+    auto indexIt = m_index.find(connection.get());
+
+    if ((indexIt != m_index.end()) && (indexIt->second.endpoint != endpoint))
+    {
+        auto&                               oldShard = ShardFor(indexIt->second.key);
+        std::unique_lock<std::shared_mutex> shardLock{oldShard.mutex};
+        auto oldIt = FindIn(oldShard, indexIt->second.key, indexIt->second.endpoint);
+
+        if ((oldIt != oldShard.connections.end()) && (oldIt->second.connection == connection))
+        {
+            oldShard.connections.erase(oldIt);
+        }
+    }
+
+    auto&                               shard = ShardFor(key);
+    std::unique_lock<std::shared_mutex> shardLock{shard.mutex};
+    auto                                it = FindIn(shard, key, endpoint);
+
+    if (it == shard.connections.end())
+    {
+        shard.connections.emplace(key, Entry{endpoint, connection});
+    }
+    else
+    {
+        // Replacing a different connection for the same endpoint, so it is no longer indexed.
+        if (it->second.connection != connection)
+        {
+            m_index.erase(it->second.connection.get());
+        }
+
+        it->second.connection = connection;
     }
+
+    m_index[connection.get()] = IndexEntry{key, endpoint};
 }
 
 void TcpConnections::Remove(const defs::tcp_conn_ptr_t& connection)
@@ -64,58 +103,59 @@ void TcpConnections::Remove(const defs::tcp_conn_ptr_t& connection)
     }
 
     defs::on_close_t   onClose;
-    defs::connection_t key = defs::NULL_CONNECTION;
+    defs::connection_t endpoint = defs::NULL_CONNECTION;
 
     {
         std::lock_guard<std::mutex> lock{m_mutex};
 
         // Compare raw pointer identity to avoid any shared_ptr aliasing surprises
-        TcpConnection* const c = connection.get();
+        auto indexIt = m_index.find(connection.get());
 
-        // Builder 10.1-safe: no std::find_if, no generic lambda
-        for (auto it = m_connections.begin(); it != m_connections.end(); ++it)
+        if (indexIt == m_index.end())
         {
-            if (it->second.get() == c)
+            return;
+        }
+
+        auto const key = indexIt->second.key;
+        endpoint       = indexIt->second.endpoint; // copy endpoint *before* erase
+        m_index.erase(indexIt);
+
+        {
+            auto&                               shard = ShardFor(key);
+            std::unique_lock<std::shared_mutex> shardLock{shard.mutex};
+            auto                                it = FindIn(shard, key, endpoint);
+
+            if (it != shard.connections.end())
             {
-                key = it->first;         // copy key *before* erase
-                m_connections.erase(it); // erase invalidates only 'it'
-                onClose = m_onClose;     // copy callback under lock
-                break;
+                shard.connections.erase(it);
             }
         }
+
+        onClose = m_onClose; // copy callback under lock
     }
 
     // Invoke callback without holding the mutex
-    if (onClose && (key != defs::NULL_CONNECTION))
+    if (onClose && (endpoint != defs::NULL_CONNECTION))
     {
-        onClose(key);
+        onClose(endpoint);
     }
 }
 
 size_t TcpConnections::Size() const
 {
     std::lock_guard<std::mutex> lock{m_mutex};
-    return m_connections.size();
+    return m_index.size();
 }
 
 bool TcpConnections::Empty() const
 {
     std::lock_guard<std::mutex> lock{m_mutex};
-    return m_connections.empty();
+    return m_index.empty();
 }
 
 void TcpConnections::CloseConnections()
 {
-    std::vector<defs::tcp_conn_ptr_t> snapshot;
-
-    {
-        std::lock_guard<std::mutex> lock{m_mutex};
-        snapshot.reserve(m_connections.size());
-        for (auto const& kv : m_connections)
-        {
-            snapshot.push_back(kv.second);
-        }
-    }
+    auto snapshot = Connections();
 
     // Close outside the mutex. Each connection should call Remove() once.
     for (auto const& c : snapshot)
@@ -127,60 +167,51 @@ void TcpConnections::CloseConnections()
 bool TcpConnections::SendMessageAsync(const defs::connection_t&  target,
                                       defs::char_buf_cspan_t message) const
 {
-    defs::tcp_conn_ptr_t conn;
-
-    // Reduce mutex scope: find and copy the shared_ptr, then unlock.
-    {
-        std::lock_guard<std::mutex> lock{m_mutex};
-        auto                        it = m_connections.find(target);
-
-        if (it == m_connections.end())
-        {
-            return false;
-        }
-
-        conn = it->second;
-    }
-
-    return conn->SendMessageAsync(message);
+    auto conn = Find(target);
+    return conn ? conn->SendMessageAsync(message) : false;
 }
 
 bool TcpConnections::SendMessageSync(const defs::connection_t&  target,
                                      defs::char_buf_cspan_t message) const
 {
-    defs::tcp_conn_ptr_t conn;
+    auto conn = Find(target);
+    return conn ? conn->SendMessageSync(message) : false;
+}
 
-    // Reduce mutex scope: find and copy the shared_ptr, then unlock.
-    {
-        std::lock_guard<std::mutex> lock{m_mutex};
-        auto                        it = m_connections.find(target);
+void TcpConnections::SendMessageToAll(defs::char_buf_cspan_t message) const
+{
+    auto snapshot = Connections();
 
-        if (it == m_connections.end())
-        {
-            return false;
-        }
+    if (snapshot.empty())
+    {
+        return;
+    }
 
-        conn = it->second;
+    // A single connection can use its own send pool, otherwise copy the message once and
+    // share it across all connections rather than copying per connection.
+    if (snapshot.size() == 1)
+    {
+        snapshot.front()->SendMessageAsync(message);
+        return;
     }
 
-    return conn->SendMessageSync(message);
+    auto shared = std::make_shared<const defs::char_buffer_t>(message.begin(), message.end());
+
+    for (auto const& c : snapshot)
+    {
+        c->SendMessageAsync(shared);
+    }
 }
 
-void TcpConnections::SendMessageToAll(defs::char_buf_cspan_t message) const
+void TcpConnections::SendMessageToAll(defs::shared_char_buffer_t const& message) const
 {
-    std::vector<defs::tcp_conn_ptr_t> snapshot;
-
-    // Reduce mutex scope.
+    if (!message)
     {
-        std::lock_guard<std::mutex> lock{m_mutex};
-        snapshot.reserve(m_connections.size());
-
-        for (auto const& kv : m_connections)
-        {
-            snapshot.push_back(kv.second);
-        }
+        return;
     }
 
+    auto snapshot = Connections();
+
     for (auto const& c : snapshot)
     {
         c->SendMessageAsync(message);
@@ -190,19 +221,11 @@ void TcpConnections::SendMessageToAll(defs::char_buf_cspan_t message) const
 auto TcpConnections::GetLocalEndForRemoteEnd(const defs::connection_t& remoteEnd) const
     -> defs::connection_t
 {
-    defs::tcp_conn_ptr_t conn;
+    auto conn = Find(remoteEnd);
 
-    // Reduce mutex scope: grab the connection pointer then release lock.
+    if (!conn)
     {
-        std::lock_guard<std::mutex> lock{m_mutex};
-        auto                        it = m_connections.find(remoteEnd);
-
-        if (it == m_connections.end())
-        {
-            BOOST_THROW_EXCEPTION(std::runtime_error("unknown connection"));
-        }
-
-        conn = it->second;
+        BOOST_THROW_EXCEPTION(std::runtime_error("unknown connection"));
     }
 
     boost_sys::error_code ec;
@@ -220,27 +243,95 @@ auto TcpConnections::GetLocalEndForRemoteEnd(const defs::connection_t& remoteEnd
 
 size_t TcpConnections::NumberOfUnsentAsyncMessages(const defs::connection_t& target) const
 {
-    defs::tcp_conn_ptr_t conn;
+    auto conn = Find(target);
+    return conn ? conn->NumberOfUnsentAsyncMessages() : 0;
+}
+
+SendPoolStatistics TcpConnections::SendPoolStats(const defs::connection_t& target) const
+{
+    auto conn = Find(target);
+    return conn ? conn->SendPoolStats() : SendPoolStatistics{};
+}
+
+defs::connection_id_t TcpConnections::ConnectionId(const defs::connection_t& target) const
+{
+    auto conn = Find(target);
+    return conn ? conn->Id() : defs::NULL_CONNECTION_ID;
+}
+
+uint64_t TcpConnections::PackedKey(defs::connection_t const& endpoint)
+{
+    boost_sys::error_code ec;
+    auto const            address = asio_compat::make_address(endpoint.first, ec);
 
-    // Reduce mutex scope
+    if (!ec && address.is_v4())
     {
-        std::lock_guard<std::mutex> lock{m_mutex};
-        auto                        it = m_connections.find(target);
-        if (it == m_connections.end())
+        return (static_cast<uint64_t>(address.to_v4().to_uint()) << 16) | endpoint.second;
+    }
+
+    return (static_cast<uint64_t>(std::hash<std::string>{}(endpoint.first)) << 16) ^
+           endpoint.second;
+}
+
+TcpConnections::Shard& TcpConnections::ShardFor(uint64_t key) const
+{
+    // Mix the key so consecutive ports and addresses spread across shards.
+    key ^= key >> 29;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 32;
+    return m_shards[key & (NUM_SHARDS - 1)];
+}
+
+auto TcpConnections::FindIn(Shard& shard, uint64_t key, defs::connection_t const& endpoint)
+    -> tcp_conn_map::iterator
+{
+    // IPv4 keys are exact so this is a single compare, other keys are hashes that may collide.
+    auto range = shard.connections.equal_range(key);
+
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second.endpoint == endpoint)
         {
-            return 0;
+            return it;
         }
-        conn = it->second;
     }
 
-    return conn->NumberOfUnsentAsyncMessages();
+    return shard.connections.end();
+}
+
+defs::tcp_conn_ptr_t TcpConnections::Find(defs::connection_t const& endpoint) const
+{
+    auto const                          key   = PackedKey(endpoint);
+    auto&                               shard = ShardFor(key);
+    std::shared_lock<std::shared_mutex> lock{shard.mutex};
+    auto                                it = FindIn(shard, key, endpoint);
+    return (it == shard.connections.end()) ? defs::tcp_conn_ptr_t{} : it->second.connection;
+}
+
+std::vector<defs::tcp_conn_ptr_t> TcpConnections::Connections() const
+{
+    std::vector<defs::tcp_conn_ptr_t> snapshot;
+
+    // The index tracks every connection so reserve once, the count is only a hint as connections
+    // may be added or removed before the shards are visited.
+    snapshot.reserve(Size());
+
+    for (auto const& shard : m_shards)
+    {
+        std::shared_lock<std::shared_mutex> lock{shard.mutex};
+
+        for (auto const& kv : shard.connections)
+        {
+            snapshot.push_back(kv.second.connection);
+        }
+    }
+
+    return snapshot;
 }
 
 bool TcpConnections::IsConnected(const defs::connection_t& client) const
 {
-    std::lock_guard<std::mutex> lock{m_mutex};
-    auto                        connIt = m_connections.find(client);
-    return (connIt != m_connections.end());
+    return static_cast<bool>(Find(client));
 }
 
 } // namespace tcp
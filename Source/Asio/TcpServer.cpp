@@ -29,6 +29,7 @@
 #include "DebugLogging.h"
 #endif
 #include <boost/bind.hpp>
+#include <algorithm>
 
 namespace core_lib
 {
@@ -46,7 +47,10 @@ TcpServer::TcpServer(asio_compat::io_service_t& ioService,
                  defs::message_received_handler_t const& messageReceivedHandler,
                  TcpConnSettings const& settings,
                  defs::message_received_handler_ex_t const& messageReceivedHandlerEx,
-                 defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx)
+                 defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx,
+                 defs::prepare_body_receive_t const&        prepareBodyReceive,
+                 defs::message_received_handler_id_t const& messageReceivedHandlerId,
+                 defs::check_bytes_left_to_read_id_t const& checkBytesLeftToReadId)
     : m_ioService(ioService)
     , m_strand(asio_compat::make_strand(ioService))
     , m_listenPort{listenPort}
@@ -54,12 +58,49 @@ TcpServer::TcpServer(asio_compat::io_service_t& ioService,
     , m_checkBytesLeftToReadEx{checkBytesLeftToReadEx}
     , m_messageReceivedHandler{messageReceivedHandler}
     , m_messageReceivedHandlerEx{messageReceivedHandlerEx}
+    , m_checkBytesLeftToReadId{checkBytesLeftToReadId}
+    , m_messageReceivedHandlerId{messageReceivedHandlerId}
+    , m_prepareBodyReceive{prepareBodyReceive}
     , m_settings{settings}
     , m_clientConnections(std::make_shared<TcpConnections>())
 {
     OpenAcceptor();
 }
 
+TcpServer::TcpServer(IoContextThreadGroup&                      ioThreadGroup,
+                     uint16_t                                   listenPort,
+                     defs::check_bytes_left_to_read_t const&    checkBytesLeftToRead,
+                     defs::message_received_handler_t const&    messageReceivedHandler,
+                     TcpConnSettings const&                     settings,
+                     eConnectionDistribution                    distribution,
+                     defs::message_received_handler_ex_t const& messageReceivedHandlerEx,
+                     defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx,
+                     defs::prepare_body_receive_t const&        prepareBodyReceive,
+                     defs::message_received_handler_id_t const& messageReceivedHandlerId,
+                     defs::check_bytes_left_to_read_id_t const& checkBytesLeftToReadId)
+    : m_ioService(ioThreadGroup.IoService())
+    , m_strand(asio_compat::make_strand(ioThreadGroup.IoService()))
+    , m_listenPort{listenPort}
+    , m_checkBytesLeftToRead{checkBytesLeftToRead}
+    , m_checkBytesLeftToReadEx{checkBytesLeftToReadEx}
+    , m_messageReceivedHandler{messageReceivedHandler}
+    , m_messageReceivedHandlerEx{messageReceivedHandlerEx}
+    , m_checkBytesLeftToReadId{checkBytesLeftToReadId}
+    , m_messageReceivedHandlerId{messageReceivedHandlerId}
+    , m_prepareBodyReceive{prepareBodyReceive}
+    , m_settings{settings}
+    , m_clientConnections(std::make_shared<TcpConnections>())
+    , m_connectionThreadGroup(&ioThreadGroup)
+    , m_distribution(distribution)
+{
+    if (m_distribution == eConnectionDistribution::leastLoaded)
+    {
+        m_contextConnections.resize(ioThreadGroup.NumIoServices());
+    }
+
+    OpenAcceptor();
+}
+
 // When using an internal IO service we'll only use 2 threads, which for regular usage
 // of the socket will be good enough for sending and receiving. For better threading
 // control use an external IO service thread group.
@@ -68,7 +109,10 @@ TcpServer::TcpServer(uint16_t listenPort,
                  defs::message_received_handler_t const& messageReceivedHandler,
                  TcpConnSettings const& settings,
                  defs::message_received_handler_ex_t const& messageReceivedHandlerEx,
-                 defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx)
+                 defs::check_bytes_left_to_read_ex_t const& checkBytesLeftToReadEx,
+                 defs::prepare_body_receive_t const&        prepareBodyReceive,
+                 defs::message_received_handler_id_t const& messageReceivedHandlerId,
+                 defs::check_bytes_left_to_read_id_t const& checkBytesLeftToReadId)
     : m_ioThreadGroup{new IoContextThreadGroup(2)}
     , m_ioService(m_ioThreadGroup->IoService())
     , m_strand{asio_compat::make_strand(m_ioThreadGroup->IoService())}
@@ -77,6 +121,9 @@ TcpServer::TcpServer(uint16_t listenPort,
     , m_checkBytesLeftToReadEx{checkBytesLeftToReadEx}
     , m_messageReceivedHandler{messageReceivedHandler}
     , m_messageReceivedHandlerEx{messageReceivedHandlerEx}
+    , m_checkBytesLeftToReadId{checkBytesLeftToReadId}
+    , m_messageReceivedHandlerId{messageReceivedHandlerId}
+    , m_prepareBodyReceive{prepareBodyReceive}
     , m_settings{settings}
     , m_clientConnections(std::make_shared<TcpConnections>())
 {
@@ -154,25 +201,55 @@ void TcpServer::SendMessageToAllClients(defs::char_buf_cspan_t message) const
     m_clientConnections->SendMessageToAll(message);
 }
 
+void TcpServer::SendMessageToAllClients(defs::shared_char_buffer_t const& message) const
+{
+    m_clientConnections->SendMessageToAll(message);
+}
+
 size_t TcpServer::NumberOfUnsentAsyncMessages(const defs::connection_t& client) const
 {
     return m_clientConnections->NumberOfUnsentAsyncMessages(client);
 }
 
+SendPoolStatistics TcpServer::SendPoolStats(const defs::connection_t& client) const
+{
+    return m_clientConnections->SendPoolStats(client);
+}
+
 bool TcpServer::IsConnected(const defs::connection_t& client) const
 {
     return m_clientConnections->IsConnected(client);
 }
 
+defs::connection_id_t TcpServer::GetClientConnectionId(const defs::connection_t& client) const
+{
+    return m_clientConnections->ConnectionId(client);
+}
+
 void TcpServer::AcceptConnection()
 {
-    auto connection = std::make_shared<TcpConnection>(m_ioService,
+    const auto index     = NextConnectionContext();
+    auto&      ioService = nullptr == m_connectionThreadGroup
+                               ? m_ioService
+                               : m_connectionThreadGroup->IoService(index);
+    auto connection = std::make_shared<TcpConnection>(ioService,
                                                       m_clientConnections,
                                                       m_checkBytesLeftToRead,
                                                       m_messageReceivedHandler,
                                                       m_settings,
                                                       m_messageReceivedHandlerEx,
-                                                      m_checkBytesLeftToReadEx);
+                                                      m_checkBytesLeftToReadEx,
+                                                      m_prepareBodyReceive,
+                                                      m_messageReceivedHandlerId,
+                                                      m_checkBytesLeftToReadId);
+
+    if (!m_contextConnections.empty())
+    {
+        m_contextConnections[index].emplace_back(connection);
+    }
+
+    // The connection's socket may belong to a different I/O context to the acceptor, in which
+    // case it is registered with its own context's reactor once accepted.
     m_acceptor->async_accept(
         connection->Socket(),
         asio_compat::wrap(
@@ -211,6 +288,39 @@ void TcpServer::AcceptHandler(const defs::tcp_conn_ptr_t&  connection,
     }
 }
 
+size_t TcpServer::NextConnectionContext()
+{
+    if (nullptr == m_connectionThreadGroup)
+    {
+        return 0;
+    }
+
+    if (m_contextConnections.empty())
+    {
+        return m_nextConnectionContext++ % m_connectionThreadGroup->NumIoServices();
+    }
+
+    size_t leastLoaded = 0;
+
+    for (size_t i = 0; i < m_contextConnections.size(); ++i)
+    {
+        auto& connections = m_contextConnections[i];
+        connections.erase(std::remove_if(connections.begin(),
+                                         connections.end(),
+                                         [](std::weak_ptr<TcpConnection> const& connection) {
+                                             return connection.expired();
+                                         }),
+                          connections.end());
+
+        if (connections.size() < m_contextConnections[leastLoaded].size())
+        {
+            leastLoaded = i;
+        }
+    }
+
+    return leastLoaded;
+}
+
 void TcpServer::ProcessCloseAcceptor()
 {
     if (m_acceptor && m_acceptor->is_open())
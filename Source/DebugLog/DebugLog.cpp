@@ -24,9 +24,6 @@
  * \brief File containing definition of DebugLog class.
  */
 #include "DebugLog/DebugLog.h"
-#if defined(_MSC_VER) && (_MSC_VER < 1920)
-#include "Asio/MemoryUtils.hpp"
-#endif
 #include <iomanip>
 
 namespace core_lib
@@ -49,71 +46,85 @@ const char ANSI_CYAN[]{"\x1b[96m"};
 const char ANSI_WHITE[]{"\x1b[97m"};
 
 // ****************************************************************************
-// 'struct DefaultLogFormat' definition
+// 'class DefaultLogFormat' definition
 // ****************************************************************************
 CONSTEXPR_ char DEFAULT_FMTR_DIVIDER[]{" | "};
-CONSTEXPR_ char DEFAULT_FMTR_DT[]{"%Y %b %d %H:%M:%S"};
-CONSTEXPR_ char DEFAULT_FMTR_DT_TZ[]{"%Y %b %d %H:%M:%S%z"};
+CONSTEXPR_ char DEFAULT_FMTR_DT_MINUTE[]{"%Y %b %d %H:%M:"};
+CONSTEXPR_ char DEFAULT_FMTR_TZ[]{"%z"};
 CONSTEXPR_ char DEFAULT_FMTR_FILE[]{" | File = "};
 CONSTEXPR_ char DEFAULT_FMTR_FUNC[]{" | Function = "};
 CONSTEXPR_ char DEFAULT_FMTR_LINE[]{" | Line = "};
 CONSTEXPR_ char DEFAULT_FMTR_THREAD[]{" | Thread ID = "};
 
-void DefaultLogFormat::operator()(std::ostream& os, std::time_t timeStamp,
-                                  const std::string& message, const std::string& logMsgLevel,
-                                  const std::string& file, const std::string& function, int lineNo,
-                                  const std::thread::id& threadID, bool utcTimeStamps,
-                                  bool tzOffset) const
+namespace
 {
-    if (!os.good())
+
+/*!
+ * \brief Thread safe conversion of a time_t to calendar time.
+ * \param[in] timeStamp - Time to convert.
+ * \param[in] utcTimeStamps - Convert to UTC instead of local time.
+ * \return Calendar time.
+ */
+std::tm ToCalendarTime(std::time_t timeStamp, bool utcTimeStamps)
+{
+    std::tm result{};
+
+#if defined(_WIN32)
+    if (utcTimeStamps)
     {
-        return;
+        gmtime_s(&result, &timeStamp);
     }
-
-    if (timeStamp != 0)
+    else
     {
-#if defined(_MSC_VER) && (_MSC_VER < 1920)
-        struct tm result;
-        ZeroPodObject(result);
+        localtime_s(&result, &timeStamp);
+    }
+#else
+    if (utcTimeStamps)
+    {
+        gmtime_r(&timeStamp, &result);
+    }
+    else
+    {
+        localtime_r(&timeStamp, &result);
+    }
+#endif
 
-        if (utcTimeStamps)
-        {
-            gmtime_s(&result, &timeStamp);
+    return result;
+}
 
-            // When UTC time we do not ever add the offsets to the string
-            // that is only for local time.
-            tzOffset = false;
-        }
-        else
-        {
-            localtime_s(&result, &timeStamp);
-        }
+/*!
+ * \brief Write a zero padded decimal number into a buffer.
+ * \param[out] buffer - Buffer to write digits to.
+ * \param[in] value - Value to write.
+ * \param[in] digits - Number of digits to write.
+ * \return Pointer to the character after the last digit.
+ */
+char* WriteDigits(char* buffer, long long value, int digits)
+{
+    for (int i = digits - 1; i >= 0; --i)
+    {
+        buffer[i] = static_cast<char>('0' + (value % 10));
+        value /= 10;
+    }
 
-        os << std::put_time(&result, tzOffset ? DEFAULT_FMTR_DT_TZ : DEFAULT_FMTR_DT)
-           << DEFAULT_FMTR_DIVIDER;
-#else
-        if (utcTimeStamps)
-        {
-            // When UTC time we do not ever add the offsets to the string
-            // that is only for local time.
-            os << std::put_time(std::gmtime(&timeStamp), DEFAULT_FMTR_DT) << DEFAULT_FMTR_DIVIDER;
-        }
-        else
-        {
-            os << std::put_time(std::localtime(&timeStamp),
-                                tzOffset ? DEFAULT_FMTR_DT_TZ : DEFAULT_FMTR_DT)
-               << DEFAULT_FMTR_DIVIDER;
-        }
-#endif
+    return buffer + digits;
+}
+
+} // namespace
 
-        // Legacy alternative...
-        //
-        // std::string time = ctime(&timeStamp);
-        // std::replace_if(time.begin(), time.end(),
-        //                 [](char c) { return (c == '\n') || (c == '\r'); }, 0);
-        // os << time.c_str() << " | " ;
+void DefaultLogFormat::operator()(std::ostream& os, const log_time_point_t& timeStamp,
+                                  const std::string& message, const std::string& logMsgLevel,
+                                  std::string_view file, std::string_view function, int lineNo,
+                                  const std::thread::id& threadID, bool utcTimeStamps,
+                                  bool tzOffset, eTimeStampPrecision precision) const
+{
+    if (!os.good())
+    {
+        return;
     }
 
+    WriteTimeStamp(os, timeStamp, utcTimeStamps, tzOffset, precision);
+
     if (logMsgLevel.compare("") != 0)
     {
         os << logMsgLevel << DEFAULT_FMTR_DIVIDER;
@@ -121,12 +132,12 @@ void DefaultLogFormat::operator()(std::ostream& os, std::time_t timeStamp,
 
     os << "\"" << message << "\"";
 
-    if (file.compare("") != 0)
+    if (!file.empty())
     {
         os << DEFAULT_FMTR_FILE << file;
     }
 
-    if (function.compare("") != 0)
+    if (!function.empty())
     {
         os << DEFAULT_FMTR_FUNC << function;
     }
@@ -143,12 +154,14 @@ void DefaultLogFormat::operator()(std::ostream& os, std::time_t timeStamp,
         os << DEFAULT_FMTR_THREAD << threadID;
     }
 
-    os << std::endl;
+    // No std::endl, DebugLog decides when to flush according to its flush policy.
+    os << '\n';
 }
 
-void DefaultLogFormat::operator()(std::ostream& os, std::time_t timeStamp,
+void DefaultLogFormat::operator()(std::ostream& os, const log_time_point_t& timeStamp,
                                   const std::string& message, const std::string& logMsgLevel,
-                                  bool utcTimeStamps, bool tzOffset, const char* colourCode) const
+                                  bool utcTimeStamps, bool tzOffset, eTimeStampPrecision precision,
+                                  const char* colourCode) const
 {
     if (!os.good())
     {
@@ -160,49 +173,7 @@ void DefaultLogFormat::operator()(std::ostream& os, std::time_t timeStamp,
         os << colourCode;
     }
 
-    if (timeStamp != 0)
-    {
-#if defined(_MSC_VER) && (_MSC_VER < 1920)
-        struct tm result;
-        ZeroPodObject(result);
-
-        if (utcTimeStamps)
-        {
-            gmtime_s(&result, &timeStamp);
-
-            // When UTC time we do not ever add the offsets to the string
-            // that is only for local time.
-            tzOffset = false;
-        }
-        else
-        {
-            localtime_s(&result, &timeStamp);
-        }
-
-        os << std::put_time(&result, tzOffset ? DEFAULT_FMTR_DT_TZ : DEFAULT_FMTR_DT)
-           << DEFAULT_FMTR_DIVIDER;
-#else
-        if (utcTimeStamps)
-        {
-            // When UTC time we do not ever add the offsets to the string
-            // that is only for local time.
-            os << std::put_time(std::gmtime(&timeStamp), DEFAULT_FMTR_DT) << DEFAULT_FMTR_DIVIDER;
-        }
-        else
-        {
-            os << std::put_time(std::localtime(&timeStamp),
-                                tzOffset ? DEFAULT_FMTR_DT_TZ : DEFAULT_FMTR_DT)
-               << DEFAULT_FMTR_DIVIDER;
-        }
-#endif
-
-        // Legacy alternative...
-        //
-        // std::string time = ctime(&timeStamp);
-        // std::replace_if(time.begin(), time.end(),
-        //                 [](char c) { return (c == '\n') || (c == '\r'); }, 0);
-        // os << time.c_str() << " | " ;
-    }
+    WriteTimeStamp(os, timeStamp, utcTimeStamps, tzOffset, precision);
 
     if (logMsgLevel.compare("") != 0)
     {
@@ -219,20 +190,135 @@ void DefaultLogFormat::operator()(std::ostream& os, std::time_t timeStamp,
     os << std::endl;
 }
 
+void DefaultLogFormat::operator()(std::ostream& os, std::time_t timeStamp,
+                                  const std::string& message, const std::string& logMsgLevel,
+                                  std::string_view file, std::string_view function, int lineNo,
+                                  const std::thread::id& threadID, bool utcTimeStamps,
+                                  bool tzOffset) const
+{
+    (*this)(os,
+            std::chrono::system_clock::from_time_t(timeStamp),
+            message,
+            logMsgLevel,
+            file,
+            function,
+            lineNo,
+            threadID,
+            utcTimeStamps,
+            tzOffset,
+            eTimeStampPrecision::seconds);
+}
+
+void DefaultLogFormat::operator()(std::ostream& os, std::time_t timeStamp,
+                                  const std::string& message, const std::string& logMsgLevel,
+                                  bool utcTimeStamps, bool tzOffset, const char* colourCode) const
+{
+    (*this)(os,
+            std::chrono::system_clock::from_time_t(timeStamp),
+            message,
+            logMsgLevel,
+            utcTimeStamps,
+            tzOffset,
+            eTimeStampPrecision::seconds,
+            colourCode);
+}
+
+void DefaultLogFormat::WriteTimeStamp(std::ostream& os, const log_time_point_t& timeStamp,
+                                      bool utcTimeStamps, bool tzOffset,
+                                      eTimeStampPrecision precision) const
+{
+    if (timeStamp == log_time_point_t{})
+    {
+        return;
+    }
+
+    using namespace std::chrono;
+
+    // When UTC time we do not ever add the offsets to the string
+    // that is only for local time.
+    if (utcTimeStamps)
+    {
+        tzOffset = false;
+    }
+
+    auto const second = floor<seconds>(timeStamp);
+    auto const minute = floor<minutes>(second);
+
+    // Only format the date and time when the minute changes, this relies on
+    // timezone offsets being whole minutes.
+    if (m_cachedDateTime.empty() || (minute != m_cachedMinute) || (utcTimeStamps != m_cachedUtcTimeStamps) ||
+        (tzOffset != m_cachedTzOffset))
+    {
+        auto const calendarTime = ToCalendarTime(system_clock::to_time_t(second), utcTimeStamps);
+
+        std::ostringstream oss;
+        oss.imbue(os.getloc());
+        oss << std::put_time(&calendarTime, DEFAULT_FMTR_DT_MINUTE);
+        m_cachedDateTime = oss.str();
+
+        m_cachedTzOffsetText.clear();
+
+        if (tzOffset)
+        {
+            oss.str("");
+            oss << std::put_time(&calendarTime, DEFAULT_FMTR_TZ);
+            m_cachedTzOffsetText = oss.str();
+        }
+
+        m_cachedMinute        = minute;
+        m_cachedUtcTimeStamps = utcTimeStamps;
+        m_cachedTzOffset      = tzOffset;
+    }
+
+    // Seconds and fraction, e.g. "56.789012".
+    char  buffer[16];
+    char* end = WriteDigits(buffer, (second - minute).count(), 2);
+
+    if (eTimeStampPrecision::milliseconds == precision)
+    {
+        *end++ = '.';
+        end    = WriteDigits(end, duration_cast<milliseconds>(timeStamp - second).count(), 3);
+    }
+    else if (eTimeStampPrecision::microseconds == precision)
+    {
+        *end++ = '.';
+        end    = WriteDigits(end, duration_cast<microseconds>(timeStamp - second).count(), 6);
+    }
+
+    os << m_cachedDateTime;
+    os.write(buffer, end - buffer);
+    os << m_cachedTzOffsetText << DEFAULT_FMTR_DIVIDER;
+}
+
 namespace dl_private
 {
 // ****************************************************************************
 // 'class LogQueueMessage' definition
 // ****************************************************************************
 
-LogQueueMessage::LogQueueMessage(std::string const& message, time_t timeStamp,
+LogQueueMessage::LogQueueMessage(std::string const& message, const log_time_point_t& timeStamp,
                                  std::string const& file, std::string const& function, int lineNo,
                                  const std::thread::id& threadID, eLogMessageLevel errorLevel,
                                  eMsgTarget msgTarget)
     : m_message(message)
     , m_timeStamp(timeStamp)
-    , m_file(file)
-    , m_function(function)
+    , m_fileStorage(file)
+    , m_functionStorage(function)
+    , m_lineNo(lineNo)
+    , m_threadID(threadID)
+    , m_errorLevel(errorLevel)
+    , m_msgTarget(msgTarget)
+{
+}
+
+LogQueueMessage::LogQueueMessage(std::string&& message, const log_time_point_t& timeStamp,
+                                 const char* file, const char* function, int lineNo,
+                                 const std::thread::id& threadID, eLogMessageLevel errorLevel,
+                                 eMsgTarget msgTarget)
+    : m_message(std::move(message))
+    , m_timeStamp(timeStamp)
+    , m_file(file != nullptr ? file : "")
+    , m_function(function != nullptr ? function : "")
     , m_lineNo(lineNo)
     , m_threadID(threadID)
     , m_errorLevel(errorLevel)
@@ -252,6 +338,8 @@ LogQueueMessage& LogQueueMessage::operator=(LogQueueMessage&& msg)
     std::swap(m_timeStamp, msg.m_timeStamp);
     std::swap(m_file, msg.m_file);
     std::swap(m_function, msg.m_function);
+    std::swap(m_fileStorage, msg.m_fileStorage);
+    std::swap(m_functionStorage, msg.m_functionStorage);
     std::swap(m_lineNo, msg.m_lineNo);
     std::swap(m_threadID, msg.m_threadID);
     std::swap(m_errorLevel, msg.m_errorLevel);
@@ -265,19 +353,19 @@ const std::string& LogQueueMessage::Message() const
     return m_message;
 }
 
-time_t LogQueueMessage::TimeStamp() const
+const log_time_point_t& LogQueueMessage::TimeStamp() const
 {
     return m_timeStamp;
 }
 
-const std::string& LogQueueMessage::File() const
+const char* LogQueueMessage::File() const
 {
-    return m_file;
+    return m_file != nullptr ? m_file : m_fileStorage.c_str();
 }
 
-const std::string& LogQueueMessage::Function() const
+const char* LogQueueMessage::Function() const
 {
-    return m_function;
+    return m_function != nullptr ? m_function : m_functionStorage.c_str();
 }
 
 int LogQueueMessage::LineNo() const
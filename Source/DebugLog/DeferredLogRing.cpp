@@ -0,0 +1,220 @@
+// This file is part of CoreLibrary containing useful reusable utility
+// classes.
+//
+// Copyright (C) 2014 to present, Duncan Crutchley
+// Contact <15799155+dac1976@users.noreply.github.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License and GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License
+// and GNU Lesser General Public License along with this program. If
+// not, see <http://www.gnu.org/licenses/>.
+
+/*!
+ * \file DeferredLogRing.cpp
+ * \brief File containing definitions used by DebugLog's deferred logging mode.
+ */
+
+#include "DebugLog/DeferredLogRing.h"
+
+namespace core_lib
+{
+namespace log
+{
+namespace dl_private
+{
+
+namespace
+{
+
+/*! \brief Ring the calling thread is currently the producer for. */
+struct ThreadRing
+{
+    /*! \brief ID of the DeferredLogRings the ring belongs to. */
+    uint64_t ownerId{0};
+    /*! \brief The ring, kept alive even if its DebugLog is destroyed first. */
+    std::shared_ptr<DeferredLogRing> ring;
+
+    ~ThreadRing()
+    {
+        if (ring)
+        {
+            ring->Release();
+        }
+    }
+};
+
+thread_local ThreadRing t_threadRing;
+
+std::atomic<uint64_t> g_nextRingsId{1};
+
+} // namespace
+
+// ****************************************************************************
+// 'class DeferredLogRing' definition
+// ****************************************************************************
+DeferredLogRing::DeferredLogRing(size_t capacity)
+    : m_capacity([capacity]() {
+        size_t c = MIN_CAPACITY;
+
+        while (c < capacity)
+        {
+            c <<= 1;
+        }
+
+        return c;
+    }())
+    , m_storage(new uint64_t[m_capacity / sizeof(uint64_t)])
+    , m_buffer(reinterpret_cast<char*>(m_storage.get()))
+{
+}
+
+size_t DeferredLogRing::Capacity() const NO_EXCEPT_
+{
+    return m_capacity;
+}
+
+char* DeferredLogRing::Reserve(size_t size) NO_EXCEPT_
+{
+    if (size > m_capacity / 2)
+    {
+        return nullptr;
+    }
+
+    auto       tail       = m_tail.load(std::memory_order_relaxed);
+    auto const offset     = static_cast<size_t>(tail & (m_capacity - 1));
+    auto const contiguous = m_capacity - offset;
+    auto const needed     = size <= contiguous ? size : size + contiguous;
+
+    if (m_capacity - (tail - m_cachedHead) < needed)
+    {
+        m_cachedHead = m_head.load(std::memory_order_acquire);
+
+        if (m_capacity - (tail - m_cachedHead) < needed)
+        {
+            return nullptr;
+        }
+    }
+
+    if (size > contiguous)
+    {
+        new (m_buffer + offset) DeferredLogRecordPrefix{static_cast<uint32_t>(contiguous), 1};
+        tail += contiguous;
+    }
+
+    m_pendingTail = tail + size;
+    return m_buffer + (tail & (m_capacity - 1));
+}
+
+void DeferredLogRing::Commit() NO_EXCEPT_
+{
+    // Sequentially consistent so it is ordered before the producer checks
+    // whether a drain is pending, see DeferredLogRings::Drain.
+    m_tail.store(m_pendingTail, std::memory_order_seq_cst);
+}
+
+void DeferredLogRing::CountDropped() NO_EXCEPT_
+{
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool DeferredLogRing::TryAcquire() NO_EXCEPT_
+{
+    bool owned = false;
+    return m_owned.compare_exchange_strong(owned, true, std::memory_order_acquire);
+}
+
+void DeferredLogRing::Release() NO_EXCEPT_
+{
+    m_owned.store(false, std::memory_order_release);
+}
+
+// ****************************************************************************
+// 'class DeferredLogRings' definition
+// ****************************************************************************
+DeferredLogRings::DeferredLogRings()
+    : m_id(g_nextRingsId.fetch_add(1, std::memory_order_relaxed))
+{
+}
+
+void DeferredLogRings::SetRingCapacity(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_ringCapacity = capacity;
+}
+
+DeferredLogRing* DeferredLogRings::ThisThreadRing()
+{
+    if (t_threadRing.ownerId == m_id)
+    {
+        return t_threadRing.ring.get();
+    }
+
+    return AcquireRing();
+}
+
+DeferredLogRing* DeferredLogRings::AcquireRing()
+{
+    std::shared_ptr<DeferredLogRing> ring;
+
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+
+        // Reuse a ring whose thread has exited or moved on to another log.
+        for (auto& r : m_rings)
+        {
+            if (r->TryAcquire())
+            {
+                ring = r;
+                break;
+            }
+        }
+
+        if (!ring)
+        {
+            ring = std::make_shared<DeferredLogRing>(m_ringCapacity);
+            ring->TryAcquire();
+            m_rings.push_back(ring);
+        }
+    }
+
+    if (t_threadRing.ring)
+    {
+        t_threadRing.ring->Release();
+    }
+
+    t_threadRing.ownerId = m_id;
+    t_threadRing.ring    = std::move(ring);
+    return t_threadRing.ring.get();
+}
+
+// ****************************************************************************
+// Deferred format helper definitions
+// ****************************************************************************
+const char* WriteDeferredFormat(std::ostream& os, const char* format)
+{
+    auto const placeholder = std::strstr(format, "{}");
+
+    if (nullptr == placeholder)
+    {
+        auto const length = std::strlen(format);
+        os.write(format, static_cast<std::streamsize>(length));
+        return format + length;
+    }
+
+    os.write(format, placeholder - format);
+    return placeholder + 2;
+}
+
+} // namespace dl_private
+} // namespace log
+} // namespace core_lib
@@ -25,7 +25,6 @@
  */
 
 #include "Threads/DeadlineTimer.h"
-#include <stdexcept>
 
 /*! \brief The core_lib namespace. */
 namespace core_lib
@@ -35,58 +34,28 @@ namespace threads
 {
 
 DeadlineTimer::DeadlineTimer()
-    : m_timeoutMillisecs(0)
-    , m_timeoutEvent(eNotifyType::signalOneThread, eResetCondition::manualReset,
-                     eIntialCondition::notSignalled)
+    : m_service(TimerService::Default())
 {
 }
 
-DeadlineTimer::~DeadlineTimer()
+DeadlineTimer::DeadlineTimer(TimerService& service)
+    : m_service(service)
 {
-    Cancel();
 }
 
-void DeadlineTimer::Start(uint32_t timeoutMillisecs, callback_t const& onTimedOut)
+DeadlineTimer::~DeadlineTimer()
 {
     Cancel();
-
-    m_timeoutMillisecs = timeoutMillisecs;
-    m_onTimedOut       = onTimedOut;
-
-    if (m_timeoutMillisecs == 0)
-    {
-        throw std::invalid_argument("incorrect timeout period");
-    }
-
-    if (!m_onTimedOut)
-    {
-        throw std::invalid_argument("invalid timeout callback");
-    }
-
-    m_timeoutThread = std::thread(std::bind(&DeadlineTimer::TimeoutThread, this));
 }
 
-void DeadlineTimer::Cancel()
+void DeadlineTimer::Start(uint32_t timeoutMillisecs, callback_t const& onTimedOut)
 {
-    m_timeoutEvent.Signal();
-
-    if (m_timeoutThread.joinable())
-    {
-        m_timeoutThread.join();
-    }
-
-    m_timeoutEvent.Reset();
+    m_service.Schedule(m_entry, timeoutMillisecs, onTimedOut);
 }
 
-void DeadlineTimer::TimeoutThread()
+void DeadlineTimer::Cancel()
 {
-    if (!m_timeoutEvent.WaitForTime(m_timeoutMillisecs))
-    {
-        if (m_onTimedOut)
-        {
-            m_onTimedOut();
-        }
-    }
+    m_service.Cancel(m_entry);
 }
 
 } // namespace threads
@@ -24,6 +24,7 @@
  * \brief File containing definition of EventThread class.
  */
 #include "Threads/EventThread.h"
+#include <thread>
 
 /*! \brief The core_lib namespace. */
 namespace core_lib
@@ -32,6 +33,27 @@ namespace core_lib
 namespace threads
 {
 
+namespace
+{
+
+std::chrono::nanoseconds ToDuration(unsigned int period, eWaitTimeUnit timeUnit)
+{
+    switch (timeUnit)
+    {
+    case eWaitTimeUnit::seconds:
+        return std::chrono::seconds(period);
+    case eWaitTimeUnit::microseconds:
+        return std::chrono::microseconds(period);
+    case eWaitTimeUnit::nanoseconds:
+        return std::chrono::nanoseconds(period);
+    case eWaitTimeUnit::milliseconds:
+    default:
+        return std::chrono::milliseconds(period);
+    }
+}
+
+} // namespace
+
 // ****************************************************************************
 // 'class EventThread' definition
 // ****************************************************************************
@@ -40,6 +62,7 @@ EventThread::EventThread(event_callback_t const& eventCallback, unsigned int eve
     : m_eventCallback(eventCallback)
     , m_eventPeriod(eventPeriod)
     , m_timeUnit(timeUnit)
+    , m_periodNanosecs(ToDuration(eventPeriod, timeUnit).count())
 {
     if (!delayedStart)
     {
@@ -57,6 +80,8 @@ void EventThread::SetEventPeriod(unsigned int eventPeriod, eWaitTimeUnit timeUni
     std::lock_guard<std::mutex> lock(m_eventPeriodMutex);
     m_eventPeriod = eventPeriod;
     m_timeUnit    = timeUnit;
+    m_periodNanosecs.store(ToDuration(eventPeriod, timeUnit).count());
+    m_rebaseSchedule.store(true);
 }
 
 unsigned int EventThread::EventPeriod(eWaitTimeUnit* timeUnit) const
@@ -71,12 +96,77 @@ unsigned int EventThread::EventPeriod(eWaitTimeUnit* timeUnit) const
     return m_eventPeriod;
 }
 
+void EventThread::SetScheduling(eEventScheduling scheduling, eOverrunPolicy overrunPolicy,
+                                unsigned int spinMicrosecs)
+{
+    m_overrunPolicy.store(overrunPolicy);
+    m_spinNanosecs.store(std::chrono::nanoseconds(std::chrono::microseconds(spinMicrosecs)).count());
+    m_scheduling.store(scheduling);
+    m_rebaseSchedule.store(true);
+}
+
+EventThreadStats EventThread::Statistics() const
+{
+    EventThreadStats stats;
+    stats.ticks        = m_ticks.load(std::memory_order_relaxed);
+    stats.overruns     = m_overruns.load(std::memory_order_relaxed);
+    stats.skippedTicks = m_skippedTicks.load(std::memory_order_relaxed);
+    stats.lastJitter   = std::chrono::nanoseconds(m_lastJitterNanosecs.load(std::memory_order_relaxed));
+    stats.maxJitter    = std::chrono::nanoseconds(m_maxJitterNanosecs.load(std::memory_order_relaxed));
+
+    const auto samples = m_jitterSamples.load(std::memory_order_relaxed);
+
+    if (samples > 0)
+    {
+        stats.meanJitter = std::chrono::nanoseconds(
+            m_totalJitterNanosecs.load(std::memory_order_relaxed) / static_cast<int64_t>(samples));
+    }
+
+    return stats;
+}
+
+void EventThread::ResetStatistics()
+{
+    m_ticks.store(0, std::memory_order_relaxed);
+    m_overruns.store(0, std::memory_order_relaxed);
+    m_skippedTicks.store(0, std::memory_order_relaxed);
+    m_jitterSamples.store(0, std::memory_order_relaxed);
+    m_lastJitterNanosecs.store(0, std::memory_order_relaxed);
+    m_maxJitterNanosecs.store(0, std::memory_order_relaxed);
+    m_totalJitterNanosecs.store(0, std::memory_order_relaxed);
+}
+
 void EventThread::ForceTick()
 {
 	m_updateEvent.Signal();
 }
 
 void EventThread::ThreadFunction() NO_EXCEPT_
+{
+    const auto period = std::chrono::nanoseconds(m_periodNanosecs.load());
+
+    if ((period.count() > 0) && (m_scheduling.load() == eEventScheduling::fixedRate))
+    {
+        FixedRateTick(period);
+        return;
+    }
+
+    // Should we switch to fixed rate later start its schedule afresh.
+    m_rebaseSchedule.store(true);
+
+    RunCallback();
+
+    if (period.count() > 0)
+    {
+        m_updateEvent.WaitUntil(std::chrono::steady_clock::now() + period);
+    }
+    else
+    {
+        m_updateEvent.Wait();
+    }
+}
+
+void EventThread::RunCallback() NO_EXCEPT_
 {
     try
     {
@@ -90,17 +180,73 @@ void EventThread::ThreadFunction() NO_EXCEPT_
         // Do nothing.
     }
 
-    eWaitTimeUnit timeUnit;
-    auto          period = EventPeriod(&timeUnit);
+    m_ticks.fetch_add(1, std::memory_order_relaxed);
+}
 
-    if (period > 0)
+void EventThread::FixedRateTick(std::chrono::nanoseconds period) NO_EXCEPT_
+{
+    auto now = std::chrono::steady_clock::now();
+
+    if (m_rebaseSchedule.exchange(false))
     {
-        m_updateEvent.WaitForTime(period, timeUnit);
+        m_nextDeadline = now;
     }
-    else
+
+    const auto jitter = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_nextDeadline).count();
+    m_lastJitterNanosecs.store(jitter, std::memory_order_relaxed);
+    m_totalJitterNanosecs.fetch_add(jitter, std::memory_order_relaxed);
+    m_jitterSamples.fetch_add(1, std::memory_order_relaxed);
+
+    if (jitter > m_maxJitterNanosecs.load(std::memory_order_relaxed))
     {
-        m_updateEvent.Wait();
+        m_maxJitterNanosecs.store(jitter, std::memory_order_relaxed);
     }
+
+    RunCallback();
+
+    m_nextDeadline += period;
+    now = std::chrono::steady_clock::now();
+
+    if (now > m_nextDeadline)
+    {
+        m_overruns.fetch_add(1, std::memory_order_relaxed);
+
+        if (m_overrunPolicy.load() == eOverrunPolicy::skip)
+        {
+            // Move on to the first deadline still in the future.
+            const auto missed = (now - m_nextDeadline) / period + 1;
+            m_nextDeadline += missed * period;
+            m_skippedTicks.fetch_add(static_cast<uint64_t>(missed), std::memory_order_relaxed);
+        }
+        else
+        {
+            // Catch up by running the next tick straight away.
+            return;
+        }
+    }
+
+    if (WaitUntil(m_nextDeadline))
+    {
+        // Forced tick or stopping, restart the schedule from the next tick.
+        m_rebaseSchedule.store(true);
+    }
+}
+
+bool EventThread::WaitUntil(std::chrono::steady_clock::time_point deadline) NO_EXCEPT_
+{
+    const auto spin = std::chrono::nanoseconds(m_spinNanosecs.load());
+
+    if (m_updateEvent.WaitUntil(deadline - spin))
+    {
+        return true;
+    }
+
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+
+    return false;
 }
 
 void EventThread::ProcessTerminationConditions() NO_EXCEPT_
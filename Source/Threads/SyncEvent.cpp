@@ -26,6 +26,7 @@
 
 #include "Threads/SyncEvent.h"
 #include <chrono>
+#include <thread>
 
 namespace core_lib
 {
@@ -39,95 +40,203 @@ SyncEvent::SyncEvent(eNotifyType notifyCondition, eResetCondition resetCondition
                      eIntialCondition initialCondition, Condition* condition)
     : m_signalAllThreads(notifyCondition == eNotifyType::signalAllThreads)
     , m_autoReset(m_signalAllThreads ? false : resetCondition == eResetCondition::autoReset)
-    , m_getCondition(nullptr == condition ? std::bind(&SyncEvent::SignalFlag, this)
-                                          : condition->getCondition)
-    , m_setCondition(nullptr == condition
-                         ? std::bind(&SyncEvent::SetSignalFlag, this, std::placeholders::_1)
-                         : condition->setCondition)
+    , m_state(initialCondition == eIntialCondition::signalled ? SIGNALLED_BIT : 0)
 {
-    m_setCondition(initialCondition == eIntialCondition::signalled);
+    if (nullptr != condition)
+    {
+        m_getCondition = condition->getCondition;
+        m_setCondition = condition->setCondition;
+        m_setCondition(initialCondition == eIntialCondition::signalled);
+    }
 }
 
 void SyncEvent::Wait()
 {
-    std::unique_lock<std::mutex> lock(m_signalMutex);
-    m_signalCondVar.wait(lock, [this] { return m_getCondition(); });
+    if (m_getCondition)
+    {
+        std::unique_lock<std::mutex> lock(m_signalMutex);
+        m_signalCondVar.wait(lock, [this] { return m_getCondition(); });
+
+        if (m_autoReset && m_getCondition())
+        {
+            m_setCondition(false);
+        }
+
+        return;
+    }
 
-    if (m_autoReset && m_getCondition())
+    // A signal is often only moments away so spin briefly before blocking.
+    for (int spin = 0; spin < SPIN_COUNT; ++spin)
     {
-        m_setCondition(false);
+        if (TryConsumeSignal())
+        {
+            return;
+        }
+
+        if (spin >= BUSY_SPIN_COUNT)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    m_state.fetch_add(WAITER_INC, std::memory_order_acq_rel);
+
+    for (;;)
+    {
+        const auto state = m_state.load(std::memory_order_acquire);
+
+        if ((state & SIGNALLED_BIT) == 0)
+        {
+            m_state.wait(state, std::memory_order_acquire);
+        }
+        else if (TryConsumeSignal())
+        {
+            break;
+        }
     }
+
+    m_state.fetch_sub(WAITER_INC, std::memory_order_acq_rel);
 }
 
 bool SyncEvent::WaitForTime(unsigned int period, eWaitTimeUnit timeUnit)
 {
-    std::unique_lock<std::mutex> lock(m_signalMutex);
-    bool                         result;
+    std::chrono::nanoseconds timeout;
 
     switch (timeUnit)
     {
     case eWaitTimeUnit::seconds:
-        result = m_signalCondVar.wait_for(
-            lock, std::chrono::seconds(period), [this] { return m_getCondition(); });
+        timeout = std::chrono::seconds(period);
         break;
     case eWaitTimeUnit::microseconds:
-        result = m_signalCondVar.wait_for(
-            lock, std::chrono::microseconds(period), [this] { return m_getCondition(); });
+        timeout = std::chrono::microseconds(period);
         break;
     case eWaitTimeUnit::nanoseconds:
-        result = m_signalCondVar.wait_for(
-            lock, std::chrono::nanoseconds(period), [this] { return m_getCondition(); });
+        timeout = std::chrono::nanoseconds(period);
         break;
     case eWaitTimeUnit::milliseconds:
     default:
-        result = m_signalCondVar.wait_for(
-            lock, std::chrono::milliseconds(period), [this] { return m_getCondition(); });
+        timeout = std::chrono::milliseconds(period);
         break;
     }
 
-    if (m_autoReset && m_getCondition())
+    return WaitUntil(std::chrono::steady_clock::now() + timeout);
+}
+
+bool SyncEvent::WaitUntil(std::chrono::steady_clock::time_point deadline)
+{
+    if (m_getCondition)
     {
-        m_setCondition(false);
+        std::unique_lock<std::mutex> lock(m_signalMutex);
+        bool result =
+            m_signalCondVar.wait_until(lock, deadline, [this] { return m_getCondition(); });
+
+        if (m_autoReset && m_getCondition())
+        {
+            m_setCondition(false);
+        }
+
+        return result;
+    }
+
+    if (TryConsumeSignal())
+    {
+        return true;
     }
 
+    // Register as a waiter while holding the mutex so a Signal that sees
+    // us cannot notify before we are blocked on the condition variable.
+    std::unique_lock<std::mutex> lock(m_signalMutex);
+    m_state.fetch_add(WAITER_INC, std::memory_order_acq_rel);
+    bool result =
+        m_signalCondVar.wait_until(lock, deadline, [this] { return TryConsumeSignal(); });
+    m_state.fetch_sub(WAITER_INC, std::memory_order_acq_rel);
+
     return result;
 }
 
 void SyncEvent::Signal()
 {
+    if (m_getCondition)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_signalMutex);
+            m_setCondition(true);
+        }
+
+        if (m_signalAllThreads)
+        {
+            m_signalCondVar.notify_all();
+        }
+        else
+        {
+            m_signalCondVar.notify_one();
+        }
+
+        return;
+    }
+
+    const auto previous = m_state.fetch_or(SIGNALLED_BIT, std::memory_order_acq_rel);
+
+    if (previous < WAITER_INC)
+    {
+        return;
+    }
+
+    // Timed waiters check the flag under the mutex, taking it here stops the
+    // notify landing between their check and them blocking.
     {
         std::lock_guard<std::mutex> lock(m_signalMutex);
-        m_setCondition(true);
     }
 
     if (m_signalAllThreads)
     {
         m_signalCondVar.notify_all();
+        m_state.notify_all();
     }
     else
     {
         m_signalCondVar.notify_one();
+        m_state.notify_one();
     }
 }
 
 void SyncEvent::Reset()
 {
-    std::lock_guard<std::mutex> lock(m_signalMutex);
+    if (m_autoReset)
+    {
+        return;
+    }
 
-    if (!m_autoReset)
+    if (m_getCondition)
     {
+        std::lock_guard<std::mutex> lock(m_signalMutex);
         m_setCondition(false);
     }
+    else
+    {
+        m_state.fetch_and(~SIGNALLED_BIT, std::memory_order_acq_rel);
+    }
 }
 
-bool SyncEvent::SignalFlag() const
+bool SyncEvent::TryConsumeSignal()
 {
-    return m_signalFlag;
-}
+    auto state = m_state.load(std::memory_order_acquire);
 
-void SyncEvent::SetSignalFlag(bool signalFlag)
-{
-    m_signalFlag = signalFlag;
+    if (!m_autoReset)
+    {
+        return (state & SIGNALLED_BIT) != 0;
+    }
+
+    while ((state & SIGNALLED_BIT) != 0)
+    {
+        if (m_state.compare_exchange_weak(
+                state, state & ~SIGNALLED_BIT, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 } // namespace threads
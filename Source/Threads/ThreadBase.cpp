@@ -38,15 +38,15 @@ namespace threads
 // ****************************************************************************
 bool ThreadBase::IsStarted() const
 {
-    std::lock_guard<std::mutex> lock{m_mutex};
-    return m_started;
+    return m_started.load(std::memory_order_acquire);
 }
 
 bool ThreadBase::Start()
 {
     if (!IsStarted() && !IsTerminating())
     {
-        m_thread = std::thread(&ThreadBase::Run, this);
+        m_stopSource = std::stop_source();
+        m_thread     = std::thread(&ThreadBase::Run, this);
 		SetStarted(true);
         SetThreadIdAndNativeHandle(m_thread.get_id(), m_thread.native_handle());
     }
@@ -59,6 +59,7 @@ bool ThreadBase::Stop()
     if (IsStarted() && !IsTerminating())
     {
         SetTerminating(true);
+        m_stopSource.request_stop();
         ProcessTerminationConditions();
     }
 
@@ -96,12 +97,6 @@ std::thread::native_handle_type ThreadBase::NativeHandle() const
     return m_nativeHandle;
 }
 
-bool ThreadBase::IsTerminating() const
-{
-    std::lock_guard<std::mutex> lock{m_mutex};
-    return m_terminating;
-}
-
 void ThreadBase::SleepForTime(unsigned int milliSecs) const
 {
     if (!IsStarted() || IsTerminating())
@@ -132,14 +127,12 @@ void ThreadBase::SetThreadIdAndNativeHandle(const std::thread::id&
 
 void ThreadBase::SetStarted(const bool started)
 {
-    std::lock_guard<std::mutex> lock{m_mutex};
-    m_started = started;
+    m_started.store(started, std::memory_order_release);
 }
 
 void ThreadBase::SetTerminating(bool terminating)
 {
-    std::lock_guard<std::mutex> lock{m_mutex};
-    m_terminating = terminating;
+    m_terminating.store(terminating, std::memory_order_release);
 }
 
 void ThreadBase::Run()
@@ -0,0 +1,226 @@
+// This file is part of CoreLibrary containing useful reusable utility
+// classes.
+//
+// Copyright (C) 2014 to present, Duncan Crutchley
+// Contact <15799155+dac1976@users.noreply.github.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License and GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License
+// and GNU Lesser General Public License along with this program. If
+// not, see <http://www.gnu.org/licenses/>.
+
+/*!
+ * \file ThreadPool.cpp
+ * \brief File containing definition of ThreadPool class.
+ */
+
+#include "Threads/ThreadPool.h"
+#include "Threads/ThreadPriority.h"
+#include <algorithm>
+
+/*! \brief The core_lib namespace. */
+namespace core_lib
+{
+/*! \brief The threads namespace. */
+namespace threads
+{
+
+namespace
+{
+
+/*! \brief Pool the calling thread is a worker of, if any. */
+thread_local ThreadPool const* t_workerPool = nullptr;
+/*! \brief Index of the calling worker within its pool. */
+thread_local size_t t_workerIndex = 0;
+
+} // namespace
+
+namespace pool_impl
+{
+
+// ****************************************************************************
+// 'class ContinuationState' definition
+// ****************************************************************************
+void ContinuationState::Complete()
+{
+    std::vector<std::function<void()>> continuations;
+
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_complete = true;
+        continuations.swap(m_continuations);
+    }
+
+    for (auto& continuation : continuations)
+    {
+        continuation();
+    }
+}
+
+void ContinuationState::Add(std::function<void()> continuation)
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+
+        if (!m_complete)
+        {
+            m_continuations.emplace_back(std::move(continuation));
+            return;
+        }
+    }
+
+    continuation();
+}
+
+} // namespace pool_impl
+
+// ****************************************************************************
+// 'class ThreadPool' definition
+// ****************************************************************************
+ThreadPool::ThreadPool(size_t numThreads, bool pinToCpus)
+{
+    const auto numCpus = std::max(std::thread::hardware_concurrency(), 1U);
+
+    if (numThreads == 0)
+    {
+        numThreads = numCpus;
+    }
+
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        m_queues.emplace_back(std::make_unique<task_queue_t>());
+    }
+
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        auto t = m_threads.CreateThread(std::bind(&ThreadPool::WorkerLoop, this, i));
+
+        if (pinToCpus)
+        {
+            SetThreadAffinity(t->native_handle(), static_cast<unsigned int>(i % numCpus));
+        }
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_waitMutex};
+        m_stop = true;
+    }
+
+    m_workCondition.notify_all();
+    m_threads.JoinAll();
+}
+
+size_t ThreadPool::Size() const
+{
+    return m_queues.size();
+}
+
+size_t ThreadPool::PendingTasks() const
+{
+    return m_pendingTasks.load();
+}
+
+bool ThreadPool::IsThisThreadIn() const
+{
+    return t_workerPool == this;
+}
+
+void ThreadPool::Post(std::function<void()> task)
+{
+    const auto index = IsThisThreadIn() ? t_workerIndex : m_nextQueue++ % m_queues.size();
+
+    // Count the task before it becomes visible so a worker taking it
+    // straight away never sees the count underflow.
+    ++m_pendingTasks;
+    m_queues[index]->Push(std::move(task));
+
+    // A worker parks before checking m_pendingTasks and we count the task before
+    // checking for parked workers, so either it sees the task or we see it. Only
+    // then is the mutex needed, to stop the notify landing before it sleeps.
+    if (m_parkedWorkers.load() == 0)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{m_waitMutex};
+    }
+
+    m_workCondition.notify_one();
+}
+
+void ThreadPool::WorkerLoop(size_t index)
+{
+    t_workerPool  = this;
+    t_workerIndex = index;
+
+    std::function<void()> task;
+
+    for (;;)
+    {
+        if (TakeTask(index, task))
+        {
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                // Do nothing, submitted tasks report exceptions through their futures.
+            }
+
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock{m_waitMutex};
+        ++m_parkedWorkers;
+        m_workCondition.wait(lock, [this] { return m_stop || (m_pendingTasks.load() > 0); });
+        --m_parkedWorkers;
+
+        if (m_stop && (m_pendingTasks.load() == 0))
+        {
+            break;
+        }
+    }
+
+    t_workerPool = nullptr;
+}
+
+bool ThreadPool::TakeTask(size_t index, std::function<void()>& task)
+{
+    if (m_queues[index]->TryPop(task))
+    {
+        --m_pendingTasks;
+        return true;
+    }
+
+    const auto numQueues = m_queues.size();
+
+    for (size_t i = 1; i < numQueues; ++i)
+    {
+        if (m_queues[(index + i) % numQueues]->TrySteal(task))
+        {
+            --m_pendingTasks;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace threads
+} // namespace core_lib
@@ -26,6 +26,7 @@
 #include "Threads/ThreadPriority.h"
 #if BOOST_OS_LINUX
 #include <pthread.h>
+#include <sched.h>
 #else
 #include <Windows.h>
 #endif
@@ -62,5 +63,32 @@ bool SetThreadPriority(std::thread::native_handle_type const& threadId, eHglThre
 }
 #endif
 
+#if BOOST_OS_LINUX
+bool SetThreadAffinity(std::thread::native_handle_type const& threadId, unsigned int cpuIndex)
+{
+    if (cpuIndex >= CPU_SETSIZE)
+    {
+        return false;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpuIndex, &cpuSet);
+
+    return pthread_setaffinity_np(threadId, sizeof(cpu_set_t), &cpuSet) == 0;
+}
+#else
+bool SetThreadAffinity(std::thread::native_handle_type const& threadId, unsigned int cpuIndex)
+{
+    if (cpuIndex >= sizeof(DWORD_PTR) * 8)
+    {
+        return false;
+    }
+
+    return ::SetThreadAffinityMask(reinterpret_cast<HANDLE>(threadId),
+                                   static_cast<DWORD_PTR>(1) << cpuIndex) != 0;
+}
+#endif
+
 } // namespace threads
 } // namespace core_lib
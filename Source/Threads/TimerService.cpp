@@ -0,0 +1,375 @@
+// This file is part of CoreLibrary containing useful reusable utility
+// classes.
+//
+// Copyright (C) 2014 to present, Duncan Crutchley
+// Contact <15799155+dac1976@users.noreply.github.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License and GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License
+// and GNU Lesser General Public License along with this program. If
+// not, see <http://www.gnu.org/licenses/>.
+
+/*!
+ * \file TimerService.cpp
+ * \brief File containing definition of TimerService class.
+ */
+
+#include "Threads/TimerService.h"
+#include <stdexcept>
+#include <limits>
+#include <algorithm>
+
+/*! \brief The core_lib namespace. */
+namespace core_lib
+{
+/*! \brief The threads namespace. */
+namespace threads
+{
+
+TimerService::TimerService(uint32_t tickMillisecs, size_t numSlots, size_t numCallbackThreads)
+    : m_tick(tickMillisecs)
+    , m_slots(numSlots)
+{
+    if (tickMillisecs == 0)
+    {
+        throw std::invalid_argument("incorrect tick period");
+    }
+
+    if (numSlots == 0)
+    {
+        throw std::invalid_argument("incorrect number of slots");
+    }
+
+    m_running.reserve(std::max<size_t>(numCallbackThreads, 1));
+    m_thread = std::thread(std::bind(&TimerService::Run, this));
+
+    for (size_t i = 0; i < numCallbackThreads; ++i)
+    {
+        m_callbackThreads.emplace_back(std::bind(&TimerService::RunCallbacks, this));
+    }
+}
+
+TimerService::~TimerService()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stop = true;
+    }
+
+    m_wakeCondition.notify_one();
+    m_callbackCondition.notify_all();
+
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+
+    for (auto& callbackThread : m_callbackThreads)
+    {
+        callbackThread.join();
+    }
+
+    // Leave any entries still pending detached so their owners can
+    // safely cancel them later.
+    for (auto& slot : m_slots)
+    {
+        while (slot.m_next != &slot)
+        {
+            Unlink(*slot.m_next);
+        }
+    }
+
+    while (m_expired.m_next != &m_expired)
+    {
+        Unlink(*m_expired.m_next);
+    }
+}
+
+TimerService& TimerService::Default()
+{
+    static TimerService service;
+    return service;
+}
+
+void TimerService::Schedule(TimerEntry& entry, uint32_t timeoutMillisecs,
+                            callback_t const& onTimedOut)
+{
+    if (timeoutMillisecs == 0)
+    {
+        throw std::invalid_argument("incorrect timeout period");
+    }
+
+    if (!onTimedOut)
+    {
+        throw std::invalid_argument("invalid timeout callback");
+    }
+
+    // Round up and add a tick as we may be part way through the current
+    // one, so the timer never fires early.
+    const uint64_t tickMs = static_cast<uint64_t>(m_tick.count());
+    const uint64_t ticks  = (timeoutMillisecs + tickMs - 1) / tickMs + 1;
+    bool           wake   = false;
+
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+
+        if (Unlink(entry))
+        {
+            --m_activeTimers;
+        }
+
+        if (m_activeTimers == 0)
+        {
+            // Wheel has been idle, restart its clock from now.
+            m_nextTickTime = std::chrono::steady_clock::now() + m_tick;
+            wake           = true;
+        }
+        else if (m_currentTick + ticks < m_wakeTick)
+        {
+            // Due before the wheel thread next wakes.
+            wake = true;
+        }
+
+        entry.m_callback = onTimedOut;
+        entry.m_rounds   = (ticks - 1) / m_slots.size();
+        LinkBack(m_slots[(m_currentSlot + ticks) % m_slots.size()], entry);
+        ++m_activeTimers;
+    }
+
+    if (wake)
+    {
+        m_wakeCondition.notify_one();
+    }
+}
+
+void TimerService::Cancel(TimerEntry& entry)
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+
+    if (Unlink(entry))
+    {
+        --m_activeTimers;
+    }
+
+    m_callbackDoneCondition.wait(lock, [this, &entry] { return !IsRunningElsewhere(entry); });
+}
+
+size_t TimerService::ActiveTimers() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_activeTimers;
+}
+
+void TimerService::Run()
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+
+    while (!m_stop)
+    {
+        if (m_activeTimers == 0)
+        {
+            m_wakeTick = std::numeric_limits<uint64_t>::max();
+            m_wakeCondition.wait(lock);
+            continue;
+        }
+
+        auto const now = std::chrono::steady_clock::now();
+
+        if (now < m_nextTickTime)
+        {
+            // Sleep until the earliest entry is due rather than waking every tick.
+            auto const ticks = TicksToNextExpiry();
+            m_wakeTick       = m_currentTick + ticks;
+            m_wakeCondition.wait_until(lock,
+                                       m_nextTickTime + m_tick * static_cast<int64_t>(ticks - 1));
+            continue;
+        }
+
+        // Catch up on the ticks passed while sleeping or running callbacks.
+        while ((m_activeTimers > 0) && (now >= m_nextTickTime))
+        {
+            AdvanceWheel();
+            m_nextTickTime += m_tick;
+        }
+
+        if (m_callbackThreads.empty())
+        {
+            FireExpired(lock);
+        }
+        else if (m_expired.m_next != &m_expired)
+        {
+            m_callbackCondition.notify_all();
+        }
+    }
+}
+
+void TimerService::RunCallbacks()
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+
+    while (!m_stop)
+    {
+        auto entry = NextRunnable();
+
+        if (entry == nullptr)
+        {
+            m_callbackCondition.wait(lock);
+        }
+        else
+        {
+            RunEntry(lock, *entry);
+        }
+    }
+}
+
+void TimerService::AdvanceWheel()
+{
+    ++m_currentTick;
+    m_currentSlot = (m_currentSlot + 1) % m_slots.size();
+    auto& head    = m_slots[m_currentSlot];
+    auto  entry   = head.m_next;
+
+    while (entry != &head)
+    {
+        auto next = entry->m_next;
+
+        if (entry->m_rounds == 0)
+        {
+            Unlink(*entry);
+            LinkBack(m_expired, *entry);
+        }
+        else
+        {
+            --entry->m_rounds;
+        }
+
+        entry = next;
+    }
+}
+
+uint64_t TimerService::TicksToNextExpiry() const
+{
+    const size_t numSlots = m_slots.size();
+
+    // The first slot holding an entry on its final round is the earliest due.
+    for (size_t ticks = 1; ticks <= numSlots; ++ticks)
+    {
+        auto const& head = m_slots[(m_currentSlot + ticks) % numSlots];
+
+        for (auto entry = head.m_next; entry != &head; entry = entry->m_next)
+        {
+            if (entry->m_rounds == 0)
+            {
+                return ticks;
+            }
+        }
+    }
+
+    // Nothing is due within a turn of the wheel so look again after one.
+    return numSlots;
+}
+
+void TimerService::FireExpired(std::unique_lock<std::mutex>& lock)
+{
+    while (!m_stop)
+    {
+        auto entry = NextRunnable();
+
+        if (entry == nullptr)
+        {
+            break;
+        }
+
+        RunEntry(lock, *entry);
+    }
+}
+
+TimerEntry* TimerService::NextRunnable() const
+{
+    // Skip entries that expired again while their previous callback is still running.
+    for (auto entry = m_expired.m_next; entry != &m_expired; entry = entry->m_next)
+    {
+        auto isRunning = std::any_of(m_running.begin(), m_running.end(),
+                                     [entry](auto const& running) { return running.first == entry; });
+
+        if (!isRunning)
+        {
+            return entry;
+        }
+    }
+
+    return nullptr;
+}
+
+void TimerService::RunEntry(std::unique_lock<std::mutex>& lock, TimerEntry& entry)
+{
+    Unlink(entry);
+    --m_activeTimers;
+    m_running.emplace_back(&entry, std::this_thread::get_id());
+
+    // Copy so the callback may safely reschedule its own entry.
+    auto callback = entry.m_callback;
+    lock.unlock();
+
+    try
+    {
+        callback();
+    }
+    catch (...)
+    {
+        // Do nothing.
+    }
+
+    lock.lock();
+
+    // The entry may have been destroyed by its callback so only compare its address.
+    auto running = std::find(m_running.begin(), m_running.end(),
+                             std::make_pair(static_cast<TimerEntry const*>(&entry),
+                                            std::this_thread::get_id()));
+    m_running.erase(running);
+    m_callbackDoneCondition.notify_all();
+}
+
+bool TimerService::IsRunningElsewhere(TimerEntry const& entry) const
+{
+    auto const self = std::this_thread::get_id();
+
+    return std::any_of(m_running.begin(), m_running.end(), [&entry, self](auto const& running) {
+        return (running.first == &entry) && (running.second != self);
+    });
+}
+
+bool TimerService::Unlink(TimerEntry& entry)
+{
+    if (entry.m_next == &entry)
+    {
+        return false;
+    }
+
+    entry.m_prev->m_next = entry.m_next;
+    entry.m_next->m_prev = entry.m_prev;
+    entry.m_prev         = &entry;
+    entry.m_next         = &entry;
+    return true;
+}
+
+void TimerService::LinkBack(TimerEntry& head, TimerEntry& entry)
+{
+    entry.m_prev         = head.m_prev;
+    entry.m_next         = &head;
+    head.m_prev->m_next  = &entry;
+    head.m_prev          = &entry;
+}
+
+} // namespace threads
+} // namespace core_lib
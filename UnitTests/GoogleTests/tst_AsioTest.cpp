@@ -4,11 +4,15 @@
 #include <algorithm>
 #include <iterator>
 #include <numeric>
+#include <map>
+#include <set>
+#include <thread>
 
 #include "Threads/EventThread.h"
 #include "Serialization/SerializeToVector.h"
 #include "Asio/TcpServer.h"
 #include "Asio/TcpClient.h"
+#include "Asio/TcpConnection.h"
 #include "Asio/TcpTypedServer.h"
 #include "Asio/TcpTypedClient.h"
 #include "Asio/SimpleTcpServer.h"
@@ -24,6 +28,7 @@
 #include "Asio/SimpleMulticastReceiver.h"
 #include "Asio/SimpleMulticastSender.h"
 #include "Asio/NetworkUtils.h"
+#include "Asio/BufferPool.h"
 #include <cereal/types/string.hpp>
 #include "gtest/gtest.h"
 #include "gtest_cout.h"
@@ -183,6 +188,53 @@ private:
     }
 };
 
+class ConnectionThreadReceiver
+{
+public:
+    void MessageReceivedHandler(char_buf_cspan_t /*message*/, std::string_view /*address*/,
+                                uint16_t port)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_connectionThreads[port].insert(std::this_thread::get_id());
+            ++m_messageCounter;
+        }
+
+        m_messageEvent.Signal();
+    }
+
+    bool WaitForMessages(const size_t count, const size_t milliseconds)
+    {
+        while (MessageCount() < count)
+        {
+            if (!m_messageEvent.WaitForTime(static_cast<unsigned int>(milliseconds)))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    size_t MessageCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_messageCounter;
+    }
+
+    std::map<uint16_t, std::set<std::thread::id>> ConnectionThreads() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_connectionThreads;
+    }
+
+private:
+    mutable std::mutex                              m_mutex;
+    SyncEvent                                       m_messageEvent;
+    std::map<uint16_t, std::set<std::thread::id>>   m_connectionThreads;
+    size_t                                          m_messageCounter{0};
+};
+
 struct MyLargeMessage
 {
     std::string         name;
@@ -670,6 +722,639 @@ TEST(AsioTest, testCase_TestAsync_LargeMessage_2)
     }
 }
 
+TEST(AsioTest, testCase_TestAsync_Streaming)
+{
+    char_buffer_t   message = BuildMessage();
+    MessageReceiver svrReceiver;
+    core_lib::asio::tcp::TcpConnSettings settings;
+    settings.minAmountToRead = sizeof(MyHeader);
+    settings.readMode        = eReadMode::streaming;
+
+    TcpServer server(
+        22222,
+        std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+        std::bind(&MessageReceiver::MessageReceivedHandler, &svrReceiver, std::placeholders::_1),
+        settings);
+
+    MessageReceiver cltReceiver;
+    TcpClient       client(
+        std::make_pair(ADDRESS_ONE, 22222),
+        std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+        std::bind(&MessageReceiver::MessageReceivedHandler, &cltReceiver, std::placeholders::_1),
+        settings);
+
+    const size_t numMessages = 50;
+
+    for (size_t i = 0; i < numMessages; ++i)
+    {
+        EXPECT_TRUE(client.SendMessageToServerAsync(message) == true);
+    }
+
+    while ((svrReceiver.MessageCount() < numMessages) && svrReceiver.WaitForMessage(3000))
+    {
+    }
+
+    EXPECT_EQ(svrReceiver.MessageCount(), numMessages);
+    MyMessage expectedMessage;
+    expectedMessage.FillMessage();
+    MyMessage receivedMessage = svrReceiver.Message();
+    EXPECT_TRUE(receivedMessage == expectedMessage);
+
+    auto clientConn = client.GetClientDetailsForServer();
+
+    for (size_t i = 0; i < numMessages; ++i)
+    {
+        EXPECT_TRUE(server.SendMessageToClientAsync(clientConn, message) == true);
+    }
+
+    while ((cltReceiver.MessageCount() < numMessages) && cltReceiver.WaitForMessage(3000))
+    {
+    }
+
+    EXPECT_EQ(cltReceiver.MessageCount(), numMessages);
+    receivedMessage = cltReceiver.Message();
+    EXPECT_TRUE(receivedMessage == expectedMessage);
+}
+
+TEST(AsioTest, testCase_TestAsync_GatherWrites)
+{
+    const size_t    numMessages = 200;
+    char_buffer_t   message     = BuildMessage();
+    MessageReceiver svrReceiver;
+    core_lib::asio::tcp::TcpConnSettings settings;
+    settings.minAmountToRead               = sizeof(MyHeader);
+    settings.maxAllowedUnsentAsyncMessages = numMessages;
+    settings.sendPoolMsgSize               = message.size();
+    settings.maxGatherWriteBytes           = message.size() * 8;
+
+    TcpServer server(
+        22222,
+        std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+        std::bind(&MessageReceiver::MessageReceivedHandler, &svrReceiver, std::placeholders::_1),
+        settings);
+
+    MessageReceiver cltReceiver;
+    TcpClient       client(
+        std::make_pair(ADDRESS_ONE, 22222),
+        std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+        std::bind(&MessageReceiver::MessageReceivedHandler, &cltReceiver, std::placeholders::_1),
+        settings);
+
+    for (size_t i = 0; i < numMessages; ++i)
+    {
+        EXPECT_TRUE(client.SendMessageToServerAsync(message) == true);
+    }
+
+    while ((svrReceiver.MessageCount() < numMessages) && svrReceiver.WaitForMessage(3000))
+    {
+    }
+
+    EXPECT_EQ(svrReceiver.MessageCount(), numMessages);
+    MyMessage expectedMessage;
+    expectedMessage.FillMessage();
+    MyMessage receivedMessage = svrReceiver.Message();
+    EXPECT_TRUE(receivedMessage == expectedMessage);
+
+    auto clientConn = client.GetClientDetailsForServer();
+
+    for (size_t i = 0; i < numMessages; ++i)
+    {
+        EXPECT_TRUE(server.SendMessageToClientAsync(clientConn, message) == true);
+    }
+
+    while ((cltReceiver.MessageCount() < numMessages) && cltReceiver.WaitForMessage(3000))
+    {
+    }
+
+    EXPECT_EQ(cltReceiver.MessageCount(), numMessages);
+    receivedMessage = cltReceiver.Message();
+    EXPECT_TRUE(receivedMessage == expectedMessage);
+}
+
+TEST(AsioTest, testCase_TestAsync_SharedBroadcast)
+{
+    const size_t numMessages = 10;
+    auto         message     = std::make_shared<const char_buffer_t>(BuildMessage());
+
+    {
+        MessageReceiver svrReceiver;
+        TcpServer       server(
+            22222,
+            std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+            std::bind(&MessageReceiver::MessageReceivedHandler, &svrReceiver, std::placeholders::_1));
+
+        MessageReceiver cltReceiverOne;
+        TcpClient       clientOne(std::make_pair(ADDRESS_ONE, 22222),
+                            std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+                            std::bind(&MessageReceiver::MessageReceivedHandler,
+                                      &cltReceiverOne,
+                                      std::placeholders::_1));
+
+        MessageReceiver cltReceiverTwo;
+        TcpClient       clientTwo(std::make_pair(ADDRESS_ONE, 22222),
+                            std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+                            std::bind(&MessageReceiver::MessageReceivedHandler,
+                                      &cltReceiverTwo,
+                                      std::placeholders::_1));
+
+        // Make sure the server has registered both clients before broadcasting.
+        EXPECT_TRUE(clientOne.SendMessageToServerAsync(*message) == true);
+        EXPECT_TRUE(clientTwo.SendMessageToServerAsync(*message) == true);
+
+        while ((svrReceiver.MessageCount() < 2) && svrReceiver.WaitForMessage(3000))
+        {
+        }
+
+        EXPECT_EQ(server.NumberOfClients(), 2U);
+
+        for (size_t i = 0; i < numMessages; ++i)
+        {
+            server.SendMessageToAllClients(message);
+        }
+
+        // Span version copies the message once and shares it between clients.
+        server.SendMessageToAllClients(char_buf_cspan_t(*message));
+
+        while ((cltReceiverOne.MessageCount() < numMessages + 1) &&
+               cltReceiverOne.WaitForMessage(3000))
+        {
+        }
+
+        while ((cltReceiverTwo.MessageCount() < numMessages + 1) &&
+               cltReceiverTwo.WaitForMessage(3000))
+        {
+        }
+
+        EXPECT_EQ(cltReceiverOne.MessageCount(), numMessages + 1);
+        EXPECT_EQ(cltReceiverTwo.MessageCount(), numMessages + 1);
+        MyMessage expectedMessage;
+        expectedMessage.FillMessage();
+        EXPECT_TRUE(cltReceiverOne.Message() == expectedMessage);
+        EXPECT_TRUE(cltReceiverTwo.Message() == expectedMessage);
+    }
+
+    // No connection is holding on to the shared buffer any more.
+    EXPECT_EQ(message.use_count(), 1);
+}
+
+TEST(AsioTest, testCase_TestAsync_CachedEndPointAndConnectionId)
+{
+    char_buffer_t message = BuildMessage();
+    std::mutex    mutex;
+    connection_t  senderEndPoint;
+    SyncEvent     messageEvent;
+
+    auto checkBytesLeftToReadEx = [](char_buf_cspan_t msg, std::string_view, uint16_t) {
+        return MessageReceiver::CheckBytesLeftToRead(msg);
+    };
+
+    auto messageReceivedHandlerEx =
+        [&](char_buf_cspan_t, std::string_view address, uint16_t port) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                senderEndPoint = std::make_pair(std::string(address), port);
+            }
+
+            messageEvent.Signal();
+        };
+
+    TcpServer server(22222, {}, {}, {}, messageReceivedHandlerEx, checkBytesLeftToReadEx);
+
+    MessageReceiver cltReceiverOne;
+    TcpClient       clientOne(
+        std::make_pair(ADDRESS_ONE, 22222),
+        std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+        std::bind(&MessageReceiver::MessageReceivedHandler, &cltReceiverOne, std::placeholders::_1));
+
+    MessageReceiver cltReceiverTwo;
+    TcpClient       clientTwo(
+        std::make_pair(ADDRESS_ONE, 22222),
+        std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+        std::bind(&MessageReceiver::MessageReceivedHandler, &cltReceiverTwo, std::placeholders::_1));
+
+    EXPECT_TRUE(clientOne.SendMessageToServerAsync(message) == true);
+    EXPECT_TRUE(messageEvent.WaitForTime(3000));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_TRUE(senderEndPoint == clientOne.GetClientDetailsForServer());
+    }
+
+    EXPECT_TRUE(clientTwo.SendMessageToServerAsync(message) == true);
+    EXPECT_TRUE(messageEvent.WaitForTime(3000));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_TRUE(senderEndPoint == clientTwo.GetClientDetailsForServer());
+    }
+
+    auto idOne = server.GetClientConnectionId(clientOne.GetClientDetailsForServer());
+    auto idTwo = server.GetClientConnectionId(clientTwo.GetClientDetailsForServer());
+    EXPECT_NE(idOne, NULL_CONNECTION_ID);
+    EXPECT_NE(idTwo, NULL_CONNECTION_ID);
+    EXPECT_NE(idOne, idTwo);
+    EXPECT_EQ(server.GetClientConnectionId(NULL_CONNECTION), NULL_CONNECTION_ID);
+}
+
+TEST(AsioTest, testCase_TcpConnections_ShardedAddFindRemove)
+{
+    asio_compat::io_service_t ioService;
+    auto                      connections = std::make_shared<TcpConnections>();
+    std::vector<connection_t> closed;
+
+    connections->SetOnCloseCallback(
+        [&closed](connection_t const& endpoint) { closed.push_back(endpoint); });
+
+    // Spread over several addresses and consecutive ports so every shard is used, plus
+    // non-IPv4 endpoints which are keyed by hash.
+    std::vector<std::pair<connection_t, tcp_conn_ptr_t>> entries;
+
+    for (uint16_t i = 0; i < 64; ++i)
+    {
+        auto address  = "192.168.1." + std::to_string(1 + (i % 4));
+        auto endpoint = std::make_pair(address, static_cast<uint16_t>(30000 + i));
+        entries.emplace_back(endpoint, std::make_shared<TcpConnection>(ioService, connections,
+                                                                       nullptr, nullptr));
+    }
+
+    entries.emplace_back(std::make_pair(std::string("::1"), static_cast<uint16_t>(30000)),
+                         std::make_shared<TcpConnection>(ioService, connections, nullptr, nullptr));
+    entries.emplace_back(std::make_pair(std::string("localhost"), static_cast<uint16_t>(30000)),
+                         std::make_shared<TcpConnection>(ioService, connections, nullptr, nullptr));
+
+    for (auto const& e : entries)
+    {
+        connections->Add(e.first, e.second);
+    }
+
+    EXPECT_EQ(connections->Size(), entries.size());
+
+    for (auto const& e : entries)
+    {
+        EXPECT_TRUE(connections->IsConnected(e.first));
+        EXPECT_EQ(connections->ConnectionId(e.first), e.second->Id());
+    }
+
+    EXPECT_FALSE(connections->IsConnected(std::make_pair(std::string("192.168.1.1"), 29999)));
+    EXPECT_EQ(connections->ConnectionId(NULL_CONNECTION), NULL_CONNECTION_ID);
+
+    auto snapshot = connections->Connections();
+    EXPECT_EQ(snapshot.size(), entries.size());
+
+    std::set<tcp_conn_ptr_t> snapshotSet(snapshot.begin(), snapshot.end());
+
+    for (auto const& e : entries)
+    {
+        EXPECT_EQ(snapshotSet.count(e.second), 1U);
+    }
+
+    // Re-adding a connection under a new endpoint moves it.
+    auto const moved = std::make_pair(std::string("10.0.0.1"), static_cast<uint16_t>(40000));
+    connections->Add(moved, entries.front().second);
+    EXPECT_FALSE(connections->IsConnected(entries.front().first));
+    EXPECT_EQ(connections->ConnectionId(moved), entries.front().second->Id());
+    EXPECT_EQ(connections->Size(), entries.size());
+    entries.front().first = moved;
+
+    for (size_t i = 0; i < entries.size(); i += 2)
+    {
+        connections->Remove(entries[i].second);
+    }
+
+    EXPECT_EQ(closed.size(), (entries.size() + 1) / 2);
+    EXPECT_EQ(connections->Size(), entries.size() / 2);
+    EXPECT_EQ(connections->Connections().size(), entries.size() / 2);
+
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        EXPECT_EQ(connections->IsConnected(entries[i].first), (i % 2) != 0);
+    }
+
+    EXPECT_TRUE(closed.front() == moved);
+
+    // Removing an unknown connection is a no-op.
+    connections->Remove(entries.front().second);
+    EXPECT_EQ(closed.size(), (entries.size() + 1) / 2);
+
+    for (size_t i = 1; i < entries.size(); i += 2)
+    {
+        connections->Remove(entries[i].second);
+    }
+
+    EXPECT_TRUE(connections->Empty());
+    EXPECT_TRUE(connections->Connections().empty());
+}
+
+TEST(AsioTest, testCase_TestAsync_ConnectionIdHandlers)
+{
+    char_buffer_t   message = BuildMessage();
+    std::mutex      mutex;
+    connection_t    senderEndPoint;
+    connection_id_t checkBytesId{NULL_CONNECTION_ID};
+    connection_id_t receivedId{NULL_CONNECTION_ID};
+    SyncEvent       messageEvent;
+
+    auto checkBytesLeftToReadId =
+        [&](char_buf_cspan_t msg, std::string_view, uint16_t, connection_id_t id) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                checkBytesId = id;
+            }
+
+            return MessageReceiver::CheckBytesLeftToRead(msg);
+        };
+
+    auto messageReceivedHandlerId =
+        [&](char_buf_cspan_t, std::string_view address, uint16_t port, connection_id_t id) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                senderEndPoint = std::make_pair(std::string(address), port);
+                receivedId     = id;
+            }
+
+            messageEvent.Signal();
+        };
+
+    TcpServer server(
+        22222, {}, {}, {}, {}, {}, {}, messageReceivedHandlerId, checkBytesLeftToReadId);
+
+    MessageReceiver cltReceiver;
+    TcpClient       client(
+        std::make_pair(ADDRESS_ONE, 22222),
+        std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+        std::bind(&MessageReceiver::MessageReceivedHandler, &cltReceiver, std::placeholders::_1));
+
+    EXPECT_TRUE(client.SendMessageToServerAsync(message) == true);
+    EXPECT_TRUE(messageEvent.WaitForTime(3000));
+
+    auto const id = server.GetClientConnectionId(client.GetClientDetailsForServer());
+    EXPECT_NE(id, NULL_CONNECTION_ID);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_TRUE(senderEndPoint == client.GetClientDetailsForServer());
+    EXPECT_EQ(receivedId, id);
+    EXPECT_EQ(checkBytesId, id);
+}
+
+TEST(AsioTest, testCase_TestAsync_LargeMessage_Streaming)
+{
+    char_buffer_t        message = BuildLargeMessage(625000);
+    LargeMessageReceiver svrReceiver;
+    core_lib::asio::tcp::TcpConnSettings settings;
+    settings.minAmountToRead = sizeof(MyHeader);
+    settings.readMode        = eReadMode::streaming;
+
+    TcpServer server(22222,
+                     std::bind(&LargeMessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+                     std::bind(&LargeMessageReceiver::MessageReceivedHandler,
+                               &svrReceiver,
+                               std::placeholders::_1),
+                     settings);
+
+    LargeMessageReceiver cltReceiver;
+    TcpClient client(std::make_pair(ADDRESS_ONE, 22222),
+                     std::bind(&LargeMessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+                     std::bind(&LargeMessageReceiver::MessageReceivedHandler,
+                               &cltReceiver,
+                               std::placeholders::_1),
+                     settings);
+
+    MyLargeMessage expectedMessage;
+    expectedMessage.FillMessage(625000);
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+        EXPECT_TRUE(client.SendMessageToServerAsync(message) == true);
+
+        svrReceiver.WaitForMessage(3000);
+
+        MyLargeMessage receivedMessage = svrReceiver.Message();
+        EXPECT_TRUE(receivedMessage == expectedMessage);
+
+        auto clientConn = client.GetClientDetailsForServer();
+        EXPECT_TRUE(server.SendMessageToClientAsync(clientConn, message) == true);
+
+        cltReceiver.WaitForMessage(3000);
+        receivedMessage = cltReceiver.Message();
+        EXPECT_TRUE(receivedMessage == expectedMessage);
+    }
+
+    EXPECT_EQ(svrReceiver.MessageCount(), 10U);
+    EXPECT_EQ(cltReceiver.MessageCount(), 10U);
+}
+
+TEST(AsioTest, testCase_BufferPool)
+{
+    BufferPool pool(4 * BufferPool::MAX_BLOCK_SIZE);
+
+    auto block = pool.Acquire(100);
+    EXPECT_FALSE(block.Empty());
+    EXPECT_EQ(block.Size(), 128U);
+    EXPECT_EQ(pool.BytesInUse(), 128U);
+
+    auto const data = block.Data();
+    block.Reset();
+    EXPECT_TRUE(block.Empty());
+    EXPECT_EQ(pool.BytesInUse(), 0U);
+    EXPECT_EQ(pool.CachedBytes(), 128U);
+
+    // Same size class so the cached block is reused.
+    auto reused = pool.Acquire(65);
+    EXPECT_EQ(reused.Data(), data);
+    EXPECT_EQ(pool.CachedBytes(), 0U);
+
+    // Too big to cache so allocated exactly and freed on release.
+    {
+        auto big = pool.Acquire(BufferPool::MAX_BLOCK_SIZE + 1);
+        EXPECT_EQ(big.Size(), BufferPool::MAX_BLOCK_SIZE + 1);
+    }
+
+    EXPECT_EQ(pool.CachedBytes(), 0U);
+
+    // Only up to the cache limit is kept.
+    {
+        std::vector<BufferPool::Block> blocks;
+
+        for (size_t i = 0; i < 6; ++i)
+        {
+            blocks.emplace_back(pool.Acquire(BufferPool::MAX_BLOCK_SIZE));
+        }
+    }
+
+    EXPECT_EQ(pool.CachedBytes(), 4 * BufferPool::MAX_BLOCK_SIZE);
+
+    auto moved = std::move(reused);
+    EXPECT_TRUE(reused.Empty());
+    EXPECT_EQ(moved.Data(), data);
+
+    pool.Trim();
+    EXPECT_EQ(pool.CachedBytes(), 0U);
+    EXPECT_EQ(pool.BytesInUse(), 128U);
+}
+
+TEST(AsioTest, testCase_TestAsync_OnDemandBuffers)
+{
+    const size_t  numClients  = 8;
+    const size_t  numMessages = 20;
+    char_buffer_t message     = BuildMessage();
+    MyMessage     expectedMessage;
+    expectedMessage.FillMessage();
+
+    for (auto readMode : {eReadMode::headerThenBody, eReadMode::streaming})
+    {
+        auto const baseline = BufferPool::Default().BytesInUse();
+
+        core_lib::asio::tcp::TcpConnSettings settings;
+        settings.minAmountToRead               = sizeof(MyHeader);
+        settings.maxAllowedUnsentAsyncMessages = numMessages;
+        settings.sendPoolMsgSize               = message.size();
+        settings.readMode                      = readMode;
+        settings.bufferMode                    = eBufferMode::onDemand;
+
+        MessageReceiver svrReceiver;
+        TcpServer       server(
+            22222,
+            std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+            std::bind(&MessageReceiver::MessageReceivedHandler, &svrReceiver, std::placeholders::_1),
+            settings);
+
+        std::vector<std::unique_ptr<MessageReceiver>> cltReceivers;
+        std::vector<std::unique_ptr<TcpClient>>       clients;
+
+        for (size_t c = 0; c < numClients; ++c)
+        {
+            cltReceivers.emplace_back(std::make_unique<MessageReceiver>());
+            clients.emplace_back(std::make_unique<TcpClient>(
+                std::make_pair(ADDRESS_ONE, 22222),
+                std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+                std::bind(&MessageReceiver::MessageReceivedHandler,
+                          cltReceivers.back().get(),
+                          std::placeholders::_1),
+                settings));
+        }
+
+        for (size_t i = 0; i < numMessages; ++i)
+        {
+            for (auto& client : clients)
+            {
+                EXPECT_TRUE(client->SendMessageToServerAsync(message) == true);
+            }
+        }
+
+        while ((svrReceiver.MessageCount() < numClients * numMessages) &&
+               svrReceiver.WaitForMessage(3000))
+        {
+        }
+
+        EXPECT_EQ(svrReceiver.MessageCount(), numClients * numMessages);
+        EXPECT_TRUE(svrReceiver.Message() == expectedMessage);
+
+        for (size_t c = 0; c < numClients; ++c)
+        {
+            auto clientConn = clients[c]->GetClientDetailsForServer();
+
+            for (size_t i = 0; i < numMessages; ++i)
+            {
+                EXPECT_TRUE(server.SendMessageToClientAsync(clientConn, message) == true);
+            }
+
+            while ((cltReceivers[c]->MessageCount() < numMessages) &&
+                   cltReceivers[c]->WaitForMessage(3000))
+            {
+            }
+
+            EXPECT_EQ(cltReceivers[c]->MessageCount(), numMessages);
+            EXPECT_TRUE(cltReceivers[c]->Message() == expectedMessage);
+
+            // Every send came from the shared pool, which never runs out of blocks.
+            auto const stats = clients[c]->SendPoolStats();
+            EXPECT_EQ(stats.hits, numMessages);
+            EXPECT_EQ(stats.misses, 0U);
+            EXPECT_EQ(stats.allocationFailures, 0U);
+        }
+
+        // Once idle each connection should hold at most a header sized receive block.
+        auto const idleLimit =
+            2 * numClients * 2 * std::max(sizeof(MyHeader), BufferPool::MIN_BLOCK_SIZE);
+        auto       idleBytes = BufferPool::Default().BytesInUse() - baseline;
+
+        for (int i = 0; (i < 200) && (idleBytes > idleLimit); ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            idleBytes = BufferPool::Default().BytesInUse() - baseline;
+        }
+
+        EXPECT_LE(idleBytes, idleLimit);
+    }
+}
+
+TEST(AsioTest, testCase_TestAsync_SendPoolConcurrentSenders)
+{
+    const size_t    numThreads  = 4;
+    const size_t    numMessages = 500;
+    char_buffer_t   message     = BuildMessage();
+    MessageReceiver svrReceiver;
+    core_lib::asio::tcp::TcpConnSettings settings;
+    settings.minAmountToRead               = sizeof(MyHeader);
+    settings.maxAllowedUnsentAsyncMessages = 16;
+    settings.sendPoolMsgSize               = message.size();
+
+    TcpServer server(
+        22222,
+        std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+        std::bind(&MessageReceiver::MessageReceivedHandler, &svrReceiver, std::placeholders::_1),
+        settings);
+
+    MessageReceiver cltReceiver;
+    TcpClient       client(
+        std::make_pair(ADDRESS_ONE, 22222),
+        std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+        std::bind(&MessageReceiver::MessageReceivedHandler, &cltReceiver, std::placeholders::_1),
+        settings);
+
+    auto const start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> senders;
+
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+        senders.emplace_back([&client, &message]() {
+            for (size_t i = 0; i < numMessages; ++i)
+            {
+                // Retry while at the unsent message limit.
+                while (!client.SendMessageToServerAsync(message))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (auto& sender : senders)
+    {
+        sender.join();
+    }
+
+    while ((svrReceiver.MessageCount() < numThreads * numMessages) &&
+           svrReceiver.WaitForMessage(3000))
+    {
+    }
+
+    auto const elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    EXPECT_EQ(svrReceiver.MessageCount(), numThreads * numMessages);
+
+    // The unsent message limit equals the pool size so a slot is always free, any
+    // misses would mean the lock-free free-list lost a slot.
+    auto const stats = client.SendPoolStats();
+    EXPECT_EQ(stats.hits, numThreads * numMessages);
+    EXPECT_EQ(stats.misses, 0U);
+
+    GOUT(numThreads << " threads x " << numMessages << " pooled async sends: " << elapsed.count()
+                    << " us");
+}
+
 TEST(AsioTest, testCase_TestBadConnect_InvalidTarget)
 {
     char_buffer_t message = BuildMessage();
@@ -805,6 +1490,160 @@ TEST(AsioTest, testCase_TestSync_ExternalIoService)
     EXPECT_TRUE(receivedMessage == expectedMessage);
 }
 
+TEST(AsioTest, testCase_TestAsync_PerThreadIoContext)
+{
+    const size_t  numClients  = 4;
+    const size_t  numMessages = 50;
+    char_buffer_t message     = BuildMessage();
+
+    for (auto distribution :
+         {eConnectionDistribution::roundRobin, eConnectionDistribution::leastLoaded})
+    {
+        IoContextThreadGroup ioThreadGroup(numClients, eIoContextMode::perThread);
+        EXPECT_EQ(ioThreadGroup.NumIoServices(), numClients);
+        EXPECT_TRUE(ioThreadGroup.Mode() == eIoContextMode::perThread);
+
+        core_lib::asio::tcp::TcpConnSettings settings;
+        settings.minAmountToRead               = sizeof(MyHeader);
+        settings.maxAllowedUnsentAsyncMessages = numMessages;
+
+        ConnectionThreadReceiver svrReceiver;
+        TcpServer                server(ioThreadGroup,
+                         22222,
+                         std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+                         {},
+                         settings,
+                         distribution,
+                         std::bind(&ConnectionThreadReceiver::MessageReceivedHandler,
+                                   &svrReceiver,
+                                   std::placeholders::_1,
+                                   std::placeholders::_2,
+                                   std::placeholders::_3));
+
+        MessageReceiver                         cltReceiver;
+        std::vector<std::unique_ptr<TcpClient>> clients;
+
+        for (size_t c = 0; c < numClients; ++c)
+        {
+            clients.emplace_back(std::make_unique<TcpClient>(
+                std::make_pair(ADDRESS_ONE, 22222),
+                std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+                std::bind(
+                    &MessageReceiver::MessageReceivedHandler, &cltReceiver, std::placeholders::_1),
+                settings));
+
+            // Connect one at a time so the distribution is deterministic.
+            EXPECT_TRUE(clients.back()->SendMessageToServerSync(message));
+            EXPECT_TRUE(svrReceiver.WaitForMessages(c + 1, 3000));
+        }
+
+        for (size_t i = 1; i < numMessages; ++i)
+        {
+            for (auto& client : clients)
+            {
+                EXPECT_TRUE(client->SendMessageToServerAsync(message));
+            }
+        }
+
+        EXPECT_TRUE(svrReceiver.WaitForMessages(numClients * numMessages, 3000));
+
+        // Each connection's handlers ran on one thread, each on a different thread.
+        auto                      connectionThreads = svrReceiver.ConnectionThreads();
+        std::set<std::thread::id> allThreads;
+        EXPECT_EQ(connectionThreads.size(), numClients);
+
+        for (auto const& threads : connectionThreads)
+        {
+            EXPECT_EQ(threads.second.size(), 1U);
+            allThreads.insert(threads.second.begin(), threads.second.end());
+        }
+
+        EXPECT_EQ(allThreads.size(), numClients);
+
+        // Replies go out on the connections' own contexts.
+        for (auto& client : clients)
+        {
+            EXPECT_TRUE(server.SendMessageToClientAsync(client->GetClientDetailsForServer(),
+                                                        message));
+        }
+
+        while ((cltReceiver.MessageCount() < numClients) && cltReceiver.WaitForMessage(3000))
+        {
+        }
+
+        EXPECT_EQ(cltReceiver.MessageCount(), numClients);
+    }
+}
+
+TEST(AsioTest, testCase_TestAsync_IoContextModeThroughput)
+{
+    const size_t  numThreads  = 4;
+    const size_t  numClients  = 8;
+    const size_t  numMessages = 2000;
+    char_buffer_t message     = BuildMessage();
+
+    auto runServer = [&](eIoContextMode mode) {
+        IoContextThreadGroup ioThreadGroup(numThreads, mode);
+
+        core_lib::asio::tcp::TcpConnSettings settings;
+        settings.minAmountToRead               = sizeof(MyHeader);
+        settings.maxAllowedUnsentAsyncMessages = numMessages;
+
+        ConnectionThreadReceiver svrReceiver;
+        TcpServer                server(ioThreadGroup,
+                         22222,
+                         std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+                         {},
+                         settings,
+                         eConnectionDistribution::roundRobin,
+                         std::bind(&ConnectionThreadReceiver::MessageReceivedHandler,
+                                   &svrReceiver,
+                                   std::placeholders::_1,
+                                   std::placeholders::_2,
+                                   std::placeholders::_3));
+
+        MessageReceiver                         cltReceiver;
+        std::vector<std::unique_ptr<TcpClient>> clients;
+
+        for (size_t c = 0; c < numClients; ++c)
+        {
+            clients.emplace_back(std::make_unique<TcpClient>(
+                std::make_pair(ADDRESS_ONE, 22222),
+                std::bind(&MessageReceiver::CheckBytesLeftToRead, std::placeholders::_1),
+                std::bind(
+                    &MessageReceiver::MessageReceivedHandler, &cltReceiver, std::placeholders::_1),
+                settings));
+            EXPECT_TRUE(clients.back()->SendMessageToServerSync(message));
+        }
+
+        EXPECT_TRUE(svrReceiver.WaitForMessages(numClients, 3000));
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < numMessages; ++i)
+        {
+            for (auto& client : clients)
+            {
+                while (!client->SendMessageToServerAsync(message))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        EXPECT_TRUE(svrReceiver.WaitForMessages(numClients * (numMessages + 1), 10000));
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now() - start)
+            .count();
+    };
+
+    const auto sharedTime    = runServer(eIoContextMode::shared);
+    const auto perThreadTime = runServer(eIoContextMode::perThread);
+
+    GOUT(numClients << " clients x " << numMessages << " messages, shared io_context: "
+                    << sharedTime << " us, io_context per thread: " << perThreadTime << " us");
+}
+
 TEST(AsioTest, testCase_TestTypedAsync)
 {
     MessageBuilder    messageBuilder;
@@ -857,6 +1696,83 @@ TEST(AsioTest, testCase_TestTypedAsync)
     EXPECT_TRUE(respAddress == serverConn);
 }
 
+TEST(AsioTest, testCase_TestTypedAsync_PerThreadBuilder)
+{
+    const size_t   numThreads        = 4;
+    const size_t   messagesPerThread = 25;
+    MessageBuilder messageBuilder(DEFAULT_MAGIC_STRING, eBuilderMode::perThreadBuffers);
+    EXPECT_TRUE(IsThreadSafeBuilder(messageBuilder));
+    EXPECT_FALSE(IsThreadSafeBuilder(MessageBuilder()));
+
+    MyMessage messageToSend;
+    messageToSend.FillMessage();
+
+    std::mutex mutex;
+    size_t     numGood = 0;
+    size_t     numBad  = 0;
+    SyncEvent  allReceivedEvent;
+
+    auto dispatcher = [&](default_received_message_ptr_t const& message) {
+        bool good = (message->header.messageId == 666) &&
+                    (ToObject<MyMessage, core_lib::serialize::archives::in_port_bin_t>(
+                         message->body) == messageToSend);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        ++(good ? numGood : numBad);
+
+        if (numGood + numBad == numThreads * messagesPerThread)
+        {
+            allReceivedEvent.Signal();
+        }
+    };
+
+    MessageHandler svrMessageHandler(dispatcher, DEFAULT_MAGIC_STRING);
+    TcpTypedServer<MessageBuilder> server(
+        22222,
+        std::bind(&MessageHandler::CheckBytesLeftToRead, &svrMessageHandler, std::placeholders::_1),
+        std::bind(
+            &MessageHandler::MessageReceivedHandler, &svrMessageHandler, std::placeholders::_1),
+        messageBuilder);
+
+    TcpConnSettings settings;
+    settings.maxAllowedUnsentAsyncMessages = numThreads * messagesPerThread;
+
+    MessageDispatcher clientDispatcher;
+    MessageHandler    cltMessageHandler(
+        std::bind(&MessageDispatcher::DispatchMessage, &clientDispatcher, std::placeholders::_1),
+        DEFAULT_MAGIC_STRING);
+    TcpTypedClient<MessageBuilder> client(
+        std::make_pair(ADDRESS_ONE, 22222),
+        std::bind(&MessageHandler::CheckBytesLeftToRead, &cltMessageHandler, std::placeholders::_1),
+        std::bind(
+            &MessageHandler::MessageReceivedHandler, &cltMessageHandler, std::placeholders::_1),
+        messageBuilder,
+        settings);
+
+    std::vector<std::thread> senders;
+
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+        senders.emplace_back([&]() {
+            for (size_t i = 0; i < messagesPerThread; ++i)
+            {
+                EXPECT_TRUE(client.SendMessageToServerAsync(messageToSend, 666));
+            }
+        });
+    }
+
+    for (auto& sender : senders)
+    {
+        sender.join();
+    }
+
+    EXPECT_TRUE(allReceivedEvent.WaitForTime(5000));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(numGood, numThreads * messagesPerThread);
+    EXPECT_EQ(numBad, 0U);
+}
+
 TEST(AsioTest, testCase_TestTypedSync)
 {
     MessageBuilder    messageBuilder;
@@ -1429,6 +2345,119 @@ TEST(AsioTest, testCase_TestSimpleAsync_Large)
     }
 }
 
+TEST(AsioTest, testCase_TestSimpleAsync_Large_DirectToBody)
+{
+    SimpleTcpSettings settings;
+    settings.connSettings.readMode          = eReadMode::directToBody;
+    settings.connSettings.maxDirectBodySize = sizeof(double) * 625000 + 1024;
+    settings.memPoolMsgCount                = 4;
+    settings.recvPoolMsgSize                = sizeof(double) * 625000 + 1024;
+
+    MessageDispatcher serverDispatcher;
+    SimpleTcpServer   server(
+        22222,
+        std::bind(&MessageDispatcher::DispatchMessage, &serverDispatcher, std::placeholders::_1),
+        settings);
+
+    connection_t      serverConn = std::make_pair(ADDRESS_ONE, 22222);
+    MessageDispatcher clientDispatcher;
+    SimpleTcpClient   client(
+        serverConn,
+        std::bind(&MessageDispatcher::DispatchMessage, &clientDispatcher, std::placeholders::_1),
+        settings);
+
+    MyMessage messageToSend;
+    messageToSend.FillMessage(625000);
+
+    for (size_t i = 0; i < 20; ++i)
+    {
+        client.SendMessageToServerAsync(messageToSend, 666);
+        serverDispatcher.WaitForMessage(3000);
+
+        MyMessage receivedMessage = serverDispatcher.Message();
+        EXPECT_TRUE(receivedMessage == messageToSend);
+
+        MessageHeader  header      = serverDispatcher.Header();
+        connection_t respAddress = std::make_pair(
+            header.responseAddress, header.responsePort);
+        server.SendMessageToClientAsync(messageToSend, respAddress, 666);
+        clientDispatcher.WaitForMessage(3000);
+
+        receivedMessage = clientDispatcher.Message();
+        EXPECT_TRUE(receivedMessage == messageToSend);
+
+        header      = clientDispatcher.Header();
+        respAddress = std::make_pair(header.responseAddress,
+                                     header.responsePort);
+
+        EXPECT_TRUE(respAddress == serverConn);
+    }
+}
+
+TEST(AsioTest, testCase_TestSimpleAsync_DirectToBody_OversizedHeader)
+{
+    const size_t maxDirectBodySize = 65536;
+
+    // A header claiming a huge body must not get a buffer sized from it.
+    messages::MessageHandler handler(
+        [](default_received_message_ptr_t const&) {}, DEFAULT_MAGIC_STRING, 4, 1024,
+        maxDirectBodySize);
+    MessageHeader     craftedHeader;
+    BodyReceiveTarget target;
+    craftedHeader.totalLength = std::numeric_limits<uint32_t>::max();
+    auto const headerSpan =
+        char_buf_cspan_t(reinterpret_cast<const char*>(&craftedHeader), sizeof(craftedHeader));
+    EXPECT_FALSE(handler.PrepareBodyReceive(headerSpan, target));
+    EXPECT_TRUE(target.body.empty());
+
+    craftedHeader.totalLength = static_cast<uint32_t>(sizeof(craftedHeader) + maxDirectBodySize);
+    EXPECT_TRUE(handler.PrepareBodyReceive(headerSpan, target));
+    EXPECT_EQ(target.body.size(), maxDirectBodySize);
+
+    SimpleTcpSettings settings;
+    settings.connSettings.readMode          = eReadMode::directToBody;
+    settings.connSettings.maxDirectBodySize = maxDirectBodySize;
+    settings.memPoolMsgCount                = 4;
+
+    MessageDispatcher serverDispatcher;
+    SimpleTcpServer   server(
+        22222,
+        std::bind(&MessageDispatcher::DispatchMessage, &serverDispatcher, std::placeholders::_1),
+        settings);
+
+    connection_t serverConn = std::make_pair(ADDRESS_ONE, 22222);
+
+    {
+        // Send the crafted header followed by a little data, the server must just wait for
+        // the rest of the body rather than allocating it.
+        TcpClient rawClient(
+            serverConn, [](char_buf_cspan_t) { return size_t{0}; }, [](char_buf_cspan_t) {});
+        craftedHeader.totalLength = std::numeric_limits<uint32_t>::max();
+        craftedHeader.messageId   = 666;
+        char_buffer_t crafted(reinterpret_cast<const char*>(&craftedHeader),
+                              reinterpret_cast<const char*>(&craftedHeader) + sizeof(craftedHeader));
+        crafted.resize(crafted.size() + 1000, 'x');
+        EXPECT_TRUE(rawClient.SendMessageToServerSync(crafted));
+        EXPECT_FALSE(serverDispatcher.WaitForMessage(200));
+    }
+
+    // Bodies larger than the limit are still received, just read in chunks.
+    MessageDispatcher clientDispatcher;
+    SimpleTcpClient   client(
+        serverConn,
+        std::bind(&MessageDispatcher::DispatchMessage, &clientDispatcher, std::placeholders::_1),
+        settings);
+
+    for (size_t size : {100, 625000})
+    {
+        MyMessage messageToSend;
+        messageToSend.FillMessage(size);
+        EXPECT_TRUE(client.SendMessageToServerAsync(messageToSend, 666));
+        EXPECT_TRUE(serverDispatcher.WaitForMessage(3000));
+        EXPECT_TRUE(serverDispatcher.Message() == messageToSend);
+    }
+}
+
 TEST(AsioTest, testCase_TestSimpleSync_Large)
 {
     MessageDispatcher serverDispatcher;
@@ -1,9 +1,18 @@
 #ifndef DISABLE_DEBUGLOG_TESTS
 
 #include <ostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <string_view>
+#include <thread>
+#include <vector>
 #include "DebugLog/DebugLogging.h"
 #include "FileUtils/SelectFileSystemLibrary.hpp"
 #include "gtest/gtest.h"
+#include "gtest_cout.h"
 
 // ****************************************************************************
 // DebugLogTest Fixture
@@ -21,6 +30,14 @@ protected:
     }
 };
 
+int g_evaluationCount = 0;
+
+std::string CountedMessage(const std::string& message)
+{
+    ++g_evaluationCount;
+    return message;
+}
+
 } // End of unnamed namespace.
 
 // ****************************************************************************
@@ -773,4 +790,727 @@ TEST_F(DebugLogTest, testCase_DebugLog10)
     filesys::remove("test_log.txt");
 }
 
+TEST_F(DebugLogTest, testCase_DebugLog11)
+{
+    g_evaluationCount = 0;
+
+    {
+        core_lib::log::DebugLog<core_lib::log::DefaultLogFormat> dl("1.0.0.0", "", "test_log");
+        dl.AddLogMsgLevelFilter(core_lib::log::eLogMessageLevel::debug);
+        dl.AddLogMsgLevelFilter(core_lib::log::eLogMessageLevel::warning);
+        EXPECT_FALSE(dl.IsLogMsgLevelEnabled(core_lib::log::eLogMessageLevel::debug));
+        EXPECT_TRUE(dl.IsLogMsgLevelEnabled(core_lib::log::eLogMessageLevel::info));
+        EXPECT_FALSE(dl.IsLogMsgLevelEnabled(core_lib::log::eLogMessageLevel::warning));
+        DEBUG_LOG_EX_DEBUG(dl, CountedMessage("Message 1"));
+        DEBUG_LOG_CON_EX_WARNING(dl, CountedMessage("Message 2"));
+        DEBUG_LOG_BOTH_EX_DEBUG(dl, CountedMessage("Message 3"));
+        EXPECT_EQ(g_evaluationCount, 0);
+        dl.RemoveLogMsgLevelFilter(core_lib::log::eLogMessageLevel::warning);
+        EXPECT_TRUE(dl.IsLogMsgLevelEnabled(core_lib::log::eLogMessageLevel::warning));
+        DEBUG_LOG_EX_WARNING(dl, CountedMessage("Message 4"));
+        DEBUG_LOG_EX_DEBUG(dl, CountedMessage("Message 5"));
+        EXPECT_EQ(g_evaluationCount, 1);
+        dl.ClearLogMsgLevelFilters();
+        DEBUG_LOG_EX_DEBUG(dl, CountedMessage("Message 6"));
+        EXPECT_EQ(g_evaluationCount, 2);
+    }
+
+    std::ifstream ifs("test_log.txt");
+    EXPECT_TRUE(ifs.is_open());
+    std::string line;
+    size_t      lineCount = 0;
+
+    while (!ifs.eof())
+    {
+        std::getline(ifs, line);
+
+        switch (++lineCount)
+        {
+        case 1:
+            EXPECT_TRUE(line.substr(21, line.size() - 21) == "| \"DEBUG LOG STARTED\"");
+            break;
+        case 2:
+            EXPECT_TRUE(line.substr(21, line.size() - 21) == "| \"Software Version 1.0.0.0\"");
+            break;
+        case 3:
+            EXPECT_TRUE(line.substr(31, 15) == "| \"Message 4\" |");
+            EXPECT_NE(line.find(BOOST_CURRENT_FUNCTION), std::string::npos);
+            break;
+        case 4:
+            EXPECT_TRUE(line.substr(29, 15) == "| \"Message 6\" |");
+            break;
+        case 5:
+            EXPECT_TRUE(line.substr(21, line.size() - 21) == "| \"DEBUG LOG STOPPED\"");
+            break;
+        case 6:
+            EXPECT_TRUE(line.compare("") == 0);
+            break;
+        default:
+            FAIL() << "Too many lines";
+        }
+    }
+
+    ifs.close();
+
+    if (lineCount < 6)
+    {
+        FAIL() << "Too many lines";
+    }
+
+    filesys::remove("test_log.txt");
+}
+
+TEST_F(DebugLogTest, testCase_DebugLog12)
+{
+    core_lib::log::DebugLog<core_lib::log::DefaultLogFormat> dl("1.0.0.0", "", "test_log");
+    dl.AddLogMsgLevelFilter(core_lib::log::eLogMessageLevel::debug);
+
+    const int numMessages = 1000000;
+    g_evaluationCount     = 0;
+    auto start            = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < numMessages; ++i)
+    {
+        DEBUG_LOG_EX_DEBUG(dl, "Message " << i << " " << CountedMessage("filtered"));
+    }
+
+    const auto filtered =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                             start)
+            .count();
+
+    EXPECT_EQ(g_evaluationCount, 0);
+    GOUT("filtered DEBUG_LOG_EX x " << numMessages << ": " << filtered / 1000 << " us, "
+                                    << static_cast<double>(filtered) / numMessages
+                                    << " ns per call");
+}
+
+TEST_F(DebugLogTest, testCase_DebugLog13)
+{
+    enum class eColour
+    {
+        red,
+        green
+    };
+
+    g_evaluationCount     = 0;
+    const int numThreads  = 4;
+    const int numMessages = 250;
+
+    {
+        core_lib::log::DebugLog<core_lib::log::DefaultLogFormat> dl("1.0.0.0", "", "test_log");
+        DEBUG_LOG_DEFERRED(dl,
+                           LOG_LEVEL_INFO,
+                           "int {} double {} str {} view {} cstr {} enum {}",
+                           42,
+                           1.5,
+                           std::string("hello"),
+                           std::string_view("world"),
+                           "literal",
+                           eColour::green);
+        DEBUG_LOG_DEFERRED(dl, LOG_LEVEL_WARNING, "no args");
+        dl.AddLogMsgLevelFilter(core_lib::log::eLogMessageLevel::debug);
+        DEBUG_LOG_DEFERRED(dl, LOG_LEVEL_DEBUG, "filtered {}", CountedMessage("x"));
+
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < numThreads; ++t)
+        {
+            threads.emplace_back([&dl, t, numMessages]() {
+                for (int i = 0; i < numMessages; ++i)
+                {
+                    DEBUG_LOG_DEFERRED(dl, LOG_LEVEL_INFO, "thread {} message {}", t, i);
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    EXPECT_EQ(g_evaluationCount, 0);
+
+    std::ifstream ifs("test_log.txt");
+    EXPECT_TRUE(ifs.is_open());
+    std::string line;
+    size_t           lineCount   = 0;
+    int              threadLines = 0;
+    std::vector<int> lastMessage(numThreads, -1);
+
+    while (std::getline(ifs, line))
+    {
+        switch (++lineCount)
+        {
+        case 1:
+            EXPECT_TRUE(line.substr(21, line.size() - 21) == "| \"DEBUG LOG STARTED\"");
+            break;
+        case 2:
+            EXPECT_TRUE(line.substr(21, line.size() - 21) == "| \"Software Version 1.0.0.0\"");
+            break;
+        case 3:
+            EXPECT_TRUE(line.substr(28, 64) ==
+                        "| \"int 42 double 1.5 str hello view world cstr literal enum 1\" |");
+            EXPECT_NE(line.find(BOOST_CURRENT_FUNCTION), std::string::npos);
+            break;
+        case 4:
+            EXPECT_TRUE(line.substr(31, 13) == "| \"no args\" |");
+            break;
+        default:
+        {
+            int t = -1;
+            int i = -1;
+
+            if (std::sscanf(line.c_str() + 28, "| \"thread %d message %d\"", &t, &i) == 2)
+            {
+                ASSERT_TRUE((t >= 0) && (t < numThreads));
+                EXPECT_EQ(i, lastMessage[t] + 1);
+                lastMessage[t] = i;
+                ++threadLines;
+            }
+            else
+            {
+                EXPECT_TRUE(line.substr(21, line.size() - 21) == "| \"DEBUG LOG STOPPED\"");
+            }
+
+            break;
+        }
+        }
+    }
+
+    ifs.close();
+    EXPECT_EQ(threadLines, numThreads * numMessages);
+    EXPECT_EQ(lineCount, static_cast<size_t>(numThreads * numMessages + 5));
+    filesys::remove("test_log.txt");
+}
+
+TEST_F(DebugLogTest, testCase_DebugLog14)
+{
+    const int numMessages = 100000;
+    long long formatted   = 0;
+    long long deferred    = 0;
+
+    {
+        core_lib::log::DebugLog<core_lib::log::DefaultLogFormat> dl(
+            "1.0.0.0", "", "test_log", 64 * core_lib::log::BYTES_IN_MEBIBYTE);
+        dl.SetDeferredRingCapacity(16 * core_lib::log::BYTES_IN_MEBIBYTE);
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < numMessages; ++i)
+        {
+            DEBUG_LOG_EX_INFO(dl, "value " << i << " of " << 3.25);
+        }
+
+        formatted =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                 start)
+                .count();
+        start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < numMessages; ++i)
+        {
+            DEBUG_LOG_DEFERRED(dl, LOG_LEVEL_INFO, "value {} of {}", i, 3.25);
+        }
+
+        deferred =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                 start)
+                .count();
+    }
+
+    std::ifstream ifs("test_log.txt");
+    std::string   line;
+    size_t        lineCount = 0;
+
+    while (std::getline(ifs, line))
+    {
+        ++lineCount;
+        EXPECT_EQ(line.find("dropped"), std::string::npos);
+    }
+
+    ifs.close();
+    EXPECT_EQ(lineCount, static_cast<size_t>(2 * numMessages + 3));
+    GOUT("DEBUG_LOG_EX x " << numMessages << ": "
+                           << static_cast<double>(formatted) / numMessages
+                           << " ns per call, DEBUG_LOG_DEFERRED: "
+                           << static_cast<double>(deferred) / numMessages << " ns per call");
+    filesys::remove("test_log.txt");
+}
+
+TEST_F(DebugLogTest, testCase_DebugLog15)
+{
+    const int numMessages = 1000;
+
+    {
+        core_lib::log::DebugLog<core_lib::log::DefaultLogFormat> dl("1.0.0.0", "", "test_log");
+
+        core_lib::log::LogFlushPolicy flushPolicy;
+        flushPolicy.maxMessages  = 0;
+        flushPolicy.maxDelay     = std::chrono::milliseconds(0);
+        flushPolicy.flushOnError = false;
+        dl.SetFlushPolicy(flushPolicy);
+
+        auto const policy = dl.FlushPolicy();
+        EXPECT_EQ(policy.maxMessages, 0U);
+        EXPECT_EQ(policy.maxDelay.count(), 0);
+        EXPECT_FALSE(policy.flushOnError);
+
+        for (int i = 0; i < numMessages; ++i)
+        {
+            DEBUG_LOG_EX_INFO(dl, "message " << i);
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+        // With no limits set the log must still be flushed once the queue drains.
+        std::ifstream ifs("test_log.txt");
+        std::string   line;
+        int           messageCount = 0;
+
+        while (std::getline(ifs, line))
+        {
+            if (line.find("message ") != std::string::npos)
+            {
+                ++messageCount;
+            }
+        }
+
+        EXPECT_EQ(messageCount, numMessages);
+    }
+
+    filesys::remove("test_log.txt");
+}
+
+TEST_F(DebugLogTest, testCase_DebugLog16)
+{
+    const int numMessages = 100000;
+
+    auto writeMessages = [numMessages](const core_lib::log::LogFlushPolicy& flushPolicy) {
+        auto const start = std::chrono::steady_clock::now();
+
+        {
+            core_lib::log::DebugLog<core_lib::log::DefaultLogFormat> dl(
+                "1.0.0.0", "", "test_log", 64 * core_lib::log::BYTES_IN_MEBIBYTE);
+            dl.SetFlushPolicy(flushPolicy);
+
+            for (int i = 0; i < numMessages; ++i)
+            {
+                DEBUG_LOG_EX_INFO(dl, "value " << i << " of " << 3.25);
+            }
+        }
+
+        auto const elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+
+        std::ifstream ifs("test_log.txt");
+        std::string   line;
+        size_t        lineCount = 0;
+
+        while (std::getline(ifs, line))
+        {
+            ++lineCount;
+        }
+
+        ifs.close();
+        EXPECT_EQ(lineCount, static_cast<size_t>(numMessages + 3));
+        filesys::remove("test_log.txt");
+        return elapsed;
+    };
+
+    auto const flushEveryMessage = writeMessages(core_lib::log::LogFlushPolicy{});
+    auto const groupCommit =
+        writeMessages(core_lib::log::LogFlushPolicy{1000, std::chrono::milliseconds(100), true});
+
+    GOUT("Write " << numMessages << " messages, flush every message: " << flushEveryMessage
+                  << " ms, flush every 1000 messages or 100 ms: " << groupCommit << " ms");
+}
+
+TEST_F(DebugLogTest, testCase_DebugLog17)
+{
+    using core_lib::log::eTimeStampPrecision;
+    using std::chrono::system_clock;
+
+    core_lib::log::DefaultLogFormat dlf;
+    std::thread::id                 noThread;
+
+    // Start 10 seconds before the end of a minute so the cached minute is exercised.
+    auto const baseTime = (system_clock::to_time_t(system_clock::now()) / 60) * 60 + 50;
+
+    auto format = [&](time_t wholeSeconds, bool utcTimeStamps, bool tzOffset,
+                      eTimeStampPrecision precision) {
+        std::ostringstream ss;
+        dlf(ss,
+            system_clock::from_time_t(wholeSeconds) + std::chrono::microseconds(123456),
+            "message",
+            "Info",
+            "",
+            "",
+            -1,
+            noThread,
+            utcTimeStamps,
+            tzOffset,
+            precision);
+        return ss.str();
+    };
+
+    auto expected = [](time_t wholeSeconds, bool utcTimeStamps, bool tzOffset,
+                       const char* fraction) {
+        std::ostringstream ss;
+        auto const         calendarTime =
+            utcTimeStamps ? *std::gmtime(&wholeSeconds) : *std::localtime(&wholeSeconds);
+        ss << std::put_time(&calendarTime, "%Y %b %d %H:%M:%S") << fraction;
+
+        if (tzOffset && !utcTimeStamps)
+        {
+            ss << std::put_time(&calendarTime, "%z");
+        }
+
+        ss << " | Info | \"message\"\n";
+        return ss.str();
+    };
+
+    for (int offset : {0, 1, 9, 10, 11, 75})
+    {
+        auto const t = baseTime + offset;
+        EXPECT_EQ(format(t, true, false, eTimeStampPrecision::seconds),
+                  expected(t, true, false, ""));
+        EXPECT_EQ(format(t, true, false, eTimeStampPrecision::milliseconds),
+                  expected(t, true, false, ".123"));
+        EXPECT_EQ(format(t, false, true, eTimeStampPrecision::microseconds),
+                  expected(t, false, true, ".123456"));
+        EXPECT_EQ(format(t, false, false, eTimeStampPrecision::milliseconds),
+                  expected(t, false, false, ".123"));
+    }
+
+    // The epoch means no time stamp.
+    std::ostringstream ss;
+    dlf(ss, core_lib::log::log_time_point_t{}, "message", "Info", false, false,
+        eTimeStampPrecision::microseconds);
+    EXPECT_EQ(ss.str(), "Info | \"message\"\n");
+
+    {
+        core_lib::log::DebugLog<core_lib::log::DefaultLogFormat> dl("1.0.0.0", "", "test_log");
+        EXPECT_EQ(dl.TimeStampPrecision(), eTimeStampPrecision::seconds);
+        dl.SetTimeStampPrecision(eTimeStampPrecision::microseconds);
+        EXPECT_EQ(dl.TimeStampPrecision(), eTimeStampPrecision::microseconds);
+        DEBUG_LOG_EX_INFO(dl, "precise");
+        DEBUG_LOG_DEFERRED(dl, LOG_LEVEL_INFO, "deferred {}", 1);
+    }
+
+    std::ifstream ifs("test_log.txt");
+    std::string   line;
+    int           preciseCount = 0;
+
+    while (std::getline(ifs, line))
+    {
+        if (line.find("precise") == std::string::npos &&
+            line.find("deferred 1") == std::string::npos)
+        {
+            continue;
+        }
+
+        // "YYYY Mon DD HH:MM:SS.uuuuuu | Info | ..."
+        int hours = 0, minutes = 0, seconds = 0, micros = 0, length = 0;
+        EXPECT_EQ(std::sscanf(line.c_str() + 12,
+                              "%2d:%2d:%2d.%6d%n",
+                              &hours,
+                              &minutes,
+                              &seconds,
+                              &micros,
+                              &length),
+                  4);
+        EXPECT_EQ(length, 15);
+        EXPECT_EQ(line.substr(27, 9), " | Info |");
+        ++preciseCount;
+    }
+
+    ifs.close();
+    EXPECT_EQ(preciseCount, 2);
+    filesys::remove("test_log.txt");
+}
+
+TEST_F(DebugLogTest, testCase_DebugLog18)
+{
+    using std::chrono::system_clock;
+
+    const int numMessages = 100000;
+
+    core_lib::log::DefaultLogFormat dlf;
+    std::ostringstream              ss;
+    auto const                      now = system_clock::now();
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < numMessages; ++i)
+    {
+        ss.str("");
+        dlf(ss,
+            now + std::chrono::microseconds(i * 10),
+            "message",
+            "Info",
+            false,
+            false,
+            core_lib::log::eTimeStampPrecision::microseconds);
+    }
+
+    auto const cached = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+    auto const nowSeconds = system_clock::to_time_t(now);
+    start                 = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < numMessages; ++i)
+    {
+        ss.str("");
+        ss << std::put_time(std::localtime(&nowSeconds), "%Y %b %d %H:%M:%S")
+           << " | Info | \"message\"\n";
+    }
+
+    auto const putTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+
+    GOUT("Format " << numMessages << " console lines, cached microsecond time stamps: "
+                   << static_cast<double>(cached) / numMessages
+                   << " ns per line, localtime and put_time: "
+                   << static_cast<double>(putTime) / numMessages << " ns per line");
+}
+
+TEST_F(DebugLogTest, testCase_DebugLog19)
+{
+    const long maxLogSize  = 4096;
+    const int  numMessages = 500;
+
+    auto lastMessageNo = [](const std::string& filePath) {
+        std::ifstream ifs(filePath);
+        std::string   line;
+        int           messageNo = -1;
+
+        while (std::getline(ifs, line))
+        {
+            auto const pos = line.find("\"message ");
+
+            if (pos != std::string::npos)
+            {
+                messageNo = std::stoi(line.substr(pos + 9));
+            }
+        }
+
+        return messageNo;
+    };
+
+    auto firstMessageNo = [](const std::string& filePath) {
+        std::ifstream ifs(filePath);
+        std::string   line;
+
+        while (std::getline(ifs, line))
+        {
+            auto const pos = line.find("\"message ");
+
+            if (pos != std::string::npos)
+            {
+                return std::stoi(line.substr(pos + 9));
+            }
+        }
+
+        return -1;
+    };
+
+    {
+        core_lib::log::DebugLog<core_lib::log::DefaultLogFormat> dl(
+            "1.0.0.0", "", "test_log", maxLogSize);
+
+        core_lib::log::LogRotationPolicy rotationPolicy;
+        rotationPolicy.generations = 2;
+        dl.SetRotationPolicy(rotationPolicy);
+        EXPECT_EQ(dl.RotationPolicy().generations, 2U);
+        EXPECT_EQ(dl.RotationPolicy().compressedExt, ".gz");
+
+        for (int i = 0; i < numMessages; ++i)
+        {
+            DEBUG_LOG_EX_INFO(dl, "message " << i);
+        }
+    }
+
+    EXPECT_TRUE(filesys::exists("test_log_old.txt"));
+    EXPECT_TRUE(filesys::exists("test_log_old_2.txt"));
+    EXPECT_FALSE(filesys::exists("test_log_old_3.txt"));
+    EXPECT_LE(filesys::file_size("test_log.txt"), static_cast<std::uintmax_t>(maxLogSize));
+    EXPECT_LE(filesys::file_size("test_log_old.txt"), static_cast<std::uintmax_t>(maxLogSize));
+
+    // No messages lost across the renames.
+    EXPECT_EQ(lastMessageNo("test_log.txt"), numMessages - 1);
+    EXPECT_EQ(firstMessageNo("test_log.txt"), lastMessageNo("test_log_old.txt") + 1);
+    EXPECT_EQ(firstMessageNo("test_log_old.txt"), lastMessageNo("test_log_old_2.txt") + 1);
+
+    filesys::remove("test_log.txt");
+    filesys::remove("test_log_old.txt");
+    filesys::remove("test_log_old_2.txt");
+
+    std::atomic<int> compressedCount{0};
+
+    {
+        core_lib::log::DebugLog<core_lib::log::DefaultLogFormat> dl(
+            "1.0.0.0", "", "test_log", maxLogSize);
+
+        core_lib::log::LogRotationPolicy rotationPolicy;
+        rotationPolicy.generations   = 3;
+        rotationPolicy.compressedExt = ".cmp";
+        rotationPolicy.compressor    = [&compressedCount](const std::string& filePath,
+                                                       const std::string& compressedFilePath) {
+            // Stand in for a real compressor.
+            filesys::copy_file(filePath, compressedFilePath);
+            ++compressedCount;
+            return true;
+        };
+        dl.SetRotationPolicy(rotationPolicy);
+
+        for (int i = 0; i < numMessages; ++i)
+        {
+            DEBUG_LOG_EX_INFO(dl, "message " << i);
+        }
+    }
+
+    EXPECT_GE(compressedCount, 3);
+    EXPECT_FALSE(filesys::exists("test_log_old.txt"));
+    EXPECT_FALSE(filesys::exists("test_log_old_2.txt"));
+    EXPECT_FALSE(filesys::exists("test_log_old_3.txt"));
+    EXPECT_TRUE(filesys::exists("test_log_old.txt.cmp"));
+    EXPECT_TRUE(filesys::exists("test_log_old_2.txt.cmp"));
+    EXPECT_TRUE(filesys::exists("test_log_old_3.txt.cmp"));
+    EXPECT_FALSE(filesys::exists("test_log_old_4.txt.cmp"));
+    EXPECT_EQ(firstMessageNo("test_log.txt"), lastMessageNo("test_log_old.txt.cmp") + 1);
+
+    filesys::remove("test_log.txt");
+    filesys::remove("test_log_old.txt.cmp");
+    filesys::remove("test_log_old_2.txt.cmp");
+    filesys::remove("test_log_old_3.txt.cmp");
+}
+
+TEST_F(DebugLogTest, testCase_DebugLog20)
+{
+    {
+        core_lib::log::DebugLog<core_lib::log::DefaultLogFormat> dl("1.0.0.0", "", "test_log");
+
+        core_lib::log::LogRotationPolicy rotationPolicy;
+        rotationPolicy.maxAge = std::chrono::seconds(1);
+        dl.SetRotationPolicy(rotationPolicy);
+
+        DEBUG_LOG_EX_INFO(dl, "before rotation");
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+        DEBUG_LOG_EX_INFO(dl, "after rotation");
+    }
+
+    auto contains = [](const std::string& filePath, const std::string& text) {
+        std::ifstream ifs(filePath);
+        std::string   line;
+
+        while (std::getline(ifs, line))
+        {
+            if (line.find(text) != std::string::npos)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    EXPECT_TRUE(contains("test_log_old.txt", "before rotation"));
+    EXPECT_FALSE(contains("test_log_old.txt", "after rotation"));
+    EXPECT_TRUE(contains("test_log.txt", "after rotation"));
+    EXPECT_FALSE(contains("test_log.txt", "before rotation"));
+
+    filesys::remove("test_log.txt");
+    filesys::remove("test_log_old.txt");
+}
+
+TEST_F(DebugLogTest, testCase_DebugLog21)
+{
+    {
+        core_lib::log::DebugLog<core_lib::log::DefaultLogFormat> dl("1.0.0.0", "", "test_log");
+
+        std::string file     = "transient_file.cpp";
+        std::string function = "TransientFunction";
+        dl.AddLogMessage("Message 1",
+                         file.c_str(),
+                         function.c_str(),
+                         __LINE__,
+                         core_lib::log::eLogMessageLevel::info);
+
+        // Overwrite the buffers before the log thread has a chance to write the message.
+        std::fill(file.begin(), file.end(), 'x');
+        std::fill(function.begin(), function.end(), 'x');
+    }
+
+    std::ifstream ifs("test_log.txt");
+    std::string   text((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    ifs.close();
+
+    EXPECT_NE(text.find("File = transient_file.cpp"), std::string::npos);
+    EXPECT_NE(text.find("Function = TransientFunction"), std::string::npos);
+
+    filesys::remove("test_log.txt");
+}
+
+TEST_F(DebugLogTest, testCase_DeferredLogRing)
+{
+    using core_lib::log::dl_private::DeferredLogRing;
+    using core_lib::log::dl_private::DeferredLogRecord;
+    using core_lib::log::dl_private::EncodeDeferredLogRecord;
+
+    using core_lib::log::DeferredLogDescriptor;
+
+    static constexpr DeferredLogDescriptor descriptor{__FILE__,
+                                                      BOOST_CURRENT_FUNCTION,
+                                                      __LINE__,
+                                                      LOG_LEVEL_INFO,
+                                                      core_lib::log::eMsgTarget::file,
+                                                      "record {} {}"};
+
+    DeferredLogRing ring(1);
+    EXPECT_EQ(ring.Capacity(), DeferredLogRing::MIN_CAPACITY);
+    EXPECT_EQ(ring.Reserve(DeferredLogRing::MIN_CAPACITY), nullptr);
+
+    // Fill the ring, then drain part of it so later records wrap round.
+    int numRecords = 0;
+
+    while (EncodeDeferredLogRecord(ring, descriptor, numRecords, std::string(100, 'x')))
+    {
+        ++numRecords;
+    }
+
+    ring.CountDropped();
+    EXPECT_GT(numRecords, 0);
+
+    std::vector<std::string> messages;
+    auto onRecord = [&messages](const DeferredLogRecord& record, const char* args) {
+        std::ostringstream os;
+        record.decoder(os, record.descriptor->format, args);
+        messages.emplace_back(os.str());
+    };
+
+    EXPECT_EQ(ring.Drain(onRecord), 1U);
+    EXPECT_EQ(messages.size(), static_cast<size_t>(numRecords));
+    EXPECT_EQ(messages.back(),
+              "record " + std::to_string(numRecords - 1) + " " + std::string(100, 'x'));
+    messages.clear();
+
+    for (int i = 0; i < numRecords; ++i)
+    {
+        EXPECT_TRUE(EncodeDeferredLogRecord(ring, descriptor, i, "y"));
+    }
+
+    EXPECT_EQ(ring.Drain(onRecord), 0U);
+    ASSERT_EQ(messages.size(), static_cast<size_t>(numRecords));
+
+    for (int i = 0; i < numRecords; ++i)
+    {
+        EXPECT_EQ(messages[i], "record " + std::to_string(i) + " y");
+    }
+}
+
 #endif // DISABLE_DEBUGLOG_TESTS
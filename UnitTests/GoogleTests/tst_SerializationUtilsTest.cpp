@@ -235,4 +235,48 @@ TEST(SerializationUtilsTest, testCase_SerializeObjectMessagePack)
     EXPECT_EQ(objectOut, objectIn);
 }
 
+TEST(SerializationUtilsTest, testCase_AppendObjectPortBinArch)
+{
+    using namespace core_lib::serialize;
+    MyObject objectIn{};
+    objectIn.Fred(10.0);
+    objectIn.Harry("jnkjn");
+    const char_vector_t prefix{'a', 'b', 'c', 'd'};
+    char_vector_t       charVector{prefix};
+    AppendToCharVector(objectIn, charVector);
+
+    EXPECT_TRUE(std::equal(prefix.begin(), prefix.end(), charVector.begin()));
+    EXPECT_EQ(charVector.size(), prefix.size() + ToCharVector(objectIn).size());
+
+    auto objectOut = ToObject<MyObject>(char_cspan_buf_t(charVector).subspan(prefix.size()));
+
+    EXPECT_EQ(objectOut, objectIn);
+}
+
+TEST(SerializationUtilsTest, testCase_AppendObjectXmlArchAndMessagePack)
+{
+    using namespace core_lib::serialize;
+    MyObject objectIn{};
+    objectIn.Harry("jnkjn");
+    const char_vector_t prefix(16, 'x');
+    char_vector_t       xmlVector{prefix};
+    AppendToCharVector<MyObject, archives::out_xml_t>(objectIn, xmlVector);
+    auto xmlOut = ToObject<MyObject, archives::in_xml_t>(
+        char_cspan_buf_t(xmlVector).subspan(prefix.size()));
+
+    EXPECT_EQ(xmlOut, objectIn);
+
+    char_vector_t msgpackVector{prefix};
+    AppendToCharVector<MyObject, archives::out_msgpack_t>(objectIn, msgpackVector);
+
+    const auto msgpackLength = ToCharVector<MyObject, archives::out_msgpack_t>(objectIn).size();
+
+    EXPECT_EQ(msgpackVector.size(), prefix.size() + msgpackLength);
+
+    auto msgpackOut = ToObject<MyObject, archives::in_msgpack_t>(
+        char_cspan_buf_t(msgpackVector).subspan(prefix.size()));
+
+    EXPECT_EQ(msgpackOut, objectIn);
+}
+
 #endif // DISABLE_SERIALIZATION_TESTS
@@ -8,15 +8,22 @@
 #include <set>
 #include <limits>
 #include <algorithm>
+#include <iterator>
 #include <future>
 #include <cstring>
 #include "Threads/SyncEvent.h"
 #include "Threads/ThreadBase.h"
 #include "Threads/ThreadGroup.h"
 #include "Threads/ConcurrentQueue.h"
+#include "Threads/RingQueue.h"
+#include "Threads/BoundedBuffer.h"
 #include "Threads/MessageQueueThread.h"
 #include "Asio/IoContextThreadGroup.h"
 #include "Threads/DeadlineTimer.h"
+#include "Threads/TimerService.h"
+#include "Threads/EventThread.h"
+#include "Threads/ThreadPool.h"
+#include "Threads/ThreadRunner.h"
 #include "gtest/gtest.h"
 #include "gtest_cout.h"
 
@@ -394,9 +401,19 @@ public:
         }
     };
 
-    MessageQueueThreadTest()
-        : m_mqt(std::bind(&MessageQueueThreadTest::MessageDecoder, std::placeholders::_1))
+    explicit MessageQueueThreadTest(core_lib::threads::eQueueProcessingMode processingMode =
+                                        core_lib::threads::eQueueProcessingMode::singleMessage,
+                                    bool flatDispatch = false)
+        : m_mqt(std::bind(&MessageQueueThreadTest::MessageDecoder, std::placeholders::_1),
+                core_lib::threads::eOnDestroyOptions::ignoreRemainingItems,
+                {},
+                processingMode)
     {
+        if (flatDispatch)
+        {
+            m_mqt.EnableFlatDispatch(2);
+        }
+
         m_mqt.RegisterMessageHandler(
             M1, std::bind(&MessageQueueThreadTest::MessageHandler, this, std::placeholders::_1));
         m_mqt.RegisterMessageHandler(
@@ -791,6 +808,136 @@ TEST_F(ThreadsTest, testCase_SyncEvent7)
     EXPECT_TRUE(helper.GetEventSignalledState(tId));
 }
 
+TEST_F(ThreadsTest, testCase_SyncEvent8)
+{
+    // Mix of untimed and timed waiters must all be released by one signal.
+    core_lib::threads::SyncEvent event(core_lib::threads::eNotifyType::signalAllThreads,
+                                       core_lib::threads::eResetCondition::manualReset,
+                                       core_lib::threads::eIntialCondition::notSignalled);
+    std::atomic<int>             released{0};
+    core_lib::threads::ThreadGroup tg;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        tg.CreateThread([&event, &released]() {
+            event.Wait();
+            ++released;
+        });
+        tg.CreateThread([&event, &released]() {
+            if (event.WaitForTime(10000))
+            {
+                ++released;
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(released.load(), 0);
+    event.Signal();
+    tg.JoinAll();
+    EXPECT_EQ(released.load(), 8);
+
+    // External conditions still use the mutex based path.
+    bool                                    flag = false;
+    core_lib::threads::SyncEvent::Condition condition{[&flag] { return flag; },
+                                                      [&flag](bool value) { flag = value; }};
+    core_lib::threads::SyncEvent            external(core_lib::threads::eNotifyType::signalOneThread,
+                                          core_lib::threads::eResetCondition::autoReset,
+                                          core_lib::threads::eIntialCondition::signalled,
+                                          &condition);
+    EXPECT_TRUE(flag);
+    EXPECT_TRUE(external.WaitForTime(0));
+    EXPECT_FALSE(flag);
+    EXPECT_FALSE(external.WaitForTime(1));
+    external.Signal();
+    EXPECT_TRUE(flag);
+}
+
+TEST(SyncEventStressTest, testCase_SyncEvent9)
+{
+    const int numRoundTrips = 100000;
+
+    auto pingPong = [numRoundTrips](core_lib::threads::SyncEvent& ping,
+                                    core_lib::threads::SyncEvent& pong) {
+        std::thread t([&]() {
+            for (int i = 0; i < numRoundTrips; ++i)
+            {
+                ping.Wait();
+                pong.Signal();
+            }
+        });
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < numRoundTrips; ++i)
+        {
+            ping.Signal();
+            pong.Wait();
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        t.join();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() /
+               numRoundTrips;
+    };
+
+    // Events with an external condition take the mutex and condition variable
+    // on every operation, as all events did before the atomic fast path.
+    bool                                    pingFlag = false;
+    bool                                    pongFlag = false;
+    core_lib::threads::SyncEvent::Condition pingCondition{
+        [&pingFlag] { return pingFlag; }, [&pingFlag](bool value) { pingFlag = value; }};
+    core_lib::threads::SyncEvent::Condition pongCondition{
+        [&pongFlag] { return pongFlag; }, [&pongFlag](bool value) { pongFlag = value; }};
+    core_lib::threads::SyncEvent legacyPing(core_lib::threads::eNotifyType::signalOneThread,
+                                            core_lib::threads::eResetCondition::autoReset,
+                                            core_lib::threads::eIntialCondition::notSignalled,
+                                            &pingCondition);
+    core_lib::threads::SyncEvent legacyPong(core_lib::threads::eNotifyType::signalOneThread,
+                                            core_lib::threads::eResetCondition::autoReset,
+                                            core_lib::threads::eIntialCondition::notSignalled,
+                                            &pongCondition);
+    core_lib::threads::SyncEvent ping;
+    core_lib::threads::SyncEvent pong;
+
+    const auto legacyLatency = pingPong(legacyPing, legacyPong);
+    const auto atomicLatency = pingPong(ping, pong);
+
+    // Signalling with no waiters.
+    const int numSignals = 1000000;
+    auto      start      = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < numSignals; ++i)
+    {
+        legacyPing.Signal();
+    }
+
+    const auto legacySignal =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                             start)
+            .count();
+    start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < numSignals; ++i)
+    {
+        ping.Signal();
+    }
+
+    const auto atomicSignal =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                             start)
+            .count();
+
+    GOUT("ping-pong round trip, mutex: " << legacyLatency << " ns, atomic: " << atomicLatency
+                                         << " ns");
+    GOUT("signal without waiters x " << numSignals << ", mutex: " << legacySignal / 1000
+                                     << " us, atomic: " << atomicSignal / 1000 << " us");
+
+    EXPECT_TRUE(ping.WaitForTime(0));
+    EXPECT_FALSE(ping.WaitForTime(0));
+    EXPECT_FALSE(pong.WaitForTime(0));
+}
+
 // ****************************************************************************
 // ThreadBase tests
 // ****************************************************************************
@@ -1251,6 +1398,254 @@ TEST(QueueStressTest, testCase_ConcurrentQueue11)
     }
 }
 
+TEST(QueueTest, testCase_RingQueue1)
+{
+    core_lib::threads::MpmcRingQueue<QueueMsg*> q(3);
+    EXPECT_EQ(q.Capacity(), 4U);
+    EXPECT_TRUE(q.Empty());
+
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(q.TryPush(CreateQueueMsgPtr(2, 666)));
+    }
+
+    QueueMsg* m = CreateQueueMsgPtr(2, 666);
+    EXPECT_FALSE(q.TryPush(m));
+    EXPECT_EQ(q.Size(), 4U);
+    delete m;
+
+    m = nullptr;
+    EXPECT_TRUE(q.Pop(m));
+    EXPECT_TRUE(m != nullptr);
+    EXPECT_TRUE(CheckQueueMsg(*m, 666));
+    delete m;
+
+    q.Clear(core_lib::threads::SingleItemDeleter<QueueMsg>());
+    EXPECT_TRUE(q.Empty());
+
+    int item{};
+    core_lib::threads::SpscRingQueue<int> sq(8);
+    EXPECT_FALSE(sq.TimedPop(10, item));
+    sq.BreakPopWait();
+    EXPECT_FALSE(sq.Pop(item));
+    sq.Push(42);
+    EXPECT_TRUE(sq.TimedPop(10, item));
+    EXPECT_EQ(item, 42);
+}
+
+template <typename Queue> void RingQueueStress(int producers, int consumers)
+{
+    const int      itemsPerProducer = 200000;
+    Queue          q(1024);
+    std::atomic<int64_t> total{0};
+    std::atomic<int>     popped{0};
+    const int      expectedCount = producers * itemsPerProducer;
+
+    std::vector<std::future<void>> futures;
+
+    for (int c = 0; c < consumers; ++c)
+    {
+        futures.push_back(std::async(std::launch::async, [&]() {
+            int item{};
+
+            while (q.Pop(item))
+            {
+                total += item;
+
+                if (++popped == expectedCount)
+                {
+                    for (int b = 0; b < consumers; ++b)
+                    {
+                        q.BreakPopWait();
+                    }
+                }
+            }
+        }));
+    }
+
+    for (int p = 0; p < producers; ++p)
+    {
+        futures.push_back(std::async(std::launch::async, [&]() {
+            for (int i = 1; i <= itemsPerProducer; ++i)
+            {
+                q.Push(i);
+            }
+        }));
+    }
+
+    for (auto& f : futures)
+    {
+        f.get();
+    }
+
+    const int64_t expectedTotal =
+        static_cast<int64_t>(producers) * itemsPerProducer * (itemsPerProducer + 1) / 2;
+    EXPECT_EQ(popped.load(), expectedCount);
+    EXPECT_EQ(total.load(), expectedTotal);
+    EXPECT_TRUE(q.Empty());
+}
+
+TEST(QueueTest, testCase_BoundedBuffer1)
+{
+    core_lib::threads::BoundedBuffer<std::unique_ptr<int>> buffer(4);
+    EXPECT_EQ(buffer.Capacity(), 4U);
+    EXPECT_TRUE(buffer.Empty());
+
+    std::unique_ptr<int> item;
+    EXPECT_FALSE(buffer.TryPopBack(item));
+    EXPECT_FALSE(buffer.TimedPopBack(10, item));
+
+    buffer.PushFront(std::make_unique<int>(1));
+    buffer.EmplaceFront(new int(2));
+    auto three = std::make_unique<int>(3);
+    EXPECT_TRUE(buffer.TryPushFront(std::move(three)));
+    EXPECT_FALSE(three);
+    EXPECT_TRUE(buffer.TimedPushFront(10, std::make_unique<int>(4)));
+    EXPECT_EQ(buffer.Size(), 4U);
+
+    auto five = std::make_unique<int>(5);
+    EXPECT_FALSE(buffer.TryPushFront(std::move(five)));
+    EXPECT_TRUE(five);
+    EXPECT_FALSE(buffer.TimedPushFront(10, std::move(five)));
+    EXPECT_TRUE(five);
+
+    buffer.PopBack(item);
+    EXPECT_EQ(*item, 1);
+    EXPECT_TRUE(buffer.TryPopBack(item));
+    EXPECT_EQ(*item, 2);
+
+    // Only two slots free so only two of the three items go in.
+    std::vector<std::unique_ptr<int>> in;
+    in.emplace_back(std::move(five));
+    in.emplace_back(std::make_unique<int>(6));
+    in.emplace_back(std::make_unique<int>(7));
+    EXPECT_EQ(buffer.PushFrontN(in.begin(), in.size()), 2U);
+    EXPECT_FALSE(in[0]);
+    EXPECT_FALSE(in[1]);
+    EXPECT_TRUE(in[2]);
+    EXPECT_EQ(buffer.TimedPushFrontN(10, in.begin() + 2, 1), 0U);
+
+    std::vector<std::unique_ptr<int>> out;
+    EXPECT_EQ(buffer.PopBackN(std::back_inserter(out), 10), 4U);
+    ASSERT_EQ(out.size(), 4U);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(*out[i], i + 3);
+    }
+
+    EXPECT_TRUE(buffer.Empty());
+    EXPECT_EQ(buffer.TimedPopBackN(10, std::back_inserter(out), 10), 0U);
+}
+
+template <core_lib::threads::eBufferAccess Access> void BoundedBufferPipeline(int numItems)
+{
+    core_lib::threads::BoundedBuffer<int, Access> buffer(64);
+    int64_t                                       total{0};
+    int                                           count{0};
+
+    std::thread consumer([&]() {
+        std::vector<int> batch(16);
+        int              next{0};
+
+        while (count < numItems)
+        {
+            int item;
+
+            if ((count % 2) == 0)
+            {
+                buffer.PopBack(item);
+                EXPECT_EQ(item, next++);
+                total += item;
+                ++count;
+            }
+            else
+            {
+                auto popped = buffer.PopBackN(batch.begin(), batch.size());
+
+                for (size_t i = 0; i < popped; ++i)
+                {
+                    EXPECT_EQ(batch[i], next++);
+                    total += batch[i];
+                }
+
+                count += static_cast<int>(popped);
+            }
+        }
+    });
+
+    std::vector<int> batch(8);
+    int              value{0};
+
+    while (value < numItems)
+    {
+        if ((value % 3) == 0)
+        {
+            buffer.PushFront(value++);
+        }
+        else
+        {
+            const auto n = std::min(static_cast<int>(batch.size()), numItems - value);
+
+            for (int i = 0; i < n; ++i)
+            {
+                batch[i] = value + i;
+            }
+
+            int pushed{0};
+
+            while (pushed < n)
+            {
+                pushed += static_cast<int>(
+                    buffer.PushFrontN(batch.begin() + pushed, static_cast<size_t>(n - pushed)));
+            }
+
+            value += n;
+        }
+    }
+
+    consumer.join();
+    EXPECT_EQ(count, numItems);
+    EXPECT_EQ(total, static_cast<int64_t>(numItems) * (numItems - 1) / 2);
+    EXPECT_TRUE(buffer.Empty());
+}
+
+TEST(QueueTest, testCase_BoundedBuffer2)
+{
+    core_lib::threads::BoundedBuffer<int, core_lib::threads::eBufferAccess::singleProducerConsumer>
+        buffer(3);
+    EXPECT_EQ(buffer.Capacity(), 4U);
+
+    int item{0};
+    EXPECT_FALSE(buffer.TryPopBack(item));
+    EXPECT_FALSE(buffer.TimedPopBack(10, item));
+
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(buffer.TryPushFront(i));
+    }
+
+    EXPECT_FALSE(buffer.TryPushFront(4));
+    EXPECT_FALSE(buffer.TimedPushFront(10, 4));
+    EXPECT_EQ(buffer.Size(), 4U);
+
+    std::vector<int> out;
+    EXPECT_EQ(buffer.TimedPopBackN(10, std::back_inserter(out), 3), 3U);
+    EXPECT_EQ(out, std::vector<int>({0, 1, 2}));
+    buffer.PopBack(item);
+    EXPECT_EQ(item, 3);
+    EXPECT_TRUE(buffer.Empty());
+
+    BoundedBufferPipeline<core_lib::threads::eBufferAccess::multiProducerConsumer>(100000);
+    BoundedBufferPipeline<core_lib::threads::eBufferAccess::singleProducerConsumer>(100000);
+}
+
+TEST(QueueStressTest, testCase_RingQueue2)
+{
+    RingQueueStress<core_lib::threads::MpmcRingQueue<int>>(4, 4);
+    RingQueueStress<core_lib::threads::SpscRingQueue<int>>(1, 1);
+}
+
 // ****************************************************************************
 // MessageQueuetThread tests
 // ****************************************************************************
@@ -1280,6 +1675,66 @@ TEST_F(ThreadsTest, testCase_MessageQueueThread1)
     EXPECT_TRUE(mqtt.CountMessageId(MessageQueueThreadTest::M3) == 11);
 }
 
+TEST_F(ThreadsTest, testCase_MessageQueueThread2)
+{
+    // Flat table covers M1 and M2, M3 and UNKNOWN fall back to the map.
+    MessageQueueThreadTest mqtt(core_lib::threads::eQueueProcessingMode::batchDrain, true);
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        mqtt.PushMessageId(MessageQueueThreadTest::M1);
+        mqtt.PushMessageId(MessageQueueThreadTest::M2);
+        mqtt.PushMessageId(MessageQueueThreadTest::UNKNOWN);
+        mqtt.PushMessageId(MessageQueueThreadTest::M3);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+
+    EXPECT_TRUE(mqtt.CountMessageId(MessageQueueThreadTest::M1) == 1000);
+    EXPECT_TRUE(mqtt.CountMessageId(MessageQueueThreadTest::M2) == 1000);
+    EXPECT_TRUE(mqtt.CountMessageId(MessageQueueThreadTest::M3) == 1000);
+    EXPECT_TRUE(mqtt.CountMessageId(MessageQueueThreadTest::UNKNOWN) == 0);
+}
+
+TEST_F(ThreadsTest, testCase_MessageQueueThread3)
+{
+    for (auto processingMode : {core_lib::threads::eQueueProcessingMode::singleMessage,
+                                core_lib::threads::eQueueProcessingMode::batchDrain})
+    {
+        const size_t        numMessages = 1000;
+        std::atomic<size_t> handled{0};
+        std::atomic<size_t> drained{0};
+        std::atomic<size_t> handledWhenDrained{0};
+
+        {
+            core_lib::threads::MessageQueueThread<int, int> mqt(
+                [](const int&) { return 0; },
+                core_lib::threads::eOnDestroyOptions::processRemainingItems,
+                {},
+                processingMode);
+            mqt.RegisterMessageHandler(0, [&handled](int&) {
+                ++handled;
+                return true;
+            });
+            mqt.RegisterQueueDrainedHandler([&]() {
+                ++drained;
+                handledWhenDrained = handled.load();
+            });
+
+            for (size_t i = 0; i < numMessages; ++i)
+            {
+                mqt.Push(static_cast<int>(i));
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+            EXPECT_EQ(handledWhenDrained.load(), numMessages);
+        }
+
+        EXPECT_EQ(handled.load(), numMessages);
+        EXPECT_GE(drained.load(), 1U);
+    }
+}
+
 // ****************************************************************************
 // DeadlineTimer tests
 // ****************************************************************************
@@ -1312,6 +1767,324 @@ TEST(TimerTest, test_DeadlineTimer_3)
     EXPECT_TRUE(helper2.Wait(2000));
 }
 
+TEST(TimerTest, test_DeadlineTimer_4)
+{
+    // Small wheel so the timeouts below span several turns.
+    core_lib::threads::TimerService service(1, 8);
+    DeadlineTimerHelper             helper1;
+    DeadlineTimerHelper             helper2;
+    core_lib::threads::DeadlineTimer timer(service);
+
+    auto start = std::chrono::steady_clock::now();
+    timer.Start(50, std::bind(&DeadlineTimerHelper::OnTimeOut, &helper1));
+    timer.Start(50, std::bind(&DeadlineTimerHelper::OnTimeOut, &helper2));
+    EXPECT_EQ(service.ActiveTimers(), 1U);
+    EXPECT_TRUE(helper2.Wait(2000));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+    EXPECT_FALSE(helper1.Wait(100));
+    EXPECT_EQ(service.ActiveTimers(), 0U);
+
+    // A callback may restart its own timer.
+    std::atomic<int> fired{0};
+    std::function<void()> rearm = [&]() {
+        if (++fired < 3)
+        {
+            timer.Start(5, rearm);
+        }
+    };
+    timer.Start(5, rearm);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_EQ(fired.load(), 3);
+}
+
+TEST(TimerTest, test_DeadlineTimer_6)
+{
+    core_lib::threads::TimerService  service;
+    core_lib::threads::SyncEvent     release;
+    core_lib::threads::SyncEvent     blocked;
+    DeadlineTimerHelper              helper1;
+    core_lib::threads::DeadlineTimer blockingTimer(service);
+    core_lib::threads::DeadlineTimer longTimer(service);
+    core_lib::threads::DeadlineTimer timer(service);
+
+    // A blocking callback does not hold up other timers.
+    blockingTimer.Start(5, [&]() {
+        blocked.Signal();
+        release.WaitForTime(5000);
+    });
+    EXPECT_TRUE(blocked.WaitForTime(2000));
+
+    // A short timeout started while a long one is pending wakes the wheel in time.
+    longTimer.Start(60000, []() {});
+    auto start = std::chrono::steady_clock::now();
+    timer.Start(20, std::bind(&DeadlineTimerHelper::OnTimeOut, &helper1));
+    EXPECT_TRUE(helper1.Wait(1000));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1000));
+    EXPECT_EQ(service.ActiveTimers(), 1U);
+
+    release.Signal();
+    blockingTimer.Cancel();
+    longTimer.Cancel();
+    EXPECT_EQ(service.ActiveTimers(), 0U);
+
+    // Without callback threads callbacks run on the wheel thread.
+    core_lib::threads::TimerService  serialService(1, 4096, 0);
+    DeadlineTimerHelper              helper2;
+    core_lib::threads::DeadlineTimer serialTimer(serialService);
+    serialTimer.Start(10, std::bind(&DeadlineTimerHelper::OnTimeOut, &helper2));
+    EXPECT_TRUE(helper2.Wait(2000));
+}
+
+TEST(TimerStressTest, test_DeadlineTimer_5)
+{
+    const size_t numTimers = 10000;
+
+    // Legacy approach for comparison: one thread per armed timer, joined on cancel.
+    auto legacyStart = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < numTimers; ++i)
+    {
+        core_lib::threads::SyncEvent cancelEvent;
+        std::thread                  t([&cancelEvent]() { cancelEvent.WaitForTime(60000); });
+        cancelEvent.Signal();
+        t.join();
+    }
+
+    auto legacyTime = std::chrono::steady_clock::now() - legacyStart;
+
+    std::vector<std::unique_ptr<core_lib::threads::DeadlineTimer>> timers;
+    std::atomic<size_t>                                            fired{0};
+    core_lib::threads::SyncEvent                                   allFired;
+    auto                                                           onTimedOut = [&]() {
+        if (++fired == numTimers)
+        {
+            allFired.Signal();
+        }
+    };
+
+    for (size_t i = 0; i < numTimers; ++i)
+    {
+        timers.emplace_back(std::make_unique<core_lib::threads::DeadlineTimer>());
+    }
+
+    // Start, restart and cancel all 10k timers while they are all active.
+    auto wheelStart = std::chrono::steady_clock::now();
+
+    for (auto& timer : timers)
+    {
+        timer->Start(60000, onTimedOut);
+    }
+
+    for (auto& timer : timers)
+    {
+        timer->Start(60000, onTimedOut);
+    }
+
+    EXPECT_EQ(core_lib::threads::TimerService::Default().ActiveTimers(), numTimers);
+
+    for (auto& timer : timers)
+    {
+        timer->Cancel();
+    }
+
+    auto wheelTime = std::chrono::steady_clock::now() - wheelStart;
+
+    GOUT("thread per timer start/cancel x " << numTimers << ": "
+         << std::chrono::duration_cast<std::chrono::microseconds>(legacyTime).count()
+         << " us, timer wheel start/restart/cancel x " << numTimers << ": "
+         << std::chrono::duration_cast<std::chrono::microseconds>(wheelTime).count() << " us");
+
+    EXPECT_EQ(core_lib::threads::TimerService::Default().ActiveTimers(), 0U);
+    EXPECT_EQ(fired.load(), 0U);
+
+    for (size_t i = 0; i < numTimers; ++i)
+    {
+        timers[i]->Start(10 + static_cast<uint32_t>(i % 100), onTimedOut);
+    }
+
+    EXPECT_TRUE(allFired.WaitForTime(5000));
+    EXPECT_EQ(fired.load(), numTimers);
+}
+
+TEST_F(ThreadsTest, testCase_ThreadStopToken)
+{
+    std::atomic<uint64_t> iterations{0};
+    std::atomic<bool>     callbackFired{false};
+    std::unique_ptr<std::stop_callback<std::function<void()>>> stopCallback;
+
+    core_lib::threads::ThreadRunner* runnerPtr = nullptr;
+    core_lib::threads::ThreadRunner  runner(
+        [&]() {
+            // Spin without returning to the run loop, relying on the token alone.
+            auto token = runnerPtr->StopToken();
+
+            while (!token.stop_requested())
+            {
+                ++iterations;
+            }
+        },
+        []() {},
+        false);
+    runnerPtr = &runner;
+
+    EXPECT_TRUE(runner.Start());
+    stopCallback = std::make_unique<std::stop_callback<std::function<void()>>>(
+        runner.StopToken(), std::function<void()>([&]() { callbackFired = true; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_TRUE(runner.Stop());
+    EXPECT_FALSE(runner.IsStarted());
+    EXPECT_GT(iterations.load(), 0U);
+    EXPECT_TRUE(callbackFired.load());
+
+    // A restarted thread gets a fresh token.
+    stopCallback.reset();
+    EXPECT_TRUE(runner.StopToken().stop_requested());
+    EXPECT_TRUE(runner.Start());
+    EXPECT_FALSE(runner.StopToken().stop_requested());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_TRUE(runner.Stop());
+}
+
+// ****************************************************************************
+// ThreadPool tests
+// ****************************************************************************
+TEST(ThreadPoolTest, testCase_ThreadPool1)
+{
+    core_lib::threads::ThreadPool pool(4);
+    EXPECT_EQ(pool.Size(), 4U);
+    EXPECT_FALSE(pool.IsThisThreadIn());
+
+    std::vector<core_lib::threads::TaskFuture<uint64_t>> futures;
+
+    for (uint64_t i = 1; i <= 1000; ++i)
+    {
+        futures.emplace_back(pool.Submit([](uint64_t n) { return n * 2; }, i));
+    }
+
+    uint64_t total = 0;
+
+    for (auto& f : futures)
+    {
+        total += f.Get();
+    }
+
+    EXPECT_EQ(total, static_cast<uint64_t>(1001000));
+
+    auto inPool = pool.Submit([&pool]() { return pool.IsThisThreadIn(); });
+    EXPECT_TRUE(inPool.Get());
+
+    auto chained = pool.Submit([]() { return 20; })
+                       .Then([](std::shared_future<int> f) { return f.get() + 1; })
+                       .Then([](std::shared_future<int> f) { return std::to_string(f.get() * 2); });
+    EXPECT_EQ(chained.Get(), "42");
+
+    auto failed = pool.Submit([]() -> int { throw std::runtime_error("task failed"); })
+                      .Then([](std::shared_future<int> f) {
+                          try
+                          {
+                              f.get();
+                          }
+                          catch (std::runtime_error const&)
+                          {
+                              return true;
+                          }
+
+                          return false;
+                      });
+    EXPECT_TRUE(failed.Get());
+
+    core_lib::threads::TaskFuture<int> invalid;
+    EXPECT_FALSE(invalid.Valid());
+    EXPECT_THROW(invalid.Then([](std::shared_future<int> f) { return f.get(); }), std::logic_error);
+}
+
+TEST(ThreadPoolTest, testCase_ThreadPool2)
+{
+    core_lib::threads::ThreadPool pool(2);
+    std::atomic<int>              done{0};
+
+    // Tasks submitted from a worker go onto its own queue, so while it blocks
+    // here they can only complete if the other worker steals them.
+    auto blocker = pool.Submit([&]() {
+        for (int i = 0; i < 10; ++i)
+        {
+            pool.Post([&done]() { ++done; });
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+        while ((done.load() < 10) && (std::chrono::steady_clock::now() < deadline))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return done.load();
+    });
+
+    EXPECT_EQ(blocker.Get(), 10);
+    EXPECT_EQ(pool.PendingTasks(), 0U);
+}
+
+// ****************************************************************************
+// EventThread tests
+// ****************************************************************************
+TEST(EventThreadTest, testCase_EventThreadFixedRate)
+{
+    using namespace core_lib::threads;
+    auto busyTick = []() { std::this_thread::sleep_for(std::chrono::milliseconds(5)); };
+
+    EventThread fixedDelay(busyTick, 10, true);
+    fixedDelay.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    fixedDelay.Stop();
+
+    EventThread fixedRate(busyTick, 10, true);
+    fixedRate.SetScheduling(eEventScheduling::fixedRate, eOverrunPolicy::skip, 200);
+    fixedRate.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    fixedRate.Stop();
+
+    auto delayStats = fixedDelay.Statistics();
+    auto rateStats  = fixedRate.Statistics();
+
+    // Fixed delay ticks every ~15ms, fixed rate every 10ms. Allow for the odd
+    // overrun caused by a loaded machine oversleeping in the callback.
+    EXPECT_GT(rateStats.ticks, delayStats.ticks);
+    EXPECT_GE(rateStats.ticks + rateStats.skippedTicks, 45U);
+    EXPECT_LE(rateStats.ticks + rateStats.skippedTicks, 52U);
+    EXPECT_LE(rateStats.meanJitter, rateStats.maxJitter);
+
+    fixedRate.ResetStatistics();
+    EXPECT_EQ(fixedRate.Statistics().ticks, 0U);
+}
+
+TEST(EventThreadTest, testCase_EventThreadOverrun)
+{
+    using namespace core_lib::threads;
+    auto slowTick = []() { std::this_thread::sleep_for(std::chrono::milliseconds(25)); };
+
+    EventThread skipping(slowTick, 10, true);
+    skipping.SetScheduling(eEventScheduling::fixedRate, eOverrunPolicy::skip);
+    skipping.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    skipping.Stop();
+
+    auto stats = skipping.Statistics();
+    EXPECT_GT(stats.overruns, 0U);
+    EXPECT_GT(stats.skippedTicks, 0U);
+
+    EventThread catchingUp(slowTick, 10, true);
+    catchingUp.SetScheduling(eEventScheduling::fixedRate, eOverrunPolicy::catchUp);
+    catchingUp.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    catchingUp.Stop();
+
+    stats = catchingUp.Statistics();
+    EXPECT_GT(stats.overruns, 0U);
+    EXPECT_EQ(stats.skippedTicks, 0U);
+    EXPECT_GT(stats.maxJitter, std::chrono::milliseconds(10));
+}
+
 // ****************************************************************************
 // Asio tests
 // ****************************************************************************
@@ -1361,4 +2134,108 @@ TEST(AsioTest, testCase_IoThreadGroup2)
     EXPECT_TRUE(sum2.NumThreadsUsed() == 8);
 }
 
+TEST(AsioTest, testCase_IoThreadGroupTimers1)
+{
+    core_lib::asio::IoContextThreadGroup  ioThreadGroup(2);
+    core_lib::threads::SyncEvent          afterEvent;
+    core_lib::threads::SyncEvent          atEvent;
+    std::atomic<bool>                     cancelledRan{false};
+    const auto                            start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point afterTime;
+
+    auto after = ioThreadGroup.PostAfter(std::chrono::milliseconds(50), [&]() {
+        afterTime = std::chrono::steady_clock::now();
+        afterEvent.Signal();
+    });
+    auto at =
+        ioThreadGroup.PostAt(start + std::chrono::milliseconds(20), [&]() { atEvent.Signal(); });
+    auto cancelled = ioThreadGroup.PostAfter(std::chrono::milliseconds(30),
+                                             [&]() { cancelledRan = true; });
+
+    EXPECT_TRUE(after.IsPending());
+    EXPECT_TRUE(at.IsPending());
+    EXPECT_TRUE(cancelled.IsPending());
+    cancelled.Cancel();
+    EXPECT_FALSE(cancelled.IsPending());
+
+    EXPECT_TRUE(atEvent.WaitForTime(1000));
+    EXPECT_TRUE(afterEvent.WaitForTime(1000));
+    EXPECT_GE(afterTime - start, std::chrono::milliseconds(50));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(cancelledRan);
+    EXPECT_FALSE(after.IsPending());
+    EXPECT_FALSE(at.IsPending());
+    EXPECT_EQ(ioThreadGroup.PendingTimers(), 0U);
+
+    // Handles outliving their timers, or default constructed, do nothing.
+    after.Cancel();
+    core_lib::asio::TimerHandle empty;
+    EXPECT_FALSE(empty.IsPending());
+    empty.Cancel();
+
+    EXPECT_THROW(ioThreadGroup.PostAfter(std::chrono::milliseconds(1), std::function<void()>()),
+                 std::invalid_argument);
+}
+
+TEST(AsioTest, testCase_IoThreadGroupTimers2)
+{
+    core_lib::asio::TimerHandle outlived;
+
+    {
+        core_lib::asio::IoContextThreadGroup ioThreadGroup(4);
+        auto strand = core_lib::asio_compat::make_strand(ioThreadGroup.IoService());
+        std::atomic<int>  ticks{0};
+        std::atomic<int>  strandTicks{0};
+        std::atomic<int>  inStrand{0};
+        std::atomic<bool> overlapped{false};
+
+        auto periodic = ioThreadGroup.PostEvery(std::chrono::milliseconds(5), [&]() { ++ticks; });
+
+        // Two periodic functions sharing a strand must never run at the same time.
+        auto strandFunction = [&]() {
+            if (++inStrand > 1)
+            {
+                overlapped = true;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            --inStrand;
+            ++strandTicks;
+        };
+        auto strand1 =
+            ioThreadGroup.PostEvery(strand, std::chrono::milliseconds(2), strandFunction);
+        auto strand2 =
+            ioThreadGroup.PostEvery(strand, std::chrono::milliseconds(2), strandFunction);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        EXPECT_EQ(ioThreadGroup.PendingTimers(), 3U);
+
+        periodic.Cancel();
+        strand1.Cancel();
+        strand2.Cancel();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        const int ticksAtCancel = ticks;
+        EXPECT_GT(ticksAtCancel, 10);
+        EXPECT_LE(ticksAtCancel, 41);
+        EXPECT_GT(strandTicks.load(), 10);
+        EXPECT_FALSE(overlapped);
+        EXPECT_EQ(ioThreadGroup.PendingTimers(), 0U);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        EXPECT_EQ(ticks.load(), ticksAtCancel);
+
+        EXPECT_THROW(ioThreadGroup.PostEvery(std::chrono::milliseconds(0), []() {}),
+                     std::invalid_argument);
+
+        // Leave a timer pending when the group is destroyed.
+        outlived = ioThreadGroup.PostAfter(std::chrono::seconds(60), []() {});
+        EXPECT_TRUE(outlived.IsPending());
+    }
+
+    EXPECT_FALSE(outlived.IsPending());
+    outlived.Cancel();
+}
+
 #endif // DISABLE_THREADS_TESTS